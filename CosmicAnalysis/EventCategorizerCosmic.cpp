@@ -42,7 +42,8 @@ bool EventCategorizerCosmic::init()
   } else {
     WARNING("No TOT calculation option given by the user. Using standard sum.");
   }
-  
+  fTOTType = HitFinderTools::getTOTCalculationType(fTOTCalculationType);
+
   if(fSaveControlHistos) initialiseHistograms();
   return true;
 }
@@ -54,8 +55,7 @@ bool EventCategorizerCosmic::exec()
     uint n = timeWindow->getNumberOfEvents();
     for (uint i = 0; i < n; ++i) {
       const auto& event = dynamic_cast<const JPetEvent&>(timeWindow->operator[](i));
-      vector<JPetHit> hits = event.getHits();
-      JPetEvent cosmicEvent = cosmicAnalysis(hits);
+      JPetEvent cosmicEvent = cosmicAnalysis(event.getHits());
       if (cosmicEvent.getHits().size()) { events.push_back( cosmicEvent ); }
     }
   } else {
@@ -79,11 +79,11 @@ void EventCategorizerCosmic::saveEvents(const vector<JPetEvent>& events)
   }
 }
 
-JPetEvent EventCategorizerCosmic::cosmicAnalysis(vector<JPetHit> hits)
+JPetEvent EventCategorizerCosmic::cosmicAnalysis(const vector<JPetHit>& hits)
 {
   JPetEvent cosmicEvent;
   for (unsigned i = 0; i < hits.size(); i++) {
-    double TOTofHit = HitFinderTools::calculateTOT(hits[i], HitFinderTools::getTOTCalculationType(fTOTCalculationType));
+    double TOTofHit = HitFinderTools::calculateTOT(hits[i], fTOTType);
     if (TOTofHit >= fMinCosmicTOT) {
       cosmicEvent.addHit(hits[i]);
       //Uncomment if kCosmic type will be avalible
@@ -16,6 +16,7 @@
 #ifndef EVENTCATEGORIZERCOSMIC_H
 #define EVENTCATEGORIZERCOSMIC_H
 
+#include "../LargeBarrelAnalysis/HitFinderTools.h"
 #include <JPetStatistics/JPetStatistics.h>
 #include <JPetEventType/JPetEventType.h>
 #include <JPetUserTask/JPetUserTask.h>
@@ -37,7 +38,7 @@ public:
 	virtual bool init() override;
 	virtual bool exec() override;
 	virtual bool terminate() override;
-	JPetEvent cosmicAnalysis(std::vector<JPetHit> hits);
+	JPetEvent cosmicAnalysis(const std::vector<JPetHit>& hits);
 
 protected:
 	const std::string kMinCosmicTOTParamKey = "EventCategorizer_MinCosmicTOT_float";
@@ -46,6 +47,7 @@ protected:
 	double fMinCosmicTOT = 55000.0;
 	bool fSaveControlHistos = true;
     std::string fTOTCalculationType = "";
+	HitFinderTools::TOTCalculationType fTOTType = HitFinderTools::kSimplified;
     void initialiseHistograms();
 };
 
@@ -0,0 +1,33 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *  @file ConvertGojaToBinary.cpp
+ */
+
+#include "LORFileTools.h"
+#include <iostream>
+#include <string>
+#include <thread>
+
+/**
+ * Converter of GOJA output files to the binary LOR format read by SinogramCreator
+ */
+int main(int argc, const char* argv[])
+{
+  if (argc != 3 && argc != 4)
+  {
+    std::cerr << "Usage: " << argv[0] << " <input GOJA file> <output binary file> [number of threads]" << std::endl;
+    return 1;
+  }
+  int numberOfThreads = argc == 4 ? std::stoi(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+  return LORFileTools::convertGojaToBinary(argv[1], argv[2], numberOfThreads) ? 0 : 1;
+}
@@ -14,6 +14,7 @@
  */
 
 #include "FilterEvents.h"
+#include "../LargeBarrelAnalysis/SlimSignalTools.h"
 #include <TH3D.h>
 #include <TH1I.h>
 #include "./JPetOptionsTools/JPetOptionsTools.h"
@@ -138,16 +139,9 @@ double FilterEvents::calculateSumOfTOTsOfHit(const JPetHit& hit)
 double FilterEvents::calculateSumOfTOTs(const JPetPhysSignal& signal)
 {
   double tot = 0.;
-  std::map<int, double> leadingPoints, trailingPoints;
-  leadingPoints = signal.getRecoSignal().getRawSignal().getTimesVsThresholdNumber(JPetSigCh::Leading);
-  trailingPoints = signal.getRecoSignal().getRawSignal().getTimesVsThresholdNumber(JPetSigCh::Trailing);
-  for (int i = 1; i < 5; i++) {
-    auto leadSearch = leadingPoints.find(i);
-    auto trailSearch = trailingPoints.find(i);
-
-    if (leadSearch != leadingPoints.end() && trailSearch != trailingPoints.end())
-      tot += (trailSearch->second - leadSearch->second);
-  }
+  // TOTs are read from Signal Channels or from threshold crossings of slim signals saved by HitFinder
+  for (const auto& thrToTOT : SlimSignalTools::getTOTsVsThresholdValue(signal))
+    tot += thrToTOT.second;
   return tot / 1000.;
 }
 
@@ -0,0 +1,399 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *  @file LORFileTools.cpp
+ */
+
+#include "LORFileTools.h"
+#include "JPetLoggerInclude.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+const char kBinaryLORMagic[8] = {'J', 'P', 'E', 'T', 'L', 'O', 'R', '\0'};
+const std::size_t kNumberOfLORValues = 8;
+const std::size_t kBinaryLORRecordSize = kNumberOfLORValues * sizeof(float);
+const std::size_t kBinaryLORsInBlock = 1 << 16;
+
+static_assert(sizeof(BinaryLORHeader) == 16, "Binary LOR header has to be 16 bytes long");
+static_assert(sizeof(float) == 4, "Binary LOR format requires 32 bit floats");
+
+/**
+ * Read only memory mapping of the whole file, unmapped when going out of scope
+ */
+class MappedFile
+{
+public:
+  explicit MappedFile(const std::string& fileName)
+  {
+    int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+      return;
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) == 0 && fileStatus.st_size > 0)
+    {
+      void* data = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+      if (data != MAP_FAILED)
+      {
+        madvise(data, fileStatus.st_size, MADV_SEQUENTIAL);
+        fData = static_cast<const char*>(data);
+        fSize = fileStatus.st_size;
+      }
+    }
+    close(fileDescriptor);
+  }
+  ~MappedFile()
+  {
+    if (fData)
+      munmap(const_cast<char*>(fData), fSize);
+  }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool isValid() const { return fData != nullptr; }
+  const char* begin() const { return fData; }
+  const char* end() const { return fData + fSize; }
+  std::size_t size() const { return fSize; }
+
+private:
+  const char* fData = nullptr;
+  std::size_t fSize = 0;
+};
+
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+double powerOf10(int exponent)
+{
+  static const double kExactPowers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  if (exponent >= 0 && exponent <= 22)
+    return kExactPowers[exponent];
+  return std::pow(10., exponent);
+}
+
+/**
+ * Values in binary LOR files are little endian regardless of the byte order of the machine,
+ * bytes are composed with shifts, which compilers reduce to plain loads and stores on little endian hosts.
+ */
+inline void writeLittleEndian(uint32_t value, char* bytes)
+{
+  for (int i = 0; i < 4; i++)
+    bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+inline uint32_t readLittleEndian(const char* bytes)
+{
+  uint32_t value = 0;
+  for (int i = 0; i < 4; i++)
+    value |= static_cast<uint32_t>(static_cast<unsigned char>(bytes[i])) << (8 * i);
+  return value;
+}
+
+inline void writeLittleEndianFloat(float value, char* bytes)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  writeLittleEndian(bits, bytes);
+}
+
+inline float readLittleEndianFloat(const char* bytes)
+{
+  const uint32_t bits = readLittleEndian(bytes);
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+inline uint32_t swapBytes(uint32_t value)
+{
+  return (value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24);
+}
+} // namespace
+
+const uint32_t LORFileTools::kBinaryLORVersion;
+const std::size_t LORFileTools::kChunkSize;
+
+/**
+ * Parses decimal number in fixed or scientific notation, skipping spaces and tabs before it.
+ * Returns pointer to the first character after the number, or nullptr if there is no number
+ * before the end of the line. Up to 19 significant digits are kept in an integer mantissa,
+ * which is scaled once by the power of 10.
+ */
+const char* LORFileTools::parseNumber(const char* begin, const char* end, double& value)
+{
+  const char* cursor = begin;
+  while (cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r'))
+    cursor++;
+  if (cursor == end)
+    return nullptr;
+
+  bool negative = false;
+  if (*cursor == '-' || *cursor == '+')
+  {
+    negative = (*cursor == '-');
+    cursor++;
+  }
+  uint64_t mantissa = 0;
+  int exponent = 0;
+  int significantDigits = 0;
+  bool anyDigit = false;
+  for (; cursor < end && isDigit(*cursor); cursor++)
+  {
+    anyDigit = true;
+    if (significantDigits < 19)
+    {
+      mantissa = mantissa * 10 + (*cursor - '0');
+      if (mantissa != 0)
+        significantDigits++;
+    }
+    else
+      exponent++;
+  }
+  if (cursor < end && *cursor == '.')
+  {
+    cursor++;
+    for (; cursor < end && isDigit(*cursor); cursor++)
+    {
+      anyDigit = true;
+      if (significantDigits < 19)
+      {
+        mantissa = mantissa * 10 + (*cursor - '0');
+        exponent--;
+        if (mantissa != 0)
+          significantDigits++;
+      }
+    }
+  }
+  if (!anyDigit)
+    return nullptr;
+  if (cursor < end && (*cursor == 'e' || *cursor == 'E'))
+  {
+    const char* exponentBegin = cursor++;
+    bool negativeExponent = false;
+    if (cursor < end && (*cursor == '-' || *cursor == '+'))
+    {
+      negativeExponent = (*cursor == '-');
+      cursor++;
+    }
+    if (cursor < end && isDigit(*cursor))
+    {
+      int explicitExponent = 0;
+      for (; cursor < end && isDigit(*cursor); cursor++)
+        explicitExponent = std::min(explicitExponent * 10 + (*cursor - '0'), 10000);
+      exponent += negativeExponent ? -explicitExponent : explicitExponent;
+    }
+    else
+      cursor = exponentBegin;
+  }
+  double result = static_cast<double>(mantissa);
+  if (exponent < 0)
+    result /= powerOf10(-exponent);
+  else if (exponent > 0)
+    result *= powerOf10(exponent);
+  value = negative ? -result : result;
+  return cursor;
+}
+
+/**
+ * Parses all lines from given part of GOJA file. Line has to start with positions (in cm) and times (in ps)
+ * of both hits, lines with less than 8 numbers are skipped.
+ */
+void LORFileTools::parseGojaChunk(const char* begin, const char* end, std::vector<SinogramLOR>& lors)
+{
+  double values[kNumberOfLORValues];
+  const char* cursor = begin;
+  while (cursor < end)
+  {
+    const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+    if (!lineEnd)
+      lineEnd = end;
+    std::size_t parsed = 0;
+    for (; parsed < kNumberOfLORValues; parsed++)
+    {
+      cursor = parseNumber(cursor, lineEnd, values[parsed]);
+      if (!cursor)
+        break;
+    }
+    if (parsed == kNumberOfLORValues)
+    {
+      lors.push_back(SinogramLOR{static_cast<float>(values[0]), static_cast<float>(values[1]), static_cast<float>(values[2]), values[3],
+                                 static_cast<float>(values[4]), static_cast<float>(values[5]), static_cast<float>(values[6]), values[7]});
+    }
+    cursor = lineEnd + 1;
+  }
+}
+
+bool LORFileTools::readGojaFile(const std::string& fileName, int numberOfThreads, const LORCallback& callback)
+{
+  MappedFile file(fileName);
+  if (!file.isValid())
+  {
+    ERROR("Could not open GOJA file: " + fileName);
+    return false;
+  }
+  std::vector<std::pair<const char*, const char*>> chunks;
+  for (const char* chunkBegin = file.begin(); chunkBegin < file.end();)
+  {
+    const char* chunkEnd = chunkBegin + std::min(kChunkSize, static_cast<std::size_t>(file.end() - chunkBegin));
+    const char* lineEnd = static_cast<const char*>(std::memchr(chunkEnd - 1, '\n', file.end() - chunkEnd + 1));
+    chunkEnd = lineEnd ? lineEnd + 1 : file.end();
+    chunks.emplace_back(chunkBegin, chunkEnd);
+    chunkBegin = chunkEnd;
+  }
+
+  const std::size_t threads = std::max(numberOfThreads, 1);
+  std::vector<std::vector<SinogramLOR>> parsedChunks(threads);
+  for (std::size_t first = 0; first < chunks.size(); first += threads)
+  {
+    const std::size_t count = std::min(threads, chunks.size() - first);
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < count; t++)
+    {
+      parsedChunks[t].clear();
+      const auto& chunk = chunks[first + t];
+      if (count == 1)
+        parseGojaChunk(chunk.first, chunk.second, parsedChunks[t]);
+      else
+        workers.emplace_back(parseGojaChunk, chunk.first, chunk.second, std::ref(parsedChunks[t]));
+    }
+    for (auto& worker : workers)
+      worker.join();
+    for (std::size_t t = 0; t < count; t++)
+      callback(parsedChunks[t]);
+  }
+  return true;
+}
+
+void LORFileTools::writeBinaryLORHeader(const BinaryLORHeader& header, char* bytes)
+{
+  std::memcpy(bytes, header.magic, sizeof(header.magic));
+  writeLittleEndian(header.version, bytes + sizeof(header.magic));
+  writeLittleEndian(header.recordSize, bytes + sizeof(header.magic) + sizeof(uint32_t));
+}
+
+BinaryLORHeader LORFileTools::readBinaryLORHeader(const char* bytes)
+{
+  BinaryLORHeader header;
+  std::memcpy(header.magic, bytes, sizeof(header.magic));
+  header.version = readLittleEndian(bytes + sizeof(header.magic));
+  header.recordSize = readLittleEndian(bytes + sizeof(header.magic) + sizeof(uint32_t));
+  return header;
+}
+
+bool LORFileTools::isBinaryLORFile(const std::string& fileName)
+{
+  char magic[sizeof(kBinaryLORMagic)];
+  std::ifstream inputFile(fileName, std::ios::binary);
+  if (!inputFile.read(magic, sizeof(magic)))
+    return false;
+  return std::memcmp(magic, kBinaryLORMagic, sizeof(magic)) == 0;
+}
+
+bool LORFileTools::readBinaryLORFile(const std::string& fileName, const LORCallback& callback)
+{
+  MappedFile file(fileName);
+  if (!file.isValid() || file.size() < sizeof(BinaryLORHeader))
+  {
+    ERROR("Could not open binary LOR file: " + fileName);
+    return false;
+  }
+  BinaryLORHeader header = readBinaryLORHeader(file.begin());
+  if (std::memcmp(header.magic, kBinaryLORMagic, sizeof(kBinaryLORMagic)) == 0 && header.version == swapBytes(kBinaryLORVersion) &&
+      header.recordSize == swapBytes(kBinaryLORRecordSize))
+  {
+    ERROR("Binary LOR file " + fileName + " was written in big endian byte order, only little endian files can be read.");
+    return false;
+  }
+  if (std::memcmp(header.magic, kBinaryLORMagic, sizeof(kBinaryLORMagic)) != 0 || header.version != kBinaryLORVersion ||
+      header.recordSize != kBinaryLORRecordSize)
+  {
+    ERROR("File " + fileName + " is not a binary LOR file in version " + std::to_string(kBinaryLORVersion));
+    return false;
+  }
+  const std::size_t numberOfLORs = (file.size() - sizeof(header)) / kBinaryLORRecordSize;
+  if ((file.size() - sizeof(header)) % kBinaryLORRecordSize != 0)
+    WARNING("Binary LOR file " + fileName + " ends with incomplete record, it is skipped.");
+
+  const char* records = file.begin() + sizeof(header);
+  std::vector<SinogramLOR> lors;
+  lors.reserve(std::min(numberOfLORs, kBinaryLORsInBlock));
+  float values[kNumberOfLORValues];
+  for (std::size_t i = 0; i < numberOfLORs; i++)
+  {
+    const char* record = records + i * kBinaryLORRecordSize;
+    for (std::size_t v = 0; v < kNumberOfLORValues; v++)
+      values[v] = readLittleEndianFloat(record + v * sizeof(float));
+    lors.push_back(SinogramLOR{values[0], values[1], values[2], values[3], values[4], values[5], values[6], values[7]});
+    if (lors.size() == kBinaryLORsInBlock)
+    {
+      callback(lors);
+      lors.clear();
+    }
+  }
+  if (!lors.empty())
+    callback(lors);
+  return true;
+}
+
+bool LORFileTools::readLORFile(const std::string& fileName, int numberOfThreads, const LORCallback& callback)
+{
+  if (isBinaryLORFile(fileName))
+    return readBinaryLORFile(fileName, callback);
+  return readGojaFile(fileName, numberOfThreads, callback);
+}
+
+bool LORFileTools::convertGojaToBinary(const std::string& gojaFileName, const std::string& binaryFileName, int numberOfThreads)
+{
+  std::ofstream output(binaryFileName, std::ios::binary | std::ios::trunc);
+  if (!output)
+  {
+    ERROR("Could not create binary LOR file: " + binaryFileName);
+    return false;
+  }
+  BinaryLORHeader header;
+  std::memcpy(header.magic, kBinaryLORMagic, sizeof(kBinaryLORMagic));
+  header.version = kBinaryLORVersion;
+  header.recordSize = kBinaryLORRecordSize;
+  char headerBytes[sizeof(BinaryLORHeader)];
+  writeBinaryLORHeader(header, headerBytes);
+  output.write(headerBytes, sizeof(headerBytes));
+
+  std::vector<char> records;
+  bool isRead = readGojaFile(gojaFileName, numberOfThreads, [&output, &records](const std::vector<SinogramLOR>& lors) {
+    records.resize(lors.size() * kBinaryLORRecordSize);
+    char* record = records.data();
+    for (const auto& lor : lors)
+    {
+      const float values[kNumberOfLORValues] = {lor.firstX,  lor.firstY,  lor.firstZ,  0.f,
+                                                lor.secondX, lor.secondY, lor.secondZ, static_cast<float>(lor.secondTOF - lor.firstTOF)};
+      for (std::size_t v = 0; v < kNumberOfLORValues; v++)
+        writeLittleEndianFloat(values[v], record + v * sizeof(float));
+      record += kBinaryLORRecordSize;
+    }
+    output.write(records.data(), records.size());
+  });
+  output.close();
+  if (!output)
+  {
+    ERROR("Could not write binary LOR file: " + binaryFileName);
+    return false;
+  }
+  return isRead;
+}
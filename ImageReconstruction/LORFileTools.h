@@ -0,0 +1,78 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *  @file LORFileTools.h
+ */
+
+#ifndef LORFILETOOLS_H
+#define LORFILETOOLS_H
+
+#include "SinogramCreatorTools.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Binary file with LORs: 16 bytes of header and 32 bytes per LOR
+ *
+ * Header contains magic "JPETLOR", version and size of one record. Each record
+ * holds x1, y1, z1, t1, x2, y2, z2, t2 as float32, positions in cm, times in ps.
+ * All numbers (also in the header) are little endian on every machine, files written
+ * in big endian order are rejected. Times are stored relative to the time of the first hit (t1 is always 0),
+ * since float32 can not keep absolute GOJA times with picosecond precision, and only
+ * the difference of times is used in sinogram creation.
+ */
+struct BinaryLORHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t recordSize;
+};
+
+/**
+ * @brief Tools reading LORs from GOJA output and binary LOR files
+ *
+ * GOJA files are memory mapped and split into chunks ending on line boundaries,
+ * chunks are parsed in parallel with a hand written number parser. LORs are passed
+ * to the callback chunk by chunk in the order of the file, so the result does not
+ * depend on the number of threads. Only first 8 columns of GOJA line (positions and
+ * times of both hits) are read, rest of the line is skipped.
+ */
+class LORFileTools
+{
+public:
+  using LORCallback = std::function<void(const std::vector<SinogramLOR>&)>;
+
+  static const uint32_t kBinaryLORVersion = 1;
+  static const std::size_t kChunkSize = 16 << 20;
+
+  static bool readGojaFile(const std::string& fileName, int numberOfThreads, const LORCallback& callback);
+  static bool readBinaryLORFile(const std::string& fileName, const LORCallback& callback);
+  static bool readLORFile(const std::string& fileName, int numberOfThreads, const LORCallback& callback);
+  static bool isBinaryLORFile(const std::string& fileName);
+  static bool convertGojaToBinary(const std::string& gojaFileName, const std::string& binaryFileName, int numberOfThreads = 1);
+  /// Header is stored in sizeof(BinaryLORHeader) bytes, numbers in little endian order
+  static void writeBinaryLORHeader(const BinaryLORHeader& header, char* bytes);
+  static BinaryLORHeader readBinaryLORHeader(const char* bytes);
+
+  static const char* parseNumber(const char* begin, const char* end, double& value);
+  static void parseGojaChunk(const char* begin, const char* end, std::vector<SinogramLOR>& lors);
+
+private:
+  LORFileTools() = delete;
+  ~LORFileTools() = delete;
+  LORFileTools(const LORFileTools&) = delete;
+  LORFileTools& operator=(const LORFileTools&) = delete;
+};
+
+#endif /*  !LORFILETOOLS_H */
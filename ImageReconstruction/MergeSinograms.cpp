@@ -0,0 +1,58 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *  @file MergeSinograms.cpp
+ */
+
+#include "JPetSinogramType.h"
+#include <iostream>
+#include <memory>
+#include <string>
+
+/**
+ * Adds sinograms created by SinogramCreator from independent data files. All sinograms have to have the same binning.
+ */
+int main(int argc, const char* argv[])
+{
+  if (argc < 4)
+  {
+    std::cerr << "Usage: " << argv[0] << " <output file> <input file 1> <input file 2> [more input files]" << std::endl;
+    return 1;
+  }
+  const std::string kSinogramName = "Sinogram";
+  std::unique_ptr<JPetSinogramType> merged(JPetSinogramType::readMapFromFile(argv[2], kSinogramName));
+  if (!merged)
+  {
+    std::cerr << "Could not read sinogram from file: " << argv[2] << std::endl;
+    return 1;
+  }
+  for (int i = 3; i < argc; i++)
+  {
+    std::unique_ptr<JPetSinogramType> sinogram(JPetSinogramType::readMapFromFile(argv[i], kSinogramName));
+    if (!sinogram)
+    {
+      std::cerr << "Could not read sinogram from file: " << argv[i] << std::endl;
+      return 1;
+    }
+    if (!merged->add(*sinogram))
+    {
+      std::cerr << "Binning of sinogram in file " << argv[i] << " is different than in " << argv[2] << ", sinograms can not be merged" << std::endl;
+      return 1;
+    }
+  }
+  JPetWriter writer(argv[1]);
+  merged->saveSinogramToFile(&writer);
+  writer.closeFile();
+  std::cout << "Merged " << argc - 2 << " sinograms, events used: " << merged->getNumberOfEventsUsedToCreateSinogram() << " of "
+            << merged->getNumberOfAllEvents() << std::endl;
+  return 0;
+}
@@ -0,0 +1,332 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *  @file Michelogram.cpp
+ */
+
+#include "Michelogram.h"
+#include "JPetLoggerInclude.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+const char kMichelogramMagic[8] = {'J', 'P', 'E', 'T', 'M', 'I', 'C', 'H'};
+const std::size_t kDataAlignment = 64;
+
+static_assert(sizeof(MichelogramHeader) == 72, "Michelogram header has to be 72 bytes long");
+static_assert(sizeof(MichelogramSegment) == 20, "Michelogram segment has to be 20 bytes long");
+static_assert(sizeof(float) == 4, "Michelogram format requires 32 bit floats");
+
+/* Ends of the LOR are ordered along the direction perpendicular to the normal of the sinogram angle.
+ * The LOR is reversed, when the normal (dy, -dx) of the LOR from the first to the second hit points
+ * opposite to the normal of its angle bin, computed in the same way as in SinogramCreatorTools.
+ */
+inline bool isReversed(const SinogramLOR& lor)
+{
+  const float normalX = lor.secondY - lor.firstY;
+  const float normalY = -(lor.secondX - lor.firstX);
+  bool reversed = normalY < 0.f;
+  float theta = std::atan2(normalY, normalX);
+  theta += reversed ? M_PI : 0.;
+  const float degrees = theta * (180.f / M_PI);
+  if (std::abs(std::round(degrees)) >= 180.f)
+    reversed = !reversed;
+  return reversed;
+}
+} // namespace
+
+const uint32_t Michelogram::kMichelogramVersion;
+
+Michelogram::~Michelogram() { close(); }
+
+/**
+ * Segments are ordered 0, +1, -1, +2, -2, ... Ring difference is the ring of the second end of the LOR
+ * minus the ring of the first one.
+ */
+std::vector<MichelogramSegment> Michelogram::getSegmentTable(int numberOfRings, int span, int maxRingDifference)
+{
+  std::vector<MichelogramSegment> segments;
+  const int half = (span - 1) / 2;
+  const int maxSegment = (maxRingDifference + half) / span;
+  uint32_t firstPlane = 0;
+  for (int k = 0; k <= maxSegment; k++)
+  {
+    const int minDifference = k == 0 ? 0 : k * span - half;
+    const int maxDifference = std::min(k * span + half, maxRingDifference);
+    const uint32_t numberOfPlanes = span == 1 ? numberOfRings - k : 2 * numberOfRings - 1 - 2 * minDifference;
+    if (k == 0)
+    {
+      segments.push_back({0, -maxDifference, maxDifference, firstPlane, numberOfPlanes});
+      firstPlane += numberOfPlanes;
+      continue;
+    }
+    segments.push_back({k, minDifference, maxDifference, firstPlane, numberOfPlanes});
+    firstPlane += numberOfPlanes;
+    segments.push_back({-k, -maxDifference, -minDifference, firstPlane, numberOfPlanes});
+    firstPlane += numberOfPlanes;
+  }
+  return segments;
+}
+
+bool Michelogram::create(const std::string& fileName, const MichelogramGeometry& geometry)
+{
+  close();
+  if (geometry.numberOfRings < 1 || geometry.ringWidth <= 0.f || geometry.numberOfDistances < 1 || geometry.numberOfAngles < 1 ||
+      geometry.tofSliceSize <= 0.f)
+  {
+    ERROR("Wrong geometry of michelogram, it has to have positive numbers of rings, distances, angles, ring width and TOF slice size.");
+    return false;
+  }
+  if (geometry.span < 1 || geometry.span % 2 == 0)
+  {
+    ERROR("Span of michelogram has to be positive odd number, given: " + std::to_string(geometry.span));
+    return false;
+  }
+  int maxRingDifference = geometry.maxRingDifference;
+  if (maxRingDifference < 0 || maxRingDifference > geometry.numberOfRings - 1)
+    maxRingDifference = geometry.numberOfRings - 1;
+  const int maxTOFBin = std::max(0, static_cast<int>(geometry.maxTOF / geometry.tofSliceSize));
+
+  fSegments = getSegmentTable(geometry.numberOfRings, geometry.span, maxRingDifference);
+  std::memset(&fHeader, 0, sizeof(fHeader));
+  std::memcpy(fHeader.magic, kMichelogramMagic, sizeof(kMichelogramMagic));
+  fHeader.version = kMichelogramVersion;
+  fHeader.numberOfRings = geometry.numberOfRings;
+  fHeader.span = geometry.span;
+  fHeader.maxRingDifference = maxRingDifference;
+  fHeader.numberOfSegments = fSegments.size();
+  fHeader.numberOfPlanes = fSegments.back().firstPlane + fSegments.back().numberOfPlanes;
+  fHeader.numberOfDistances = geometry.numberOfDistances;
+  fHeader.numberOfAngles = geometry.numberOfAngles;
+  fHeader.numberOfTOFBins = 2 * maxTOFBin + 1;
+  fHeader.firstTOFBin = -maxTOFBin;
+  fHeader.maxReconstructionLayerRadius = geometry.maxReconstructionLayerRadius;
+  fHeader.reconstructionDistanceAccuracy = geometry.reconstructionDistanceAccuracy;
+  fHeader.tofSliceSize = geometry.tofSliceSize;
+  fHeader.zBegin = geometry.zBegin;
+  fHeader.ringWidth = geometry.ringWidth;
+  const std::size_t tableEnd = sizeof(MichelogramHeader) + fSegments.size() * sizeof(MichelogramSegment);
+  fHeader.dataOffset = (tableEnd + kDataAlignment - 1) / kDataAlignment * kDataAlignment;
+
+  if (!map(fileName, O_RDWR | O_CREAT | O_TRUNC, fHeader.dataOffset + getNumberOfBins() * sizeof(float)))
+  {
+    ERROR("Could not create michelogram file: " + fileName);
+    return false;
+  }
+  std::memcpy(fMappedData, &fHeader, sizeof(fHeader));
+  std::memcpy(fMappedData + sizeof(fHeader), fSegments.data(), fSegments.size() * sizeof(MichelogramSegment));
+  fData = reinterpret_cast<float*>(fMappedData + fHeader.dataOffset);
+  buildPlaneTable();
+  return true;
+}
+
+bool Michelogram::open(const std::string& fileName, bool writable)
+{
+  close();
+  if (!map(fileName, writable ? O_RDWR : O_RDONLY, 0))
+  {
+    ERROR("Could not open michelogram file: " + fileName);
+    return false;
+  }
+  if (fMappedSize < sizeof(MichelogramHeader))
+  {
+    ERROR("File is too short to be a michelogram: " + fileName);
+    close();
+    return false;
+  }
+  std::memcpy(&fHeader, fMappedData, sizeof(fHeader));
+  if (std::memcmp(fHeader.magic, kMichelogramMagic, sizeof(kMichelogramMagic)) != 0 || fHeader.version != kMichelogramVersion)
+  {
+    ERROR("File is not a michelogram of version " + std::to_string(kMichelogramVersion) + ": " + fileName);
+    close();
+    return false;
+  }
+  const std::size_t tableEnd = sizeof(MichelogramHeader) + fHeader.numberOfSegments * sizeof(MichelogramSegment);
+  if (tableEnd > fHeader.dataOffset || fMappedSize < fHeader.dataOffset + getNumberOfBins() * sizeof(float))
+  {
+    ERROR("Michelogram file is truncated: " + fileName);
+    close();
+    return false;
+  }
+  fSegments.resize(fHeader.numberOfSegments);
+  std::memcpy(fSegments.data(), fMappedData + sizeof(fHeader), fSegments.size() * sizeof(MichelogramSegment));
+  fData = reinterpret_cast<float*>(fMappedData + fHeader.dataOffset);
+  buildPlaneTable();
+  return true;
+}
+
+/**
+ * Maps the whole file. When size is given, file is resized to it first, new part of file is filled with zeros.
+ */
+bool Michelogram::map(const std::string& fileName, int flags, std::size_t size)
+{
+  const bool writable = (flags & O_RDWR) != 0;
+  int fileDescriptor = ::open(fileName.c_str(), flags, 0644);
+  if (fileDescriptor < 0)
+    return false;
+  if (size > 0)
+  {
+    if (ftruncate(fileDescriptor, size) != 0)
+    {
+      ::close(fileDescriptor);
+      return false;
+    }
+  }
+  else
+  {
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size <= 0)
+    {
+      ::close(fileDescriptor);
+      return false;
+    }
+    size = fileStatus.st_size;
+  }
+  void* data = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fileDescriptor, 0);
+  ::close(fileDescriptor);
+  if (data == MAP_FAILED)
+    return false;
+  fMappedData = static_cast<char*>(data);
+  fMappedSize = size;
+  fWritable = writable;
+  return true;
+}
+
+void Michelogram::close()
+{
+  if (fMappedData)
+  {
+    if (fWritable)
+      msync(fMappedData, fMappedSize, MS_SYNC);
+    munmap(fMappedData, fMappedSize);
+  }
+  fMappedData = nullptr;
+  fMappedSize = 0;
+  fData = nullptr;
+  fWritable = false;
+}
+
+/**
+ * Plane of every ring pair is found once, so binning of the LOR needs only one lookup.
+ */
+void Michelogram::buildPlaneTable()
+{
+  const int numberOfRings = fHeader.numberOfRings;
+  const int span = fHeader.span;
+  const int half = (span - 1) / 2;
+  fPlaneOfRingPair.assign(numberOfRings * numberOfRings, -1);
+  for (int firstRing = 0; firstRing < numberOfRings; firstRing++)
+  {
+    for (int secondRing = 0; secondRing < numberOfRings; secondRing++)
+    {
+      const int difference = secondRing - firstRing;
+      if (std::abs(difference) > static_cast<int>(fHeader.maxRingDifference))
+        continue;
+      const int k = (std::abs(difference) + half) / span;
+      const int segmentIndex = k == 0 ? 0 : (difference > 0 ? 2 * k - 1 : 2 * k);
+      const auto& segment = fSegments[segmentIndex];
+      const int minDifference = std::min(std::abs(segment.minRingDifference), std::abs(segment.maxRingDifference));
+      const int planeInSegment = span == 1 ? std::min(firstRing, secondRing) : firstRing + secondRing - (k == 0 ? 0 : minDifference);
+      fPlaneOfRingPair[firstRing * numberOfRings + secondRing] = segment.firstPlane + planeInSegment;
+    }
+  }
+}
+
+std::size_t Michelogram::getNumberOfBins() const
+{
+  return static_cast<std::size_t>(fHeader.numberOfPlanes) * fHeader.numberOfTOFBins * fHeader.numberOfDistances * fHeader.numberOfAngles;
+}
+
+/**
+ * Returns ring containing z, or -1. Upper end of the last ring belongs to it, as in z slices of SinogramCreator.
+ */
+int Michelogram::getRing(float z) const
+{
+  const int numberOfRings = fHeader.numberOfRings;
+  const float ring = std::floor((z - fHeader.zBegin) / fHeader.ringWidth);
+  if (!(ring >= 0.f) || ring > numberOfRings)
+    return -1;
+  if (ring == numberOfRings)
+    return z <= fHeader.zBegin + numberOfRings * fHeader.ringWidth ? numberOfRings - 1 : -1;
+  return static_cast<int>(ring);
+}
+
+int Michelogram::getPlane(int firstRing, int secondRing) const
+{
+  const int numberOfRings = fHeader.numberOfRings;
+  if (firstRing < 0 || secondRing < 0 || firstRing >= numberOfRings || secondRing >= numberOfRings)
+    return -1;
+  return fPlaneOfRingPair[firstRing * numberOfRings + secondRing];
+}
+
+std::size_t Michelogram::getBinIndex(int plane, int tofBin, int distance, int angle) const
+{
+  return ((static_cast<std::size_t>(plane) * fHeader.numberOfTOFBins + (tofBin - fHeader.firstTOFBin)) * fHeader.numberOfDistances + distance) *
+             fHeader.numberOfAngles +
+         angle;
+}
+
+const float* Michelogram::getSinogram(int plane, int tofBin) const { return fData + getBinIndex(plane, tofBin, 0, 0); }
+
+std::size_t Michelogram::getBinIndices(const SinogramLOR* lors, std::size_t numberOfLORs, const SinogramBins& bins, std::vector<int64_t>& indices) const
+{
+  indices.resize(numberOfLORs);
+  const int numberOfDistances = fHeader.numberOfDistances;
+  const int numberOfAngles = fHeader.numberOfAngles;
+  const int firstTOFBin = fHeader.firstTOFBin;
+  const int lastTOFBin = firstTOFBin + static_cast<int>(fHeader.numberOfTOFBins) - 1;
+  const double tofSliceSize = fHeader.tofSliceSize;
+  std::size_t inside = 0;
+  for (std::size_t i = 0; i < numberOfLORs; i++)
+  {
+    indices[i] = -1;
+    const SinogramLOR& lor = lors[i];
+    const int distance = bins.distance[i];
+    const int angle = bins.angle[i];
+    if (distance >= numberOfDistances || angle >= numberOfAngles)
+      continue;
+    int firstRing = getRing(lor.firstZ);
+    int secondRing = getRing(lor.secondZ);
+    double timeDifference = lor.secondTOF - lor.firstTOF;
+    if (isReversed(lor))
+    {
+      std::swap(firstRing, secondRing);
+      timeDifference = -timeDifference;
+    }
+    const int plane = getPlane(firstRing, secondRing);
+    if (plane < 0)
+      continue;
+    const int tofBin = static_cast<int>((timeDifference / 2.) / tofSliceSize);
+    if (tofBin < firstTOFBin || tofBin > lastTOFBin)
+      continue;
+    indices[i] = getBinIndex(plane, tofBin, distance, angle);
+    inside++;
+  }
+  return inside;
+}
+
+void Michelogram::addCounts(const std::vector<int64_t>& indices)
+{
+  assert(fWritable);
+  for (const auto index : indices)
+  {
+    if (index >= 0)
+      fData[index] += 1.f;
+  }
+}
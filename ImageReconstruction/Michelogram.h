@@ -0,0 +1,147 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *  @file Michelogram.h
+ */
+
+#ifndef MICHELOGRAM_H
+#define MICHELOGRAM_H
+
+#include "SinogramCreatorTools.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Header of the michelogram file, followed by the table of segments and float32 counts
+ *
+ * Counts start at dataOffset and are ordered as [plane][TOF bin][distance][angle], so every
+ * (plane, TOF bin) pair is one sinogram in the same layout as JPetSinogramType::Matrix.
+ */
+struct MichelogramHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t numberOfRings;
+  uint32_t span;
+  uint32_t maxRingDifference;
+  uint32_t numberOfSegments;
+  uint32_t numberOfPlanes;
+  uint32_t numberOfDistances;
+  uint32_t numberOfAngles;
+  uint32_t numberOfTOFBins;
+  int32_t firstTOFBin;
+  float maxReconstructionLayerRadius; // in cm
+  float reconstructionDistanceAccuracy; // in cm
+  float tofSliceSize; // in ps
+  float zBegin; // in cm
+  float ringWidth; // in cm
+  uint32_t dataOffset;
+};
+
+/**
+ * @brief Range of ring differences stored in one oblique segment, and its planes
+ */
+struct MichelogramSegment
+{
+  int32_t segment;
+  int32_t minRingDifference;
+  int32_t maxRingDifference;
+  uint32_t firstPlane;
+  uint32_t numberOfPlanes;
+};
+
+/**
+ * @brief Parameters of the michelogram, given by the configuration of SinogramCreator
+ */
+struct MichelogramGeometry
+{
+  int numberOfRings = 1;
+  float zBegin = 0.f; // in cm
+  float ringWidth = 0.f; // in cm
+  int span = 1;
+  int maxRingDifference = -1; // negative value means all ring differences
+  int numberOfDistances = 0;
+  int numberOfAngles = 180;
+  float maxReconstructionLayerRadius = 0.f; // in cm
+  float reconstructionDistanceAccuracy = 0.1f; // in cm
+  float tofSliceSize = 100.f; // in ps
+  float maxTOF = 0.f; // maximal half of difference of hit times, in ps
+};
+
+/**
+ * @brief Fully 3D TOF sinogram of oblique LORs, kept in a memory mapped file
+ *
+ * Z slices of SinogramCreator are treated as rings, and both ends of the LOR give its ring pair.
+ * Ring pairs are grouped into segments of ring differences: segment 0 holds differences up to
+ * (span - 1) / 2, segment k the next span differences, up to maxRingDifference. Segments are stored
+ * in the order 0, +1, -1, +2, -2, ... With span 1 each plane of segment is one ring pair, indexed by
+ * the lower ring. With larger span axial compression is used: ring pairs with the same sum of rings
+ * are added in one plane. Ends of the LOR are ordered along the direction of the sinogram angle,
+ * so a LOR falls into the same bin regardless of the order of its hits, and TOF bin is taken with
+ * the same orientation. Distance and angle bins are the same as in the 2D sinogram.
+ *
+ * Counts are accumulated directly in the mapped file, so the michelogram does not have to fit
+ * in memory and can be read by the 3D reconstruction without copying.
+ */
+class Michelogram
+{
+public:
+  static const uint32_t kMichelogramVersion = 1;
+
+  Michelogram() {}
+  ~Michelogram();
+  Michelogram(const Michelogram&) = delete;
+  Michelogram& operator=(const Michelogram&) = delete;
+
+  bool create(const std::string& fileName, const MichelogramGeometry& geometry);
+  bool open(const std::string& fileName, bool writable = false);
+  void close();
+  bool isOpen() const { return fData != nullptr; }
+
+  const MichelogramHeader& getHeader() const { return fHeader; }
+  const std::vector<MichelogramSegment>& getSegments() const { return fSegments; }
+  std::size_t getNumberOfBins() const;
+
+  int getRing(float z) const;
+  int getPlane(int firstRing, int secondRing) const;
+  std::size_t getBinIndex(int plane, int tofBin, int distance, int angle) const;
+
+  float* data() { return fData; }
+  const float* data() const { return fData; }
+  /// Sinogram of given plane and TOF bin, numberOfDistances x numberOfAngles
+  const float* getSinogram(int plane, int tofBin) const;
+
+  /**
+   * @brief Finds bins of LORs, using distance and angle bins already found by SinogramCreatorTools::getSinogramBins.
+   * Index is -1 for LORs outside of the michelogram. Returns number of LORs inside. Only reads the michelogram,
+   * so it can be called from many threads.
+   */
+  std::size_t getBinIndices(const SinogramLOR* lors, std::size_t numberOfLORs, const SinogramBins& bins, std::vector<int64_t>& indices) const;
+  void addCounts(const std::vector<int64_t>& indices);
+
+  static std::vector<MichelogramSegment> getSegmentTable(int numberOfRings, int span, int maxRingDifference);
+
+private:
+  bool map(const std::string& fileName, int flags, std::size_t size);
+  void buildPlaneTable();
+
+  MichelogramHeader fHeader;
+  std::vector<MichelogramSegment> fSegments;
+  std::vector<int> fPlaneOfRingPair;
+  float* fData = nullptr;
+  char* fMappedData = nullptr;
+  std::size_t fMappedSize = 0;
+  bool fWritable = false;
+};
+
+#endif /*  !MICHELOGRAM_H */
@@ -1,6 +1,20 @@
+#pragma link C++ class JPetDenseMatrix<double>+;
+#pragma link C++ class JPetDenseMatrix<float>+;
 #pragma link C++ class JPetSinogramType+;
+// Sparse matrix dictionaries are kept to read sinograms saved by JPetSinogramType before version 5
 #pragma link C++ class boost::numeric::ublas::mapped_matrix<double,boost::numeric::ublas::basic_row_major<unsigned long,long>,boost::numeric::ublas::map_std<unsigned long,double,allocator<pair<const unsigned long,double> > > >+;
 #pragma link C++ class boost::numeric::ublas::ublas_expression<boost::numeric::ublas::mapped_matrix<double,boost::numeric::ublas::basic_row_major<unsigned long,long>,boost::numeric::ublas::map_std<unsigned long,double,allocator<pair<const unsigned long,double> > > > >+;
 #pragma link C++ class boost::numeric::ublas::matrix_expression<boost::numeric::ublas::mapped_matrix<double,boost::numeric::ublas::basic_row_major<unsigned long,long>,boost::numeric::ublas::map_std<unsigned long,double,allocator<pair<const unsigned long,double> > > > >+;
 #pragma link C++ class boost::numeric::ublas::matrix_container<boost::numeric::ublas::mapped_matrix<double,boost::numeric::ublas::basic_row_major<unsigned long,long>,boost::numeric::ublas::map_std<unsigned long,double,allocator<pair<const unsigned long,double> > > > >+;
-#pragma link C++ class boost::numeric::ublas::map_std<unsigned long,double,allocator<pair<const unsigned long,double> > >+;
\ No newline at end of file
+#pragma link C++ class boost::numeric::ublas::map_std<unsigned long,double,allocator<pair<const unsigned long,double> > >+;
+
+#pragma read sourceClass="JPetSinogramType" version="[-4]" targetClass="JPetSinogramType" \
+  source="std::vector<std::unordered_map<int,boost::numeric::ublas::mapped_matrix<double> > > fSinogramType" \
+  target="fSinogramType" \
+  code="{ fSinogramType = JPetSinogramType::convertLegacySinogram(onfile.fSinogramType); }"
+
+// numbers of events were 32-bit before version 6
+#pragma read sourceClass="JPetSinogramType" version="[-5]" targetClass="JPetSinogramType" \
+  source="unsigned int fNumberOfAllEvents; unsigned int fNumberOfEventsUsedToCreateSinogram" \
+  target="fNumberOfAllEvents, fNumberOfEventsUsedToCreateSinogram" \
+  code="{ fNumberOfAllEvents = onfile.fNumberOfAllEvents; fNumberOfEventsUsedToCreateSinogram = onfile.fNumberOfEventsUsedToCreateSinogram; }"
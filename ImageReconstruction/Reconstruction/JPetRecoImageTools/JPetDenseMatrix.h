@@ -0,0 +1,124 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file JPetDenseMatrix.h
+ */
+
+#ifndef _JPET_DenseMatrix_H_
+#define _JPET_DenseMatrix_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*! \brief Dense, row-major matrix used for sinograms and reconstructed images.
+ *
+ * Elements are kept in one contiguous buffer, element (i, j) is stored at i * size2() + j,
+ * so iterating over j for a fixed i walks through memory without jumps. Newly created
+ * matrix is filled with zeros. Accessors size1()/size2()/operator() follow ublas naming,
+ * so the matrix can be used in place of boost::numeric::ublas::mapped_matrix.
+ * Like std::vector::operator[], operator() and row() are not checked in release builds
+ * (only by assert in debug builds), at() checks indices and throws std::out_of_range.
+ * Class has ROOT dictionary generated for float and double elements.
+ */
+template <typename T>
+class JPetDenseMatrix
+{
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+
+  JPetDenseMatrix() {}
+  JPetDenseMatrix(size_type rows, size_type columns, T value = T()) : fRows(rows), fColumns(columns), fData(rows * columns, value) {}
+
+  size_type size1() const { return fRows; }
+  size_type size2() const { return fColumns; }
+  size_type size() const { return fData.size(); }
+  bool empty() const { return fData.empty(); }
+
+  T& operator()(size_type row, size_type column)
+  {
+    assert(row < fRows && column < fColumns);
+    return fData[row * fColumns + column];
+  }
+
+  const T& operator()(size_type row, size_type column) const
+  {
+    assert(row < fRows && column < fColumns);
+    return fData[row * fColumns + column];
+  }
+
+  T& at(size_type row, size_type column)
+  {
+    checkIndices(row, column);
+    return fData[row * fColumns + column];
+  }
+
+  const T& at(size_type row, size_type column) const
+  {
+    checkIndices(row, column);
+    return fData[row * fColumns + column];
+  }
+
+  T* data() { return fData.data(); }
+  const T* data() const { return fData.data(); }
+  T* row(size_type row) { return fData.data() + row * fColumns; }
+  const T* row(size_type row) const { return fData.data() + row * fColumns; }
+
+  void fill(T value) { std::fill(fData.begin(), fData.end(), value); }
+
+  /// Changes dimensions of the matrix, all elements are set to zero
+  void resize(size_type rows, size_type columns)
+  {
+    fRows = rows;
+    fColumns = columns;
+    fData.assign(rows * columns, T());
+  }
+
+  JPetDenseMatrix& operator+=(const JPetDenseMatrix& other)
+  {
+    assert(fRows == other.fRows && fColumns == other.fColumns);
+    for (size_type i = 0; i < fData.size(); i++)
+      fData[i] += other.fData[i];
+    return *this;
+  }
+
+  JPetDenseMatrix& operator*=(T factor)
+  {
+    for (auto& element : fData)
+      element *= factor;
+    return *this;
+  }
+
+  bool operator==(const JPetDenseMatrix& other) const
+  {
+    return fRows == other.fRows && fColumns == other.fColumns && fData == other.fData;
+  }
+  bool operator!=(const JPetDenseMatrix& other) const { return !(*this == other); }
+
+private:
+  void checkIndices(size_type row, size_type column) const
+  {
+    if (row >= fRows || column >= fColumns)
+      throw std::out_of_range("JPetDenseMatrix: element (" + std::to_string(row) + ", " + std::to_string(column) + ") is outside of " +
+                              std::to_string(fRows) + " x " + std::to_string(fColumns) + " matrix");
+  }
+
+  size_type fRows = 0;
+  size_type fColumns = 0;
+  std::vector<T> fData;
+};
+
+#endif /* !_JPET_DenseMatrix_H_ */
@@ -0,0 +1,207 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file JPetDirectFourierReconstruction.cpp
+ */
+
+#include "JPetDirectFourierReconstruction.h"
+#include "JPetFFTWFilterEngine.h"
+#include "JPetRecoImageTools.h"
+#include "fftw3.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+const int JPetDirectFourierReconstruction::kKernelWidth;
+const int JPetDirectFourierReconstruction::kKernelTableDensity;
+
+namespace
+{
+inline int wrap(int index, int size)
+{
+  const int wrapped = index % size;
+  return wrapped < 0 ? wrapped + size : wrapped;
+}
+
+/// Adds value to the grid, spread with the kernel around (u, v), frequencies outside of grid are wrapped as in FFT
+void spreadOnGrid(fftw_complex* grid, int gridSize, double u, double v, double re, double im, const std::vector<double>& kernelTable)
+{
+  const double halfWidth = JPetDirectFourierReconstruction::kKernelWidth / 2.;
+  const int uBegin = std::ceil(u - halfWidth);
+  const int uEnd = std::floor(u + halfWidth);
+  const int vBegin = std::ceil(v - halfWidth);
+  const int vEnd = std::floor(v + halfWidth);
+  for (int iv = vBegin; iv <= vEnd; iv++)
+  {
+    const double kv = kernelTable[std::lround(std::abs(iv - v) * JPetDirectFourierReconstruction::kKernelTableDensity)];
+    fftw_complex* row = grid + (std::size_t)wrap(iv, gridSize) * gridSize;
+    for (int iu = uBegin; iu <= uEnd; iu++)
+    {
+      const double k = kv * kernelTable[std::lround(std::abs(iu - u) * JPetDirectFourierReconstruction::kKernelTableDensity)];
+      fftw_complex& cell = row[wrap(iu, gridSize)];
+      cell[0] += re * k;
+      cell[1] += im * k;
+    }
+  }
+}
+} // namespace
+
+JPetSinogramType::Matrix JPetDirectFourierReconstruction::reconstruct(const JPetSinogramType::Matrix3D& sinogram, JPetFilterInterface& filter)
+{
+  if (sinogram.empty())
+    return JPetSinogramType::Matrix(0, 0);
+  JPetSinogramType::Matrix sum = sinogram.cbegin()->second;
+  for (auto it = std::next(sinogram.cbegin()); it != sinogram.cend(); it++)
+  {
+    for (std::size_t i = 0; i < sum.size(); i++)
+      sum.data()[i] += it->second.data()[i];
+  }
+  return reconstruct(sum, filter);
+}
+
+JPetSinogramType::Matrix JPetDirectFourierReconstruction::reconstruct(const JPetSinogramType::Matrix& sinogram, JPetFilterInterface& filter)
+{
+  const int projectionLength = sinogram.size1();
+  const int projectionAngles = sinogram.size2();
+  // size and center of the image are the same as in JPetRecoImageTools::backProjectMatlab
+  const int N = 2 * std::floor((double)projectionLength / (2. * std::sqrt(2)));
+  if (N <= 0 || projectionAngles == 0)
+    return JPetSinogramType::Matrix(0, 0);
+  const int center = std::floor((double)(N + 1) / 2.);
+  const int xLeft = -center + 1;
+  const int yTop = center - 1;
+  const int ctrIdx = std::ceil((double)projectionLength / 2.);
+
+  // radial frequency m / K of projection falls on m * (cos, sin) of the grid, since grid has K cells
+  const int K = JPetRecoImageTools::nextPowerOf2(2 * projectionLength);
+  const int inFTLength = K / 2 + 1;
+  const double beta = getKernelBeta((double)K / N);
+  const std::vector<double> kernelTable = getKernelTable(beta);
+
+  double* projections = (double*)fftw_malloc((std::size_t)K * projectionAngles * sizeof(double));
+  fftw_complex* spectra = (fftw_complex*)fftw_malloc((std::size_t)inFTLength * projectionAngles * sizeof(fftw_complex));
+  fftw_complex* grid = (fftw_complex*)fftw_malloc((std::size_t)K * K * sizeof(fftw_complex));
+  fftw_plan forward;
+  fftw_plan inverse;
+  {
+    auto plannerLock = JPetFFTWFilterEngine::getInstance().lockPlanner();
+    const int n[] = {K};
+    forward = fftw_plan_many_dft_r2c(1, n, projectionAngles, projections, nullptr, 1, K, spectra, nullptr, 1, inFTLength, FFTW_ESTIMATE);
+    inverse = fftw_plan_dft_2d(K, K, grid, grid, FFTW_BACKWARD, FFTW_ESTIMATE);
+  }
+
+  // distance 0 of projection is put at index 0, so phase of spectrum is relative to the center of image
+  std::fill(projections, projections + (std::size_t)K * projectionAngles, 0.);
+  for (int angle = 0; angle < projectionAngles; angle++)
+  {
+    double* projection = projections + (std::size_t)angle * K;
+    for (int distance = 0; distance < projectionLength; distance++)
+      projection[wrap(distance - ctrIdx, K)] = sinogram(distance, angle);
+  }
+  fftw_execute(forward);
+
+  // weight of polar sample is the area it covers, |w| dw dtheta, with dw / 4 used for w = 0
+  const std::vector<double>& response = filter.table(K);
+  const double angleStep = M_PI / (double)projectionAngles;
+  const double sampleArea = angleStep / ((double)K * (double)K);
+  std::fill(grid[0], grid[0] + (std::size_t)2 * K * K, 0.);
+  for (int angle = 0; angle < projectionAngles; angle++)
+  {
+    const double costheta = std::cos((double)angle * angleStep);
+    const double sintheta = std::sin((double)angle * angleStep);
+    const fftw_complex* spectrum = spectra + (std::size_t)angle * inFTLength;
+    for (int m = 0; m < K / 2; m++)
+    {
+      const double weight = (m == 0 ? 0.25 : (double)m) * sampleArea * response[m];
+      const double re = spectrum[m][0] * weight;
+      const double im = spectrum[m][1] * weight;
+      const double u = m * costheta;
+      const double v = m * sintheta;
+      spreadOnGrid(grid, K, u, v, re, im, kernelTable);
+      if (m > 0) // projection is real, so its spectrum at -w is complex conjugate of spectrum at w
+        spreadOnGrid(grid, K, -u, -v, re, -im, kernelTable);
+    }
+  }
+  fftw_execute(inverse);
+
+  std::vector<double> deapodization(K);
+  for (int x = 0; x < K; x++)
+    deapodization[x] = getDeapodization(x < K / 2 ? x : x - K, K, beta);
+
+  JPetSinogramType::Matrix reconstructed(N, N);
+  for (int i = 0; i < N; i++)
+  {
+    const int y = wrap(yTop - i, K);
+    for (int j = 0; j < N; j++)
+    {
+      const int x = wrap(xLeft + j, K);
+      reconstructed(i, j) = grid[(std::size_t)y * K + x][0] / (deapodization[x] * deapodization[y]);
+    }
+  }
+
+  {
+    auto plannerLock = JPetFFTWFilterEngine::getInstance().lockPlanner();
+    fftw_destroy_plan(forward);
+    fftw_destroy_plan(inverse);
+  }
+  fftw_free(projections);
+  fftw_free(spectra);
+  fftw_free(grid);
+  return reconstructed;
+}
+
+double JPetDirectFourierReconstruction::getKernelBeta(double oversampling)
+{
+  const double widthRatio = kKernelWidth / oversampling;
+  return M_PI * std::sqrt(widthRatio * widthRatio * (oversampling - 0.5) * (oversampling - 0.5) - 0.8);
+}
+
+std::vector<double> JPetDirectFourierReconstruction::getKernelTable(double beta)
+{
+  const int tableSize = kKernelWidth * kKernelTableDensity / 2 + 1;
+  std::vector<double> table(tableSize);
+  for (int i = 0; i < tableSize; i++)
+  {
+    const double relativeDistance = (double)i / (tableSize - 1);
+    table[i] = besselI0(beta * std::sqrt(std::max(0., 1. - relativeDistance * relativeDistance)));
+  }
+  return table;
+}
+
+/**
+ * Fourier transform of I0(beta * sqrt(1 - (2d / W)^2)) on [-W/2, W/2]:
+ * W * sinh(sqrt(beta^2 - a^2)) / sqrt(beta^2 - a^2), with a = pi * W * x / gridSize,
+ * sinh turns into sin when a > beta.
+ */
+double JPetDirectFourierReconstruction::getDeapodization(double x, int gridSize, double beta)
+{
+  const double a = M_PI * kKernelWidth * x / gridSize;
+  const double argument = beta * beta - a * a;
+  if (argument > 1e-12)
+    return kKernelWidth * std::sinh(std::sqrt(argument)) / std::sqrt(argument);
+  if (argument < -1e-12)
+    return kKernelWidth * std::sin(std::sqrt(-argument)) / std::sqrt(-argument);
+  return kKernelWidth;
+}
+
+double JPetDirectFourierReconstruction::besselI0(double x)
+{
+  const double halfX = x / 2.;
+  double term = 1.;
+  double sum = 1.;
+  for (int k = 1; term > sum * 1e-16; k++)
+  {
+    term *= (halfX / k) * (halfX / k);
+    sum += term;
+  }
+  return sum;
+}
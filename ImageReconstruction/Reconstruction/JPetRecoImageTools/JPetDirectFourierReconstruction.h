@@ -0,0 +1,66 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file JPetDirectFourierReconstruction.h
+ */
+
+#ifndef _JPET_DirectFourierReconstruction_H_
+#define _JPET_DirectFourierReconstruction_H_
+
+#include <vector>
+
+#include "JPetFilterInterface.h"
+#include "JPetSinogramType.h"
+
+/*! \brief Direct Fourier (gridding) reconstruction of one slice, based on the Fourier slice theorem.
+ *
+ * Every projection is zero padded to K (next power of 2 of 2 * number of distances) and transformed
+ * with 1D FFT, which gives values of 2D Fourier transform of the image on the line through the origin
+ * at the angle of projection. Samples on these polar lines are weighted by density of sampling (|w|,
+ * as the ramp in FBP) and by the filter, and spread onto K x K Cartesian grid with Kaiser-Bessel kernel.
+ * Image is obtained with one 2D inverse FFT and divided by the Fourier transform of the kernel
+ * (deapodization). Cost per slice is O(K^2 log K), instead of O(N^2 * angles) of backprojection.
+ *
+ * Image has the same size and pixel positions as the result of JPetRecoImageTools::backProjectMatlab,
+ * one pixel is one distance bin of the sinogram. TOF windows are summed before reconstruction.
+ */
+class JPetDirectFourierReconstruction
+{
+public:
+  /// Width of Kaiser-Bessel kernel in cells of the frequency grid
+  static const int kKernelWidth = 4;
+  /// Number of samples of the kernel table per one cell of the grid
+  static const int kKernelTableDensity = 1000;
+
+  /*! \brief Reconstructs image from sum of all TOF windows of sinogram
+   *  \param sinogram sinogram of one slice, [distance][angle] matrices of TOF windows
+   *  \param filter window applied to radial frequencies, called with (m + 1) / K as in FBP filtering
+   */
+  static JPetSinogramType::Matrix reconstruct(const JPetSinogramType::Matrix3D& sinogram, JPetFilterInterface& filter);
+  static JPetSinogramType::Matrix reconstruct(const JPetSinogramType::Matrix& sinogram, JPetFilterInterface& filter);
+
+  /// Shape parameter of Kaiser-Bessel kernel for given oversampling of the grid (Beatty et al., IEEE TMI 24 (2005) 799)
+  static double getKernelBeta(double oversampling);
+  /// Kaiser-Bessel kernel I0(beta * sqrt(1 - (2d / W)^2)) sampled every 1 / kKernelTableDensity of the cell, for d in [0, W / 2]
+  static std::vector<double> getKernelTable(double beta);
+  /// Fourier transform of the kernel at pixel x of image of gridSize pixels
+  static double getDeapodization(double x, int gridSize, double beta);
+  static double besselI0(double x);
+
+private:
+  JPetDirectFourierReconstruction() = delete;
+  ~JPetDirectFourierReconstruction() = delete;
+  JPetDirectFourierReconstruction(const JPetDirectFourierReconstruction&) = delete;
+  JPetDirectFourierReconstruction& operator=(const JPetDirectFourierReconstruction&) = delete;
+};
+
+#endif /*  !_JPET_DirectFourierReconstruction_H_ */
@@ -0,0 +1,254 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file JPetFFTWFilterEngine.cpp
+ */
+
+#include "JPetFFTWFilterEngine.h"
+#include "JPetLoggerInclude.h"
+#include "JPetRecoImageTools.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+JPetFFTWFilterEngine& JPetFFTWFilterEngine::getInstance()
+{
+  static JPetFFTWFilterEngine engine;
+  return engine;
+}
+
+JPetFFTWFilterEngine::~JPetFFTWFilterEngine() { clear(); }
+
+JPetSinogramType::Matrix JPetFFTWFilterEngine::filter(const JPetSinogramType::Matrix& sinogram, JPetFilterInterface& filterFunction)
+{
+  assert(sinogram.size1() > 1);
+  const int N = sinogram.size1();
+  const int M = JPetRecoImageTools::nextPowerOf2(2 * N);
+  const int nAngles = sinogram.size2();
+  if (nAngles == 0)
+    return JPetSinogramType::Matrix(N, nAngles);
+
+  Workspace workspace;
+  BatchPlans& batch = acquire(N, M, nAngles, workspace);
+  const std::vector<double>& ramp = batch.entry->rampResponse;
+  forwardTransform(batch, workspace, sinogram);
+  double* spectrum = reinterpret_cast<double*>(workspace.spectrum);
+  applyFilter(spectrum, spectrum, ramp[0], filterFunction.rampTable(M, ramp), nAngles);
+  JPetSinogramType::Matrix result = inverseTransform(batch, workspace, N);
+  release(batch, workspace);
+  return result;
+}
+
+JPetFFTWFilterEngine::SinogramSpectrum JPetFFTWFilterEngine::transform(const JPetSinogramType::Matrix& sinogram)
+{
+  assert(sinogram.size1() > 1);
+  SinogramSpectrum result;
+  result.N = sinogram.size1();
+  result.M = JPetRecoImageTools::nextPowerOf2(2 * result.N);
+  result.nAngles = sinogram.size2();
+  if (result.nAngles == 0)
+    return result;
+
+  Workspace workspace;
+  BatchPlans& batch = acquire(result.N, result.M, result.nAngles, workspace);
+  forwardTransform(batch, workspace, sinogram);
+  const double* spectrum = reinterpret_cast<const double*>(workspace.spectrum);
+  result.values.assign(spectrum, spectrum + (std::size_t)2 * (result.M / 2 + 1) * result.nAngles);
+  release(batch, workspace);
+  return result;
+}
+
+JPetSinogramType::Matrix JPetFFTWFilterEngine::filter(const SinogramSpectrum& spectrum, JPetFilterInterface& filterFunction)
+{
+  if (spectrum.nAngles == 0)
+    return JPetSinogramType::Matrix(spectrum.N, spectrum.nAngles);
+
+  Workspace workspace;
+  BatchPlans& batch = acquire(spectrum.N, spectrum.M, spectrum.nAngles, workspace);
+  const std::vector<double>& ramp = batch.entry->rampResponse;
+  // stored spectrum stays untouched, filtered one is written to the buffer destroyed by the inverse transform
+  applyFilter(spectrum.values.data(), reinterpret_cast<double*>(workspace.spectrum), ramp[0], filterFunction.rampTable(spectrum.M, ramp),
+              spectrum.nAngles);
+  JPetSinogramType::Matrix result = inverseTransform(batch, workspace, spectrum.N);
+  release(batch, workspace);
+  return result;
+}
+
+void JPetFFTWFilterEngine::forwardTransform(const BatchPlans& batch, Workspace& workspace, const JPetSinogramType::Matrix& sinogram)
+{
+  const std::size_t sinogramSize = sinogram.size();
+  std::copy(sinogram.data(), sinogram.data() + sinogramSize, workspace.real);
+  std::fill(workspace.real + sinogramSize, workspace.real + (std::size_t)batch.entry->M * batch.nAngles, 0.);
+  fftw_execute_dft_r2c(batch.forward, workspace.real, workspace.spectrum);
+}
+
+JPetSinogramType::Matrix JPetFFTWFilterEngine::inverseTransform(const BatchPlans& batch, Workspace& workspace, int N)
+{
+  fftw_execute_dft_c2r(batch.inverse, workspace.spectrum, workspace.real);
+  JPetSinogramType::Matrix result(N, batch.nAngles);
+  double* out = result.data();
+  for (std::size_t i = 0; i < result.size(); i++)
+    out[i] = workspace.real[i] / N;
+  return result;
+}
+
+/**
+ * Row y of spectrum holds frequency y of all angles, as 2 * nAngles doubles (real, imaginary),
+ * so every row is multiplied by one value of the response.
+ */
+void JPetFFTWFilterEngine::applyFilter(const double* in, double* out, double zeroFrequencyRamp, const std::vector<double>& response, int nAngles)
+{
+  const int rowLength = 2 * nAngles;
+  // zero frequency is multiplied by the ramp twice, as it was always done in doFFTW1D
+  for (int k = 0; k < rowLength; k++)
+    out[k] = in[k] * zeroFrequencyRamp * response[0];
+  for (std::size_t y = 1; y < response.size(); y++)
+  {
+    const double* inRow = in + y * rowLength;
+    double* outRow = out + y * rowLength;
+    const double value = response[y];
+    for (int k = 0; k < rowLength; k++)
+      outRow[k] = inRow[k] * value;
+  }
+}
+
+bool JPetFFTWFilterEngine::importWisdom(const std::string& fileName)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  if (!fftw_import_wisdom_from_filename(fileName.c_str()))
+  {
+    WARNING("Could not import FFTW wisdom from file: " + fileName);
+    return false;
+  }
+  return true;
+}
+
+bool JPetFFTWFilterEngine::exportWisdom(const std::string& fileName)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  if (!fftw_export_wisdom_to_filename(fileName.c_str()))
+  {
+    WARNING("Could not export FFTW wisdom to file: " + fileName);
+    return false;
+  }
+  return true;
+}
+
+std::size_t JPetFFTWFilterEngine::getNumberOfCachedSizes() const
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  return fCache.size();
+}
+
+void JPetFFTWFilterEngine::clear()
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  for (auto& cached : fCache)
+  {
+    for (auto& batched : cached.second->batches)
+    {
+      BatchPlans& batch = *batched.second;
+      fftw_destroy_plan(batch.forward);
+      fftw_destroy_plan(batch.inverse);
+      for (auto& workspace : batch.freeWorkspaces)
+        destroyWorkspace(workspace);
+    }
+  }
+  fCache.clear();
+}
+
+JPetFFTWFilterEngine::BatchPlans& JPetFFTWFilterEngine::acquire(int N, int M, int nAngles, Workspace& workspace)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  auto& cached = fCache[std::make_pair(N, M)];
+  if (!cached)
+  {
+    cached.reset(new CacheEntry);
+    cached->N = N;
+    cached->M = M;
+    cached->rampResponse = createRampResponse(M);
+  }
+  auto& batched = cached->batches[nAngles];
+  if (!batched)
+  {
+    batched.reset(new BatchPlans);
+    batched->entry = cached.get();
+    batched->nAngles = nAngles;
+    // planning with FFTW_MEASURE overwrites buffers, so it is done before they are filled
+    workspace = createWorkspace(M, nAngles);
+    const int n[] = {M};
+    batched->forward =
+        fftw_plan_many_dft_r2c(1, n, nAngles, workspace.real, nullptr, nAngles, 1, workspace.spectrum, nullptr, nAngles, 1, FFTW_MEASURE);
+    batched->inverse =
+        fftw_plan_many_dft_c2r(1, n, nAngles, workspace.spectrum, nullptr, nAngles, 1, workspace.real, nullptr, nAngles, 1, FFTW_MEASURE);
+    return *batched;
+  }
+  if (batched->freeWorkspaces.empty())
+  {
+    workspace = createWorkspace(M, nAngles);
+  }
+  else
+  {
+    workspace = batched->freeWorkspaces.back();
+    batched->freeWorkspaces.pop_back();
+  }
+  return *batched;
+}
+
+void JPetFFTWFilterEngine::release(BatchPlans& batch, const Workspace& workspace)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  batch.freeWorkspaces.push_back(workspace);
+}
+
+JPetFFTWFilterEngine::Workspace JPetFFTWFilterEngine::createWorkspace(int M, int nAngles)
+{
+  Workspace workspace;
+  workspace.real = (double*)fftw_malloc((std::size_t)M * nAngles * sizeof(double));
+  workspace.spectrum = (fftw_complex*)fftw_malloc((std::size_t)(M / 2 + 1) * nAngles * sizeof(fftw_complex));
+  return workspace;
+}
+
+void JPetFFTWFilterEngine::destroyWorkspace(Workspace& workspace)
+{
+  fftw_free(workspace.real);
+  fftw_free(workspace.spectrum);
+  workspace = Workspace();
+}
+
+/**
+ * Ramp kernel in spatial domain: 1/4 in the center, -1/(pi*i)^2 for odd i and 0 for even i,
+ * mirrored to the end of buffer. Its Fourier transform is computed once per size.
+ */
+std::vector<double> JPetFFTWFilterEngine::createRampResponse(int M)
+{
+  const int inFTLength = M / 2 + 1;
+  double* inFilter = (double*)fftw_malloc(M * sizeof(double));
+  fftw_complex* outFilter = (fftw_complex*)fftw_malloc(inFTLength * sizeof(fftw_complex));
+  fftw_plan planFilter = fftw_plan_dft_r2c_1d(M, inFilter, outFilter, FFTW_ESTIMATE);
+  inFilter[0] = 0.25;
+  for (int i = 1; i < inFTLength; i++)
+  {
+    if (i % 2 == 0)
+      inFilter[i] = inFilter[M - i] = 0;
+    else
+      inFilter[i] = inFilter[M - i] = -1. / ((M_PI * (double)(i)) * (M_PI * (double)(i)));
+  }
+  fftw_execute(planFilter);
+  std::vector<double> rampResponse(inFTLength);
+  for (int y = 0; y < inFTLength; y++)
+    rampResponse[y] = 2 * outFilter[y][0];
+  fftw_destroy_plan(planFilter);
+  fftw_free(inFilter);
+  fftw_free(outFilter);
+  return rampResponse;
+}
@@ -0,0 +1,135 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file JPetFFTWFilterEngine.h
+ */
+
+#ifndef _JPET_FFTWFilterEngine_H_
+#define _JPET_FFTWFilterEngine_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "JPetFilterInterface.h"
+#include "JPetSinogramType.h"
+#include "fftw3.h"
+
+/*! \brief Ramp filtering of sinograms with FFTW, reusing plans between calls.
+ *
+ * For every size of projection N (zero padded to M, next power of 2 of 2N) engine keeps
+ * Fourier transform of the ramp kernel, and for every number of angles forward and inverse plans
+ * with aligned work buffers, so only the first sinogram of given size pays for planning with FFTW_MEASURE.
+ * All angles are transformed by one plan of the advanced interface (fftw_plan_many_dft_r2c/c2r).
+ * Zero padded sinogram keeps its row-major layout [distance][angle], so transforms of all angles are
+ * interleaved with stride equal to the number of angles, copying in and out of the buffer is contiguous,
+ * and the filter is applied to one contiguous row of all angles per frequency.
+ * Planning is guarded by a mutex, since FFTW planner is not thread safe. Plans are executed
+ * with new-array execute functions on buffers owned by a single call, so many threads
+ * can filter sinograms at the same time. Buffers are returned to the engine after the call
+ * and reused by the next one.
+ *
+ * Wisdom gathered by the planner can be saved to a file and loaded in the next run,
+ * then creation of plans does not need any measurements.
+ */
+class JPetFFTWFilterEngine
+{
+public:
+  /// Fourier transforms of all angles of one sinogram, kept to filter it with many filters
+  struct SinogramSpectrum
+  {
+    int N = 0;
+    int M = 0;
+    int nAngles = 0;
+    std::vector<double> values; // (M / 2 + 1) x nAngles complex values, ordered [frequency][angle]
+  };
+
+  static JPetFFTWFilterEngine& getInstance();
+  ~JPetFFTWFilterEngine();
+
+  /*! \brief Filters every angle (column) of sinogram with ramp filter multiplied by filterFunction
+   *  \param sinogram sinogram to filter, size1() is number of distances, size2() number of angles
+   *  \param filterFunction filter applied in frequency domain, its table of ramp response is created on the first call for given M
+   */
+  JPetSinogramType::Matrix filter(const JPetSinogramType::Matrix& sinogram, JPetFilterInterface& filterFunction);
+
+  /*! \brief Forward transform of every angle of sinogram, so it can be filtered with many filters
+   * (e.g. in the scan of cut-off values) without repeating the transform
+   */
+  SinogramSpectrum transform(const JPetSinogramType::Matrix& sinogram);
+  /// Same as filter(sinogram, filterFunction), for sinogram already transformed with transform()
+  JPetSinogramType::Matrix filter(const SinogramSpectrum& spectrum, JPetFilterInterface& filterFunction);
+
+  /// Loads FFTW wisdom from file, returns false if file could not be read
+  bool importWisdom(const std::string& fileName);
+  /// Saves FFTW wisdom gathered so far to file, returns false if file could not be written
+  bool exportWisdom(const std::string& fileName);
+
+  /// Locks FFTW planner, plans created or destroyed outside of the engine have to be made under this lock
+  std::unique_lock<std::mutex> lockPlanner() { return std::unique_lock<std::mutex>(fMutex); }
+
+  /// Number of projection sizes with cached plans
+  std::size_t getNumberOfCachedSizes() const;
+  /// Destroys all cached plans and buffers, can not be called when other thread is filtering
+  void clear();
+
+private:
+  JPetFFTWFilterEngine() {}
+  JPetFFTWFilterEngine(const JPetFFTWFilterEngine&) = delete;
+  JPetFFTWFilterEngine& operator=(const JPetFFTWFilterEngine&) = delete;
+
+  struct Workspace
+  {
+    double* real = nullptr;
+    fftw_complex* spectrum = nullptr;
+  };
+
+  struct CacheEntry;
+
+  /// Plans transforming all angles of sinogram at once, with buffers of M x nAngles values
+  struct BatchPlans
+  {
+    const CacheEntry* entry = nullptr;
+    int nAngles = 0;
+    fftw_plan forward = nullptr;
+    fftw_plan inverse = nullptr;
+    std::vector<Workspace> freeWorkspaces;
+  };
+
+  struct CacheEntry
+  {
+    int N = 0;
+    int M = 0;
+    std::vector<double> rampResponse; // 2 * real part of Fourier transform of ramp kernel, M / 2 + 1 values
+    std::map<int, std::unique_ptr<BatchPlans>> batches; // by number of angles
+  };
+
+  /// Returns plans for given sizes together with workspace for one call, creates both if needed
+  BatchPlans& acquire(int N, int M, int nAngles, Workspace& workspace);
+  void release(BatchPlans& batch, const Workspace& workspace);
+
+  static void forwardTransform(const BatchPlans& batch, Workspace& workspace, const JPetSinogramType::Matrix& sinogram);
+  static JPetSinogramType::Matrix inverseTransform(const BatchPlans& batch, Workspace& workspace, int N);
+  static void applyFilter(const double* in, double* out, double zeroFrequencyRamp, const std::vector<double>& response, int nAngles);
+
+  static Workspace createWorkspace(int M, int nAngles);
+  static void destroyWorkspace(Workspace& workspace);
+  static std::vector<double> createRampResponse(int M);
+
+  mutable std::mutex fMutex;
+  std::map<std::pair<int, int>, std::unique_ptr<CacheEntry>> fCache;
+};
+
+#endif /*  !_JPET_FFTWFilterEngine_H_ */
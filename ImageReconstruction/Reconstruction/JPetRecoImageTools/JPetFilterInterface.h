@@ -16,7 +16,16 @@
 #ifndef _JPetFilterInterface_H_
 #define _JPetFilterInterface_H_
 
+#include <map>
+#include <vector>
+
 /*! \brief Interface that all filters should implement.
+ *
+ * Filtering uses the response of filter sampled at (y + 1) / M for y = 0 ... M / 2,
+ * table(M) evaluates it once for every M and keeps it in the filter, so the virtual
+ * operator() is not called for every frequency of every angle. Parameters of filters
+ * do not change after construction, so tables stay valid. Tables are not guarded
+ * by a lock, filter should not be shared between threads.
 */
 class JPetFilterInterface
 {
@@ -27,6 +36,44 @@ public:
       @par pos Position of variable rescaled to [0, 1] 
    */
   virtual double operator()(double pos) = 0;
+
+  /*! @brief Returns response of filter at (y + 1) / M, for y = 0 ... M / 2
+   */
+  const std::vector<double>& table(int M)
+  {
+    FilterTables& tables = fTables[M];
+    if (tables.response.empty())
+    {
+      tables.response.resize(M / 2 + 1);
+      for (int y = 0; y <= M / 2; y++)
+        tables.response[y] = (*this)((double)(y + 1) / M);
+    }
+    return tables.response;
+  }
+
+  /*! @brief Returns table(M) multiplied by ramp response, which has to depend only on M
+      @par rampResponse ramp filter in frequency domain, M / 2 + 1 values
+   */
+  const std::vector<double>& rampTable(int M, const std::vector<double>& rampResponse)
+  {
+    const std::vector<double>& response = table(M);
+    FilterTables& tables = fTables[M];
+    if (tables.rampResponse.empty())
+    {
+      tables.rampResponse.resize(response.size());
+      for (std::size_t y = 0; y < response.size(); y++)
+        tables.rampResponse[y] = rampResponse[y] * response[y];
+    }
+    return tables.rampResponse;
+  }
+
+private:
+  struct FilterTables
+  {
+    std::vector<double> response;
+    std::vector<double> rampResponse;
+  };
+  std::map<int, FilterTables> fTables;
 };
 
 #endif /*  !_JPetFilterInterface_H_ */
@@ -0,0 +1,233 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file JPetOSEMReconstruction.cpp
+ */
+
+#include "JPetOSEMReconstruction.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace
+{
+/* Joseph traversal of LOR x cos + y sin = s. When the LOR is closer to x axis (|sin| >= |cos|) it goes through all
+ * columns j, y = (s - x cos) / sin falls between rows i0 and i0 + 1; otherwise it goes through all rows.
+ * visit(firstPixel, secondPixel, weightOfSecond, length) is called for every column (row) crossing the image,
+ * secondPixel is -1 when it is outside of the image.
+ */
+template <typename Visitor>
+void traverseLOR(int imageSize, int xLeft, int yTop, double s, double cos, double sin, const Visitor& visit)
+{
+  if (std::abs(sin) >= std::abs(cos))
+  {
+    const double length = 1. / std::abs(sin);
+    for (int j = 0; j < imageSize; j++)
+    {
+      const double x = xLeft + j;
+      const double row = yTop - (s - x * cos) / sin;
+      const int i0 = std::floor(row);
+      const double fraction = row - i0;
+      if (i0 < -1 || i0 >= imageSize)
+        continue;
+      const int first = i0 >= 0 ? i0 * imageSize + j : -1;
+      const int second = i0 + 1 < imageSize ? (i0 + 1) * imageSize + j : -1;
+      visit(first, second, fraction, length);
+    }
+  }
+  else
+  {
+    const double length = 1. / std::abs(cos);
+    for (int i = 0; i < imageSize; i++)
+    {
+      const double y = yTop - i;
+      const double column = (s - y * sin) / cos - xLeft;
+      const int j0 = std::floor(column);
+      const double fraction = column - j0;
+      if (j0 < -1 || j0 >= imageSize)
+        continue;
+      const int first = j0 >= 0 ? i * imageSize + j0 : -1;
+      const int second = j0 + 1 < imageSize ? i * imageSize + j0 + 1 : -1;
+      visit(first, second, fraction, length);
+    }
+  }
+}
+} // namespace
+
+JPetOSEMReconstruction::JPetOSEMReconstruction(int projectionLength, int projectionAngles)
+    : fProjectionLength(projectionLength), fProjectionAngles(projectionAngles), fCos(projectionAngles), fSin(projectionAngles)
+{
+  // size and center of the image are the same as in JPetRecoImageTools::backProjectMatlab
+  fImageSize = 2 * std::floor((double)projectionLength / (2. * std::sqrt(2)));
+  const int center = std::floor((double)(fImageSize + 1) / 2.);
+  fXLeft = -center + 1;
+  fYTop = center - 1;
+  fCtrIdx = std::ceil((double)projectionLength / 2.);
+  const double angleStep = M_PI / (double)projectionAngles;
+  for (int angle = 0; angle < projectionAngles; angle++)
+  {
+    fCos[angle] = std::cos((double)angle * angleStep);
+    fSin[angle] = std::sin((double)angle * angleStep);
+  }
+}
+
+void JPetOSEMReconstruction::setNumberOfSubsets(int numberOfSubsets)
+{
+  fNumberOfSubsets = std::max(1, std::min(numberOfSubsets, fProjectionAngles));
+}
+
+void JPetOSEMReconstruction::setNumberOfThreads(int numberOfThreads) { fNumberOfThreads = std::max(1, numberOfThreads); }
+
+JPetSinogramType::Matrix JPetOSEMReconstruction::reconstruct(const JPetSinogramType::Matrix3D& sinogram, int iterations,
+                                                             const CheckpointFunction& checkpoint) const
+{
+  // slice without any TOF window has no LORs, it is reconstructed as zero sinogram
+  JPetSinogramType::Matrix sum(fProjectionLength, fProjectionAngles);
+  for (const auto& tofWindow : sinogram)
+  {
+    if (tofWindow.second.size1() != sum.size1() || tofWindow.second.size2() != sum.size2())
+      return JPetSinogramType::Matrix(0, 0);
+    for (std::size_t i = 0; i < sum.size(); i++)
+      sum.data()[i] += tofWindow.second.data()[i];
+  }
+  return reconstruct(sum, iterations, checkpoint);
+}
+
+JPetSinogramType::Matrix JPetOSEMReconstruction::reconstruct(const JPetSinogramType::Matrix& sinogram, int iterations,
+                                                             const CheckpointFunction& checkpoint) const
+{
+  if (fImageSize <= 0 || (int)sinogram.size1() != fProjectionLength || (int)sinogram.size2() != fProjectionAngles)
+    return JPetSinogramType::Matrix(0, 0);
+
+  const std::vector<std::vector<int>> subsets = getSubsets();
+  const std::size_t imagePixels = (std::size_t)fImageSize * fImageSize;
+
+  // sensitivity of every subset, A_s^T 1
+  const JPetSinogramType::Matrix ones(fProjectionLength, fProjectionAngles, 1.);
+  std::vector<JPetSinogramType::Matrix> sensitivity(subsets.size(), JPetSinogramType::Matrix(fImageSize, fImageSize));
+  JPetSinogramType::Matrix image(fImageSize, fImageSize);
+  for (std::size_t subset = 0; subset < subsets.size(); subset++)
+  {
+    backProject(ones, sensitivity[subset], subsets[subset]);
+    for (std::size_t p = 0; p < imagePixels; p++)
+      if (sensitivity[subset].data()[p] > 0.)
+        image.data()[p] = 1.;
+  }
+
+  JPetSinogramType::Matrix expected(fProjectionLength, fProjectionAngles);
+  JPetSinogramType::Matrix correction(fImageSize, fImageSize);
+  for (int iteration = 1; iteration <= iterations; iteration++)
+  {
+    for (std::size_t subset = 0; subset < subsets.size(); subset++)
+    {
+      const std::vector<int>& angles = subsets[subset];
+      forwardProject(image, expected, angles);
+      for (int k = 0; k < fProjectionLength; k++)
+      {
+        for (int angle : angles)
+          expected(k, angle) = expected(k, angle) > 0. ? sinogram(k, angle) / expected(k, angle) : 0.;
+      }
+      std::fill(correction.data(), correction.data() + imagePixels, 0.);
+      backProject(expected, correction, angles);
+      const double* subsetSensitivity = sensitivity[subset].data();
+      for (std::size_t p = 0; p < imagePixels; p++)
+      {
+        if (subsetSensitivity[p] > 0.)
+          image.data()[p] *= correction.data()[p] / subsetSensitivity[p];
+      }
+    }
+    if (checkpoint)
+      checkpoint(iteration, image);
+  }
+  return image;
+}
+
+void JPetOSEMReconstruction::forwardProject(const JPetSinogramType::Matrix& image, JPetSinogramType::Matrix& sinogram,
+                                            const std::vector<int>& angles) const
+{
+  const double* pixels = image.data();
+  forEachAngle(angles, [&](int, int angle) {
+    for (int k = 0; k < fProjectionLength; k++)
+    {
+      double sum = 0.;
+      traverseLOR(fImageSize, fXLeft, fYTop, k - fCtrIdx, fCos[angle], fSin[angle],
+                  [&](int first, int second, double fraction, double length) {
+                    if (first >= 0)
+                      sum += (1. - fraction) * length * pixels[first];
+                    if (second >= 0)
+                      sum += fraction * length * pixels[second];
+                  });
+      sinogram(k, angle) = sum;
+    }
+  });
+}
+
+void JPetOSEMReconstruction::backProject(const JPetSinogramType::Matrix& sinogram, JPetSinogramType::Matrix& image,
+                                         const std::vector<int>& angles) const
+{
+  const int numberOfThreads = std::max(1, std::min<int>(fNumberOfThreads, angles.size()));
+  // first thread writes directly to the image, others to their own copies added at the end
+  std::vector<JPetSinogramType::Matrix> threadImages(numberOfThreads - 1, JPetSinogramType::Matrix(fImageSize, fImageSize));
+  forEachAngle(angles, [&](int thread, int angle) {
+    double* pixels = thread == 0 ? image.data() : threadImages[thread - 1].data();
+    for (int k = 0; k < fProjectionLength; k++)
+    {
+      const double value = sinogram(k, angle);
+      if (value == 0.)
+        continue;
+      traverseLOR(fImageSize, fXLeft, fYTop, k - fCtrIdx, fCos[angle], fSin[angle],
+                  [&](int first, int second, double fraction, double length) {
+                    if (first >= 0)
+                      pixels[first] += (1. - fraction) * length * value;
+                    if (second >= 0)
+                      pixels[second] += fraction * length * value;
+                  });
+    }
+  });
+  for (const auto& threadImage : threadImages)
+  {
+    for (std::size_t p = 0; p < image.size(); p++)
+      image.data()[p] += threadImage.data()[p];
+  }
+}
+
+void JPetOSEMReconstruction::forEachAngle(const std::vector<int>& angles, const std::function<void(int thread, int angle)>& function) const
+{
+  const int numberOfThreads = std::max(1, std::min<int>(fNumberOfThreads, angles.size()));
+  if (numberOfThreads == 1)
+  {
+    for (int angle : angles)
+      function(0, angle);
+    return;
+  }
+  const std::size_t anglesPerThread = (angles.size() + numberOfThreads - 1) / numberOfThreads;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < numberOfThreads; t++)
+  {
+    workers.emplace_back([&, t]() {
+      const std::size_t begin = std::min(t * anglesPerThread, angles.size());
+      const std::size_t end = std::min(begin + anglesPerThread, angles.size());
+      for (std::size_t i = begin; i < end; i++)
+        function(t, angles[i]);
+    });
+  }
+  for (auto& worker : workers)
+    worker.join();
+}
+
+std::vector<std::vector<int>> JPetOSEMReconstruction::getSubsets() const
+{
+  std::vector<std::vector<int>> subsets(fNumberOfSubsets);
+  for (int angle = 0; angle < fProjectionAngles; angle++)
+    subsets[angle % fNumberOfSubsets].push_back(angle);
+  return subsets;
+}
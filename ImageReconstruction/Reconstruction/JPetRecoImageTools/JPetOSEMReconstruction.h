@@ -0,0 +1,82 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file JPetOSEMReconstruction.h
+ */
+
+#ifndef _JPET_OSEMReconstruction_H_
+#define _JPET_OSEMReconstruction_H_
+
+#include <functional>
+#include <vector>
+
+#include "JPetSinogramType.h"
+
+/*! \brief Ordered subsets expectation maximization (OSEM) reconstruction of one slice from dense sinogram.
+ *
+ * System matrix is not stored, LORs are projected on the fly with Joseph projector: LOR is traversed
+ * along the image axis closer to its direction, in every column (or row) of pixels image is linearly
+ * interpolated between two pixels, and the value is weighted by the length of LOR in the column.
+ * Backprojection uses the same weights, so it is exact transpose of the projection.
+ *
+ * Angles are split into interleaved subsets (subset s holds angles s, s + subsets, s + 2 * subsets, ...),
+ * every subset updates the image with EM step x *= A_s^T (y / A_s x) / A_s^T 1. Angles of subset are
+ * shared between threads, every thread backprojects into its own image and images are added in the order
+ * of threads, so the result with given number of threads is reproducible.
+ *
+ * Image has the same size and pixel positions as the result of JPetRecoImageTools::backProjectMatlab,
+ * one pixel is one distance bin of the sinogram, bin k of the sinogram is at distance k - ceil(L / 2)
+ * from the center.
+ */
+class JPetOSEMReconstruction
+{
+public:
+  /// Called after every iteration with number of finished iterations (starting from 1) and current image
+  using CheckpointFunction = std::function<void(int iteration, const JPetSinogramType::Matrix& image)>;
+
+  JPetOSEMReconstruction(int projectionLength, int projectionAngles);
+
+  void setNumberOfSubsets(int numberOfSubsets);
+  void setNumberOfThreads(int numberOfThreads);
+  int getNumberOfSubsets() const { return fNumberOfSubsets; }
+  int getImageSize() const { return fImageSize; }
+
+  /*! \brief Reconstructs image from sinogram, TOF windows are summed. Sinogram without TOF windows gives zero image.
+   *  \param iterations number of full iterations, each of them goes through all subsets
+   *  \param checkpoint function called after every iteration (Optional)
+   */
+  JPetSinogramType::Matrix reconstruct(const JPetSinogramType::Matrix3D& sinogram, int iterations, const CheckpointFunction& checkpoint = nullptr) const;
+  JPetSinogramType::Matrix reconstruct(const JPetSinogramType::Matrix& sinogram, int iterations, const CheckpointFunction& checkpoint = nullptr) const;
+
+  /// Projects image along LORs of given angles, other columns of sinogram are not changed
+  void forwardProject(const JPetSinogramType::Matrix& image, JPetSinogramType::Matrix& sinogram, const std::vector<int>& angles) const;
+  /// Adds backprojection of given angles of sinogram to image
+  void backProject(const JPetSinogramType::Matrix& sinogram, JPetSinogramType::Matrix& image, const std::vector<int>& angles) const;
+
+private:
+  /// Calls function(angle) for all angles, split between threads, with index of the thread
+  void forEachAngle(const std::vector<int>& angles, const std::function<void(int thread, int angle)>& function) const;
+  std::vector<std::vector<int>> getSubsets() const;
+
+  int fProjectionLength = 0;
+  int fProjectionAngles = 0;
+  int fImageSize = 0;
+  int fCtrIdx = 0;
+  int fXLeft = 0;
+  int fYTop = 0;
+  int fNumberOfSubsets = 1;
+  int fNumberOfThreads = 1;
+  std::vector<double> fCos;
+  std::vector<double> fSin;
+};
+
+#endif /*  !_JPET_OSEMReconstruction_H_ */
@@ -15,12 +15,17 @@
 
 #include "JPetRecoImageTools.h"
 #include "JPetLoggerInclude.h"
+#include "JPetFFTWFilterEngine.h"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <thread>
 
 JPetRecoImageTools::JPetRecoImageTools() {}
 
 JPetRecoImageTools::~JPetRecoImageTools() {}
 
-std::function<double(int, int)> JPetRecoImageTools::matrixGetterFactory(const JPetSinogramType::SparseMatrix& emissionMatrix, bool isTransposed)
+std::function<double(int, int)> JPetRecoImageTools::matrixGetterFactory(const JPetSinogramType::Matrix& emissionMatrix, bool isTransposed)
 {
   if (!isTransposed)
   {
@@ -57,20 +62,22 @@ double JPetRecoImageTools::linear(int i, double y, std::function<double(int, int
   return (1 - weight) * func(i, j) + weight * func(i, j + 1);
 }
 
-void JPetRecoImageTools::rescale(JPetSinogramType::SparseMatrix& matrix, double minCutoff, double rescaleFactor)
+void JPetRecoImageTools::rescale(JPetSinogramType::Matrix& matrix, double minCutoff, double rescaleFactor)
 {
+  if (matrix.size() == 0)
+    return;
+  double* data = matrix.data();
+  const std::size_t size = matrix.size();
 
-  double datamax, datamin = matrix(0, 0);
-  for (unsigned int k = 0; k < matrix.size1(); k++)
+  /// Applying min Cutoff and finding the largest and the smallest element in the same pass.
+  double datamin = std::max(data[0], minCutoff);
+  double datamax = datamin;
+  for (std::size_t i = 0; i < size; i++)
   {
-    for (unsigned int j = 0; j < matrix.size2(); j++)
-    {
-      /// Applying min Cutoff
-      if (matrix(k, j) < minCutoff) matrix(k, j) = minCutoff;
-      /// Finding the largest and the smallest element in the matrix.
-      if (matrix(k, j) > datamax) datamax = matrix(k, j);
-      if (matrix(k, j) < datamin) datamin = matrix(k, j);
-    }
+    const double value = std::max(data[i], minCutoff);
+    data[i] = value;
+    datamin = std::min(datamin, value);
+    datamax = std::max(datamax, value);
   }
 
   /// datamin represents the constant background factor.
@@ -80,98 +87,331 @@ void JPetRecoImageTools::rescale(JPetSinogramType::SparseMatrix& matrix, double
     return;
   }
 
-  for (unsigned int k = 0; k < matrix.size1(); k++)
+  const double scale = rescaleFactor / (datamax - datamin);
+  for (std::size_t i = 0; i < size; i++)
+    data[i] = (data[i] - datamin) * scale;
+}
+
+JPetRecoImageTools::ImageStatistics JPetRecoImageTools::getStatistics(const JPetSinogramType::Matrix& matrix)
+{
+  ImageStatistics statistics;
+  if (matrix.size() == 0)
+    return statistics;
+  const double* data = matrix.data();
+  statistics.min = data[0];
+  statistics.max = data[0];
+  for (std::size_t i = 0; i < matrix.size(); i++)
+  {
+    statistics.min = std::min(statistics.min, data[i]);
+    statistics.max = std::max(statistics.max, data[i]);
+    statistics.sum += data[i];
+  }
+  return statistics;
+}
+
+int JPetRecoImageTools::getMaxValue(const JPetSinogramType::Matrix& result)
+{
+  if (result.size() == 0)
+    return 0;
+  return std::max(0, static_cast<int>(getStatistics(result).max));
+}
+
+/**
+ * Values are rounded and clipped to [0, 65535], maxval of the file is the largest rounded value,
+ * so pixels are stored in 1 byte when they fit, otherwise in 2 bytes big-endian as required by PGM.
+ */
+bool JPetRecoImageTools::savePGM(const JPetSinogramType::Matrix& result, const std::string& outputFileName)
+{
+  std::vector<unsigned int> pixels(result.size());
+  unsigned int maxValue = 1;
+  for (std::size_t i = 0; i < result.size(); i++)
+  {
+    const double value = std::round(result.data()[i]);
+    pixels[i] = value <= 0. ? 0u : value >= 65535. ? 65535u : static_cast<unsigned int>(value);
+    maxValue = std::max(maxValue, pixels[i]);
+  }
+
+  const std::string header = "P5\n" + std::to_string(result.size2()) + " " + std::to_string(result.size1()) + "\n" + std::to_string(maxValue) + "\n";
+  const std::size_t bytesPerPixel = maxValue > 255 ? 2 : 1;
+  std::vector<char> buffer(header.begin(), header.end());
+  buffer.reserve(header.size() + bytesPerPixel * pixels.size());
+  for (unsigned int pixel : pixels)
+  {
+    if (bytesPerPixel == 2)
+      buffer.push_back(static_cast<char>(pixel >> 8));
+    buffer.push_back(static_cast<char>(pixel & 0xFF));
+  }
+  return writeFile(buffer, outputFileName);
+}
+
+/// Detached header is not used, values are saved as raw float in the byte order of the machine
+bool JPetRecoImageTools::saveNRRD(const JPetSinogramType::Matrix& result, const std::string& outputFileName)
+{
+  const std::uint16_t byteOrderTest = 1;
+  const bool littleEndian = *reinterpret_cast<const unsigned char*>(&byteOrderTest) == 1;
+  const std::string header = "NRRD0004\ntype: float\ndimension: 2\nsizes: " + std::to_string(result.size2()) + " " +
+                             std::to_string(result.size1()) + "\nendian: " + (littleEndian ? "little" : "big") + "\nencoding: raw\n\n";
+  std::vector<float> values(result.data(), result.data() + result.size());
+  std::vector<char> buffer(header.begin(), header.end());
+  const char* valuesBegin = reinterpret_cast<const char*>(values.data());
+  buffer.insert(buffer.end(), valuesBegin, valuesBegin + values.size() * sizeof(float));
+  return writeFile(buffer, outputFileName);
+}
+
+bool JPetRecoImageTools::writeFile(const std::vector<char>& buffer, const std::string& outputFileName)
+{
+  std::ofstream file(outputFileName, std::ios::binary);
+  if (!file.write(buffer.data(), buffer.size()))
   {
-    for (unsigned int j = 0; j < matrix.size2(); j++) { matrix(k, j) = (matrix(k, j) - datamin) * rescaleFactor / (datamax - datamin); }
+    ERROR("Could not write image to file: " + outputFileName);
+    return false;
   }
+  return true;
 }
 
-int JPetRecoImageTools::getMaxValue(const JPetSinogramType::SparseMatrix& result)
+namespace
 {
-  int maxValue = 0;
-  for (unsigned int i = 0; i < result.size1(); i++)
+/// Pixel seen from one angle: index of the pixel in the image, projection bin and signed distance to the center of LOR
+struct BackProjectionPixel
+{
+  int pixel;
+  int bin;
+  double distance;
+};
+
+/* Geometry of the backprojection depends only on the angle, so for every angle it is calculated once
+ * and reused for all TOF bins. Pixels outside of the reconstruction circle, or further from the center
+ * of their LOR than maxDistance, are not stored.
+ */
+void fillBackProjectionTable(int imageSize, double cos, double sin, double maxDistance, std::vector<BackProjectionPixel>& table)
+{
+  const double center = (double)(imageSize - 1) / 2.0;
+  const double center2 = center * center;
+  table.clear();
+  for (int x = 0; x < imageSize; x++)
   {
-    for (unsigned int j = 0; j < result.size2(); j++)
+    double xMinusCenter = (double)x - center;
+    double xMinusCenter2 = xMinusCenter * xMinusCenter;
+    double ttemp = xMinusCenter * cos + center;
+
+    for (int y = 0; y < imageSize; y++)
     {
-      if (static_cast<int>(result(i, j)) > maxValue) maxValue = static_cast<int>(result(i, j));
+      double yMinusCenter = (double)y - center;
+      double yMinusCenter2 = yMinusCenter * yMinusCenter;
+
+      if (yMinusCenter2 + xMinusCenter2 < center2)
+      {
+        double t = ttemp - yMinusCenter * sin;
+        int n = std::round(t);
+
+        float lor_center_x = center + cos * (n - center);
+        float lor_center_y = center + sin * (n - center);
+
+        double diffBetweenLORCenterYandY = lor_center_y - y;
+        double diffBetweenLORCenterXandX = lor_center_x - x;
+        double distanceToCenterOfLOR =
+            std::sqrt((diffBetweenLORCenterXandX * diffBetweenLORCenterXandX) + (diffBetweenLORCenterYandY * diffBetweenLORCenterYandY));
+        if (distanceToCenterOfLOR > maxDistance)
+          continue;
+        if (x < lor_center_x) distanceToCenterOfLOR = -distanceToCenterOfLOR;
+        table.push_back({y * imageSize + x, n, distanceToCenterOfLOR});
+      }
     }
   }
-  return maxValue;
 }
 
+struct FBPWeightFunction
+{
+  double operator()(double, double, double) const { return 1.; }
+};
+
+/* Gaussian TOF kernel exp(-u^2 / (2 sigma^2)) sampled every sigma / kSamplesPerSigma for u in [-3 sigma, 3 sigma],
+ * so weights of pixels are read from the table instead of calling exp.
+ */
+class TOFKernelTable
+{
+public:
+  static const int kSamplesPerSigma = 100;
+  static const int kSigmaRange = 3;
+
+  explicit TOFKernelTable(double sigma) : fSigma(sigma), fScale(kSamplesPerSigma / sigma), fTable(2 * kSigmaRange * kSamplesPerSigma + 1)
+  {
+    for (int i = 0; i < (int)fTable.size(); i++)
+    {
+      const double u = (double)(i - kSigmaRange * kSamplesPerSigma) / kSamplesPerSigma;
+      fTable[i] = std::exp(-u * u / 2.);
+    }
+  }
+  double getRange() const { return kSigmaRange * fSigma; }
+  /// Weight at distance u from the TOF center, u has to be inside of getRange()
+  double operator()(double u) const { return fTable[std::lround(u * fScale) + kSigmaRange * kSamplesPerSigma]; }
+
+private:
+  double fSigma;
+  double fScale;
+  std::vector<double> fTable;
+};
 
-JPetSinogramType::SparseMatrix JPetRecoImageTools::backProject(const JPetSinogramType::Matrix3D& sinogram, float sinogramAccuracy, float tofWindow,
+using WeightFunctionPointer = double (*)(double, double, double);
+} // namespace
+
+/**
+ * Known weighting functions of JPetRecoImageTools are replaced by inlined function objects,
+ * any other function is called through std::function.
+ */
+JPetSinogramType::Matrix JPetRecoImageTools::backProject(const JPetSinogramType::Matrix3D& sinogram, float sinogramAccuracy, float tofWindow,
                                                                float lorTOFSigma, FilteredBackProjectionWeightingFunction fbpwf,
                                                                RescaleFunc rescaleFunc, int rescaleMinCutoff, int rescaleFactor)
 {
   if (sinogram.size() == 0)
-    return JPetSinogramType::SparseMatrix(0, 0);
+    return JPetSinogramType::Matrix(0, 0);
+
+  JPetSinogramType::Matrix reconstructedProjection;
+  const auto* weightFunctionPointer = fbpwf.target<WeightFunctionPointer>();
+  if (weightFunctionPointer && *weightFunctionPointer == &JPetRecoImageTools::FBPWeight)
+    reconstructedProjection = backProjectWithWeight(sinogram, sinogramAccuracy, tofWindow, lorTOFSigma, FBPWeightFunction());
+  else if (weightFunctionPointer && *weightFunctionPointer == &JPetRecoImageTools::FBPTOFWeight && lorTOFSigma > 0.f)
+    reconstructedProjection = backProjectTOF(sinogram, sinogramAccuracy, tofWindow, lorTOFSigma);
+  else
+    reconstructedProjection = backProjectWithWeight(sinogram, sinogramAccuracy, tofWindow, lorTOFSigma, fbpwf);
+
+  reconstructedProjection *= M_PI / 360.;
+  rescaleFunc(reconstructedProjection, rescaleMinCutoff, rescaleFactor);
+  return reconstructedProjection;
+}
+
+/**
+ * For every angle pixels are projected once, then all TOF bins are accumulated using the cached projection,
+ * in the same order as before, so the result does not depend on the caching.
+ */
+template <typename WeightFunction>
+JPetSinogramType::Matrix JPetRecoImageTools::backProjectWithWeight(const JPetSinogramType::Matrix3D& sinogram, float sinogramAccuracy,
+                                                                   float tofWindow, float lorTOFSigma, const WeightFunction& weight)
+{
   const auto sinogramBegin = sinogram.cbegin();
-  int imageSize = sinogramBegin->second.size1();
-  double center = (double)(imageSize - 1) / 2.0;
-  double center2 = center * center;
-  double angleStep = M_PI / (double)sinogramBegin->second.size2();
+  const int imageSize = sinogramBegin->second.size1();
+  const int numberOfAngles = sinogramBegin->second.size2();
+  const double angleStep = M_PI / (double)numberOfAngles;
 
-  JPetSinogramType::SparseMatrix reconstructedProjection(imageSize, imageSize);
+  JPetSinogramType::Matrix reconstructedProjection(imageSize, imageSize);
+  double* image = reconstructedProjection.data();
   const double speed_of_light = 2.99792458 * sinogramAccuracy; // in reconstruction space, accuracy * ps/cm
 
   const int max_sigma_multi = 3;
+  const double maxDistance = max_sigma_multi * lorTOFSigma * speed_of_light;
 
-  for (int angle = 0; angle < sinogramBegin->second.size2(); angle++)
+  std::vector<BackProjectionPixel> table;
+  table.reserve(imageSize * imageSize);
+  for (int angle = 0; angle < numberOfAngles; angle++)
   {
     double cos = std::cos((double)angle * angleStep);
     double sin = std::sin((double)angle * angleStep);
+    fillBackProjectionTable(imageSize, cos, sin, maxDistance, table);
 
     for (const auto& tofBin : sinogram)
     {
       const double lor_tof_center = tofBin.first * tofWindow * speed_of_light;
-      for (int x = 0; x < imageSize; x++)
-      {
-        double xMinusCenter = (double)x - center;
-        double xMinusCenter2 = xMinusCenter * xMinusCenter;
-        double ttemp = xMinusCenter * cos + center;
+      const JPetSinogramType::Matrix& projection = tofBin.second;
+      for (const auto& pixel : table)
+        image[pixel.pixel] += projection(pixel.bin, angle) * weight(lor_tof_center, pixel.distance, lorTOFSigma);
+    }
+  }
+  return reconstructedProjection;
+}
 
-        for (int y = 0; y < imageSize; y++)
-        {
-          double yMinusCenter = (double)y - center;
-          double yMinusCenter2 = yMinusCenter * yMinusCenter;
+/**
+ * Pixel (x, y) lies on LOR with bin round(t), t = (x - c) cos - (y - c) sin + c, at signed distance
+ * s = (x - c) sin + (y - c) cos along the LOR from its center. For every (angle, TOF bin) only pixels with
+ * s inside of 3 sigma of the TOF center contribute; this band is clipped to the x range of every row of image
+ * (and to the reconstruction circle), so pixels outside of it are never visited. Weight is read from the kernel table.
+ */
+JPetSinogramType::Matrix JPetRecoImageTools::backProjectTOF(const JPetSinogramType::Matrix3D& sinogram, float sinogramAccuracy, float tofWindow,
+                                                            float lorTOFSigma)
+{
+  const auto sinogramBegin = sinogram.cbegin();
+  const int imageSize = sinogramBegin->second.size1();
+  const int numberOfAngles = sinogramBegin->second.size2();
+  const double angleStep = M_PI / (double)numberOfAngles;
 
-          if (yMinusCenter2 + xMinusCenter2 < center2)
-          {
-            double t = ttemp - yMinusCenter * sin;
-            int n = std::round(t);
-
-            float lor_center_x = center + cos * (n - center);
-            float lor_center_y = center + sin * (n - center);
-
-            double diffBetweenLORCenterYandY = lor_center_y - y;
-            double diffBetweenLORCenterXandX = lor_center_x - x;
-            double distanceToCenterOfLOR =
-                std::sqrt((diffBetweenLORCenterXandX * diffBetweenLORCenterXandX) + (diffBetweenLORCenterYandY * diffBetweenLORCenterYandY));
-            if (distanceToCenterOfLOR > max_sigma_multi * lorTOFSigma * speed_of_light)
-              continue;
-            if (x < lor_center_x) distanceToCenterOfLOR = -distanceToCenterOfLOR;
-            reconstructedProjection(y, x) += tofBin.second(n, angle) * fbpwf(lor_tof_center, distanceToCenterOfLOR, lorTOFSigma);
-          }
-        }
-      }
+  JPetSinogramType::Matrix reconstructedProjection(imageSize, imageSize);
+  double* image = reconstructedProjection.data();
+  const double speed_of_light = 2.99792458 * sinogramAccuracy; // in reconstruction space, accuracy * ps/cm
+  const TOFKernelTable kernel(lorTOFSigma * speed_of_light);
+  const double range = kernel.getRange();
+
+  const double center = (double)(imageSize - 1) / 2.0;
+  const double center2 = center * center;
+  // x range of the reconstruction circle in every row, (x - c)^2 + (y - c)^2 < c^2
+  std::vector<int> circleBegin(imageSize);
+  std::vector<int> circleEnd(imageSize);
+  for (int y = 0; y < imageSize; y++)
+  {
+    const double yMinusCenter = (double)y - center;
+    const double halfChord2 = center2 - yMinusCenter * yMinusCenter;
+    if (halfChord2 <= 0.)
+    {
+      circleBegin[y] = 0;
+      circleEnd[y] = -1;
+      continue;
     }
+    const double halfChord = std::sqrt(halfChord2);
+    circleBegin[y] = std::max(0, (int)std::floor(center - halfChord));
+    circleEnd[y] = std::min(imageSize - 1, (int)std::ceil(center + halfChord));
   }
 
-  for (int x = 0; x < imageSize; x++)
+  for (int angle = 0; angle < numberOfAngles; angle++)
   {
-    for (int y = 0; y < imageSize; y++) { reconstructedProjection(y, x) *= M_PI / 360.; }
+    const double cos = std::cos((double)angle * angleStep);
+    const double sin = std::sin((double)angle * angleStep);
+
+    for (const auto& tofBin : sinogram)
+    {
+      const double lor_tof_center = tofBin.first * tofWindow * speed_of_light;
+      const JPetSinogramType::Matrix& projection = tofBin.second;
+      for (int y = 0; y < imageSize; y++)
+      {
+        const double yMinusCenter = (double)y - center;
+        const double rowDistance = yMinusCenter * cos - lor_tof_center; // s - lor_tof_center at x = c
+        int xBegin = circleBegin[y];
+        int xEnd = circleEnd[y];
+        if (sin > 1e-9)
+        {
+          xBegin = std::max(xBegin, (int)std::ceil(center + (-range - rowDistance) / sin));
+          xEnd = std::min(xEnd, (int)std::floor(center + (range - rowDistance) / sin));
+        }
+        else if (std::abs(rowDistance) > range)
+        {
+          continue;
+        }
+        for (int x = xBegin; x <= xEnd; x++)
+        {
+          const double xMinusCenter = (double)x - center;
+          if (xMinusCenter * xMinusCenter + yMinusCenter * yMinusCenter >= center2)
+            continue;
+          const double u = xMinusCenter * sin + rowDistance;
+          if (std::abs(u) > range)
+            continue;
+          const int n = std::round(xMinusCenter * cos - yMinusCenter * sin + center);
+          if (n < 0 || n >= imageSize)
+            continue;
+          image[y * imageSize + x] += projection(n, angle) * kernel(u);
+        }
+      }
+    }
   }
-  rescaleFunc(reconstructedProjection, rescaleMinCutoff, rescaleFactor);
   return reconstructedProjection;
 }
 
-JPetSinogramType::SparseMatrix JPetRecoImageTools::backProjectMatlab(const JPetSinogramType::Matrix3D& sinogram, float sinogramAccuracy, float tofWindow,
+/**
+ * Rows of the image are split into continuous blocks, one per thread. Every thread accumulates only its own rows,
+ * in the same order as a single thread, so the result does not depend on the number of threads.
+ */
+JPetSinogramType::Matrix JPetRecoImageTools::backProjectMatlab(const JPetSinogramType::Matrix3D& sinogram, float sinogramAccuracy, float tofWindow,
                                                     float lorTOFSigma, FilteredBackProjectionWeightingFunction fbpwf, RescaleFunc rescaleFunc,
-                                                    int rescaleMinCutoff, int rescaleFactor)
+                                                    int rescaleMinCutoff, int rescaleFactor, int numberOfThreads)
 {
   if (sinogram.size() == 0)
-    return JPetSinogramType::SparseMatrix(0, 0);
+    return JPetSinogramType::Matrix(0, 0);
   const auto sinogramBegin = sinogram.cbegin();
   const int projectionLenght = sinogramBegin->second.size1();
   const int projectionAngles = sinogramBegin->second.size2();
@@ -180,22 +420,9 @@ JPetSinogramType::SparseMatrix JPetRecoImageTools::backProjectMatlab(const JPetS
   const int N = 2 * std::floor((double)projectionLenght / (2. * std::sqrt(2)));
   const int center =  std::floor((double)(N + 1) / 2.);
 
+  // x coordinate of pixel (i, j) is xLeft + j, y coordinate is yTop - i
   const int xLeft = -center + 1;
-
-  std::vector<std::vector<int>> x(N);
-  std::vector<int> xTmp(N);
-  std::iota(xTmp.begin(), xTmp.end(), xLeft);
-  std::fill(x.begin(), x.end(), xTmp);
-
   const int yTop = center - 1;
-  std::vector<std::vector<int>> y(N);
-  { //limit visibility of `i` variable
-    int i = 0;
-    for(auto it = y.begin(); it != y.end(); it++) {
-      *it = std::vector<int>(N, yTop - i);
-      i++;
-    }
-  }
 
   const int ctrIdx = std::ceil((double)projectionLenght / 2.);
 
@@ -206,25 +433,52 @@ JPetSinogramType::SparseMatrix JPetRecoImageTools::backProjectMatlab(const JPetS
     std::cout << "Implement This!!" << std::endl;
   }
 
-  JPetSinogramType::SparseMatrix reconstructedProjection(N, N);
-  for (const auto& tofBin : sinogram) {
-    for (int angle = 0; angle < projectionAngles; angle++)
-    {
-      const double costheta = std::cos((double)angle * angleStep);
-      const double sintheta = std::sin((double)angle * angleStep);
-      //std::cout << "cos: " << costheta << " sin: " << sintheta << " angle: " << angle * angleStep << " angle: " << angle << " anglestep: " << angleStep << std::endl;
-      for(int i = 0; i < N; i++) {
-        for(int j = 0; j < N; j++) {
-          //std::cout << "x[" << i << "][" << j << "]: " << x[i][j] << " y[" << i << "][" << j << "]" << y[i][j] << std::endl;
-          //const int t = std::round(x[i][j] * costheta + y[i][j] * sintheta); nearest neighbor
-          //reconstructedProjection(i, j) += tofBin.second(ctrIdx + t, angle);
-          const double t = (double)x[i][j] * costheta + (double)y[i][j] * sintheta;
-          const int a = std::floor(t);
-          if(ctrIdx + a + 1 < N)
-            reconstructedProjection(i, j) += (t - (double)a) * tofBin.second(ctrIdx + a + 1, angle) + ((double)(a + 1) - t) * tofBin.second(ctrIdx + a, angle);
+  std::vector<double> costheta(projectionAngles);
+  std::vector<double> sintheta(projectionAngles);
+  for (int angle = 0; angle < projectionAngles; angle++)
+  {
+    costheta[angle] = std::cos((double)angle * angleStep);
+    sintheta[angle] = std::sin((double)angle * angleStep);
+  }
+
+  JPetSinogramType::Matrix reconstructedProjection(N, N);
+  const auto backProjectRows = [&](int rowBegin, int rowEnd) {
+    for (const auto& tofBin : sinogram) {
+      for (int angle = 0; angle < projectionAngles; angle++)
+      {
+        for(int i = rowBegin; i < rowEnd; i++) {
+          double* row = reconstructedProjection.row(i);
+          const double yTerm = (double)(yTop - i) * sintheta[angle];
+          for(int j = 0; j < N; j++) {
+            //const int t = std::round(x[i][j] * costheta + y[i][j] * sintheta); nearest neighbor
+            //reconstructedProjection(i, j) += tofBin.second(ctrIdx + t, angle);
+            const double t = (double)(xLeft + j) * costheta[angle] + yTerm;
+            const int a = std::floor(t);
+            if(ctrIdx + a >= 0 && ctrIdx + a + 1 < N)
+              row[j] += (t - (double)a) * tofBin.second(ctrIdx + a + 1, angle) + ((double)(a + 1) - t) * tofBin.second(ctrIdx + a, angle);
+          }
         }
       }
     }
+  };
+
+  numberOfThreads = std::max(1, std::min(numberOfThreads, N));
+  if (numberOfThreads == 1)
+  {
+    backProjectRows(0, N);
+  }
+  else
+  {
+    const int rowsPerThread = (N + numberOfThreads - 1) / numberOfThreads;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < numberOfThreads; t++)
+    {
+      const int rowBegin = std::min(t * rowsPerThread, N);
+      const int rowEnd = std::min(rowBegin + rowsPerThread, N);
+      workers.emplace_back(backProjectRows, rowBegin, rowEnd);
+    }
+    for (auto& worker : workers)
+      worker.join();
   }
 
   for (int x = 0; x < N; x++){
@@ -246,15 +500,82 @@ double JPetRecoImageTools::FBPTOFWeight(double lor_tof_center, double lor_positi
 
 double JPetRecoImageTools::FBPWeight(double, double, double) { return 1.; }
 
-JPetSinogramType::SparseMatrix JPetRecoImageTools::backProjectWithKDE(const JPetSinogramType::SparseMatrix& sinogram, Matrix2DTOF& tof, int nAngles,
+JPetSinogramType::Matrix JPetRecoImageTools::backProjectWithKDE(const JPetSinogramType::Matrix& sinogram, Matrix2DTOF& tof, int nAngles,
                                                                       RescaleFunc rescaleFunc, int rescaleMinCutoff, int rescaleFactor)
+{
+  return backProjectWithKDE(sinogram, compressTOF(tof, sinogram.size1(), nAngles), rescaleFunc, rescaleMinCutoff, rescaleFactor);
+}
+
+TOFCompressedMatrix JPetRecoImageTools::compressTOF(const Matrix2DTOF& tof, int nDistances, int nAngles)
+{
+  TOFCompressedMatrix compressed;
+  compressed.nDistances = nDistances;
+  compressed.nAngles = nAngles;
+  compressed.offsets.assign((std::size_t)nDistances * nAngles + 1, 0);
+  for (const auto& bin : tof)
+  {
+    const int distance = bin.first.first;
+    const int angle = bin.first.second;
+    if (distance >= 0 && distance < nDistances && angle >= 0 && angle < nAngles)
+      compressed.offsets[distance * nAngles + angle + 1] = bin.second.size();
+  }
+  for (std::size_t i = 1; i < compressed.offsets.size(); i++)
+    compressed.offsets[i] += compressed.offsets[i - 1];
+  compressed.values.resize(compressed.offsets.back());
+  for (const auto& bin : tof)
+  {
+    const int distance = bin.first.first;
+    const int angle = bin.first.second;
+    if (distance >= 0 && distance < nDistances && angle >= 0 && angle < nAngles)
+      std::copy(bin.second.begin(), bin.second.end(), compressed.values.begin() + compressed.offsets[distance * nAngles + angle]);
+  }
+  return compressed;
+}
+
+namespace
+{
+/* normalDistributionProbability(x, mean, sigma) as function of |x - mean|, sampled every sigma / kSamplesPerSigma
+ * up to kSigmaRange sigma and linearly interpolated. Further from the mean it is treated as 0.
+ */
+class KDEKernelTable
+{
+public:
+  static const int kSamplesPerSigma = 100;
+  static const int kSigmaRange = 8;
+
+  explicit KDEKernelTable(double sigma) : fScale(kSamplesPerSigma / sigma), fTable(kSigmaRange * kSamplesPerSigma + 2, 0.)
+  {
+    for (int i = 0; i <= kSigmaRange * kSamplesPerSigma; i++)
+      fTable[i] = JPetRecoImageTools::normalDistributionProbability(i / fScale, 0.f, sigma);
+  }
+  double operator()(double difference) const
+  {
+    const double position = std::abs(difference) * fScale;
+    if (position >= kSigmaRange * kSamplesPerSigma)
+      return 0.;
+    const int index = position;
+    const double fraction = position - index;
+    return fTable[index] + (fTable[index + 1] - fTable[index]) * fraction;
+  }
+
+private:
+  double fScale;
+  std::vector<double> fTable;
+};
+} // namespace
+
+JPetSinogramType::Matrix JPetRecoImageTools::backProjectWithKDE(const JPetSinogramType::Matrix& sinogram, const TOFCompressedMatrix& tof,
+                                                                RescaleFunc rescaleFunc, int rescaleMinCutoff, int rescaleFactor)
 {
   int imageSize = sinogram.size1();
+  int nAngles = tof.nAngles;
+  assert(tof.nDistances == imageSize);
   double center = (double)(imageSize - 1) / 2.0;
   double center2 = center * center;
   double angleStep = M_PI / (double)nAngles;
+  const KDEKernelTable kernel(150.);
 
-  JPetSinogramType::SparseMatrix reconstructedProjection(imageSize, imageSize);
+  JPetSinogramType::Matrix reconstructedProjection(imageSize, imageSize);
 
   for (int angle = 0; angle < nAngles; angle++)
   {
@@ -275,26 +596,22 @@ JPetSinogramType::SparseMatrix JPetRecoImageTools::backProjectWithKDE(const JPet
         {
           double t = ttemp - yMinusCenter * sin;
           int n = std::floor(t + 0.5F);
-          auto tofInfo = tof.find(std::make_pair(n, angle));
-          std::vector<float> tofVector;
-          if (tofInfo != tof.end()) { tofVector = tofInfo->second; }
-          else
-          {
+          if (n < 0 || n >= imageSize || tof.size(n, angle) == 0)
             continue;
-          }
-          assert(sinogram(n, angle) == tofVector.size());
+          assert(sinogram(n, angle) == tof.size(n, angle));
           float lor_center_x = center + cos * (n - center);
           float lor_center_y = center + sin * (n - center);
           double diffBetweenLORCenterYandY = lor_center_y - y;
           double diffBetweenLORCenterXandX = lor_center_x - x;
           double distanceToCenterOfLOR =
               std::sqrt((diffBetweenLORCenterXandX * diffBetweenLORCenterXandX) + (diffBetweenLORCenterYandY * diffBetweenLORCenterYandY));
-          for (unsigned int i = 0; i < tofVector.size(); i++)
+          double sum = 0.;
+          for (const float* value = tof.begin(n, angle); value != tof.end(n, angle); value++)
           {
-            float delta = tofVector[i] * 0.299792458;
-            double distributionProbability = normalDistributionProbability(distanceToCenterOfLOR, delta, 150.);
-            reconstructedProjection(y, x) += distributionProbability * 1000;
+            const float delta = *value * 0.299792458;
+            sum += kernel(distanceToCenterOfLOR - delta);
           }
+          reconstructedProjection(y, x) += sum * 1000;
         }
       }
     }
@@ -327,58 +644,13 @@ int JPetRecoImageTools::nextPowerOf2(int n)
     return n; 
 }  
 
-JPetSinogramType::SparseMatrix JPetRecoImageTools::FilterSinogram(JPetRecoImageTools::FourierTransformFunction& ftf,
-                                                                  JPetFilterInterface& filterFunction, const JPetSinogramType::SparseMatrix& sinogram)
+JPetSinogramType::Matrix JPetRecoImageTools::FilterSinogram(JPetRecoImageTools::FourierTransformFunction& ftf,
+                                                                  JPetFilterInterface& filterFunction, const JPetSinogramType::Matrix& sinogram)
 {
   return ftf(sinogram, filterFunction);
 }
 
-JPetSinogramType::SparseMatrix JPetRecoImageTools::doFFTW1D(const JPetSinogramType::SparseMatrix& sinogram, JPetFilterInterface& filter)
+JPetSinogramType::Matrix JPetRecoImageTools::doFFTW1D(const JPetSinogramType::Matrix& sinogram, JPetFilterInterface& filter)
 {
-  assert(sinogram.size1() > 1);
-  int N = sinogram.size1();
-  int M = nextPowerOf2((2 * N));
-  int padlen = M - N;
-  int nAngles = sinogram.size2();
-  JPetSinogramType::SparseMatrix result(N, nAngles);
-  int inFTLength = ((double)M / 2.) + 1;
-  double* in = (double*)malloc(M * sizeof(double));
-  double* outDouble = (double*)malloc(M * sizeof(double));
-  fftw_complex* out = (fftw_complex*)fftw_malloc(inFTLength * sizeof(fftw_complex));
-  fftw_plan plan = fftw_plan_dft_r2c_1d(M, in, out, FFTW_MEASURE);
-  fftw_plan invPlan = fftw_plan_dft_c2r_1d(M, out, outDouble, FFTW_MEASURE);
-
-  double* inFilter = (double*)malloc(M * sizeof(double));
-  inFilter[0] = 0.25;
-  for(int i = 1; i < inFTLength; i++) {
-    if(i % 2 == 0) inFilter[i] = inFilter[M - i] = 0;
-    else inFilter[i] = inFilter[M - i] = -1./((M_PI*(double)(i)) * (M_PI*(double)(i)));
-  }
-
-  fftw_complex* outFilter = (fftw_complex*)fftw_malloc(M * sizeof(fftw_complex));
-  fftw_plan planFilter = fftw_plan_dft_r2c_1d(M, inFilter, outFilter, FFTW_MEASURE);
-  fftw_execute(planFilter);
-  for (int x = 0; x < nAngles; x++)
-  {
-    for (int y = 0; y < N; y++) { in[y] = sinogram(y ,x); }
-    for (int y = N; y < M; y++) { in[y] = 0; }
-    fftw_execute(plan);
-    for (int y = 0; y < inFTLength; y++)
-    {
-      if(y == 0) {
-        out[y][0] *= 2 * outFilter[y][0];
-        out[y][1] *= 2 * outFilter[y][0];
-      }
-      out[y][0] *= 2 * outFilter[y][0] * filter((double)(y + 1) / M);
-      out[y][1] *= 2 * outFilter[y][0] * filter((double)(y + 1) / M);
-    }
-    fftw_execute(invPlan);
-    for (int y = 0; y < N ; y++) { result(y, x) = outDouble[y] / N; }
-  }
-
-  fftw_free(out);
-  fftw_destroy_plan(plan);
-  fftw_destroy_plan(invPlan);
-  fftw_cleanup();
-  return result;
+  return JPetFFTWFilterEngine::getInstance().filter(sinogram, filter);
 }
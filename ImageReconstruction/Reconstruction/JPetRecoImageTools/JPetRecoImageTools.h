@@ -25,6 +25,7 @@
 #include <memory>
 #include <utility>
 #include <numeric>
+#include <string>
 
 #include "JPetSinogramType.h"
 
@@ -53,14 +54,31 @@ struct Point
   int y = 0;
 };
 
+/*! \brief TOF values of LORs of all sinogram bins, in compressed sparse row layout.
+ *
+ * Values of bin (distance, angle) are stored contiguously in values, from offsets[distance * nAngles + angle]
+ * to offsets[distance * nAngles + angle + 1], so they are read without hashing and copying.
+ */
+struct TOFCompressedMatrix
+{
+  int nDistances = 0;
+  int nAngles = 0;
+  std::vector<std::size_t> offsets; // nDistances * nAngles + 1 values
+  std::vector<float> values;
+
+  const float* begin(int distance, int angle) const { return values.data() + offsets[distance * nAngles + angle]; }
+  const float* end(int distance, int angle) const { return values.data() + offsets[distance * nAngles + angle + 1]; }
+  std::size_t size(int distance, int angle) const { return offsets[distance * nAngles + angle + 1] - offsets[distance * nAngles + angle]; }
+};
+
 class JPetRecoImageTools
 {
 public:
   using Matrix2DTOF = std::unordered_map<std::pair<int, int>, std::vector<float>, PairHash<int, int>>;
   using InterpolationFunc = std::function<double(int i, double y, std::function<double(int, int)>&)>;
-  using RescaleFunc = std::function<void(JPetSinogramType::SparseMatrix& v, double minCutoff, double rescaleFactor)>;
+  using RescaleFunc = std::function<void(JPetSinogramType::Matrix& v, double minCutoff, double rescaleFactor)>;
   using FourierTransformFunction =
-      std::function<JPetSinogramType::SparseMatrix(const JPetSinogramType::SparseMatrix& sinogram, JPetFilterInterface& filterFunction)>;
+      std::function<JPetSinogramType::Matrix(const JPetSinogramType::Matrix& sinogram, JPetFilterInterface& filterFunction)>;
   using FilteredBackProjectionWeightingFunction = std::function<double(double, double, double)>;
 
   /// Returns a matrixGetter, that can be used to return matrix elements in the
@@ -70,7 +88,7 @@ public:
   /// In addition if the indices goes outside of the matrix range 0 is retuned.
   /// It is assumed that the input matrix is quadratic.
   /// The produced functions can be used as an input to interpolation functions.
-  static std::function<double(int, int)> matrixGetterFactory(const JPetSinogramType::SparseMatrix& emissionMatrix, bool isTransposed = false);
+  static std::function<double(int, int)> matrixGetterFactory(const JPetSinogramType::Matrix& emissionMatrix, bool isTransposed = false);
 
   /*! \brief function returning func(i,j) where j is the nearest neighbour
    * index with respect to y.
@@ -94,9 +112,9 @@ public:
   /// 2. Removes the common backgroud term. So the values start at zero
   /// 3. Rescales all values by rescaleFactor/maxElement
   /// The final value range is from 0 to rescaleFactor
-  static void rescale(JPetSinogramType::SparseMatrix& v, double minCutoff, double rescaleFactor);
+  static void rescale(JPetSinogramType::Matrix& v, double minCutoff, double rescaleFactor);
   /// PseudoRescale which does nothing
-  static void nonRescale(JPetSinogramType::SparseMatrix&, double, double) { return; }
+  static void nonRescale(JPetSinogramType::Matrix&, double, double) { return; }
 
   /*! \brief Function image from sinogram matrix
    *  \param sinogram matrix containing sinogram to backProject
@@ -109,13 +127,16 @@ public:
    *  \param rescaleMinCutoff min value to set in rescale (Optional)
    *  \param rescaleFactor max value to set in rescale (Optional)
    */
-  static JPetSinogramType::SparseMatrix backProject(const JPetSinogramType::Matrix3D& sinogram, float sinogramAccuracy, float tofWindow,
+  static JPetSinogramType::Matrix backProject(const JPetSinogramType::Matrix3D& sinogram, float sinogramAccuracy, float tofWindow,
                                                     float lorTOFSigma, FilteredBackProjectionWeightingFunction fbpwf, RescaleFunc rescaleFunc,
                                                     int rescaleMinCutoff, int rescaleFactor);
 
-  static JPetSinogramType::SparseMatrix backProjectMatlab(const JPetSinogramType::Matrix3D& sinogram, float sinogramAccuracy, float tofWindow,
+  /*! \brief Backprojection with linear interpolation between projection bins
+   *  \param numberOfThreads number of threads sharing rows of the image (Optional, default 1)
+   */
+  static JPetSinogramType::Matrix backProjectMatlab(const JPetSinogramType::Matrix3D& sinogram, float sinogramAccuracy, float tofWindow,
                                                     float lorTOFSigma, FilteredBackProjectionWeightingFunction fbpwf, RescaleFunc rescaleFunc,
-                                                    int rescaleMinCutoff, int rescaleFactor);
+                                                    int rescaleMinCutoff, int rescaleFactor, int numberOfThreads = 1);
 
   /*! \brief Function filtering given sinogram using fouriner implementation and
    filter
@@ -123,8 +144,8 @@ public:
    *  \param filter type of filter
    *  \param sinogram data to filter
   */
-  static JPetSinogramType::SparseMatrix FilterSinogram(FourierTransformFunction& ftf, JPetFilterInterface& filter,
-                                                       const JPetSinogramType::SparseMatrix& sinogram);
+  static JPetSinogramType::Matrix FilterSinogram(FourierTransformFunction& ftf, JPetFilterInterface& filter,
+                                                       const JPetSinogramType::Matrix& sinogram);
 
   /*! \brief Function filtering given sinogram using fouriner implementation and
  filter
@@ -150,15 +171,40 @@ public:
    * default no rescaling)
    */
 
-  static JPetSinogramType::SparseMatrix backProjectWithKDE(const JPetSinogramType::SparseMatrix& sinogram, Matrix2DTOF& tof, int angles,
+  static JPetSinogramType::Matrix backProjectWithKDE(const JPetSinogramType::Matrix& sinogram, Matrix2DTOF& tof, int angles,
                                                            RescaleFunc rescaleFunc, int rescaleMinCutoff, int rescaleFactor);
+  /*! \brief Same as above, with TOF values already in compressed layout (see compressTOF).
+   * Gaussian kernel of TOF is read from table with linear interpolation, instead of calling exp for every TOF value.
+   */
+  static JPetSinogramType::Matrix backProjectWithKDE(const JPetSinogramType::Matrix& sinogram, const TOFCompressedMatrix& tof,
+                                                     RescaleFunc rescaleFunc, int rescaleMinCutoff, int rescaleFactor);
+  /// Moves TOF values of map into compressed layout with nDistances x nAngles bins, keys outside of the range are skipped
+  static TOFCompressedMatrix compressTOF(const Matrix2DTOF& tof, int nDistances, int nAngles);
 
   static double normalDistributionProbability(float x, float mean, float stddev);
 
-  /*! \brief Returns max value in given matrix
+  /// Smallest and largest value and sum of all values of the image, computed in one pass
+  struct ImageStatistics
+  {
+    double min = 0.;
+    double max = 0.;
+    double sum = 0.;
+  };
+  static ImageStatistics getStatistics(const JPetSinogramType::Matrix& matrix);
+
+  /*! \brief Returns max value in given matrix, truncated to int, not smaller than 0
    *  \param result matrix to calculate max value
    */
-  static int getMaxValue(const JPetSinogramType::SparseMatrix& result);
+  static int getMaxValue(const JPetSinogramType::Matrix& result);
+
+  /*! \brief Saves image as binary PGM (P5), with values rounded and clipped to [0, 65535]
+   *  \return false if file could not be written
+   */
+  static bool savePGM(const JPetSinogramType::Matrix& result, const std::string& outputFileName);
+  /*! \brief Saves image as NRRD with raw float values, negative values are kept
+   *  \return false if file could not be written
+   */
+  static bool saveNRRD(const JPetSinogramType::Matrix& result, const std::string& outputFileName);
 
   /*! \brief Weighting in FBP, always returns 1;
    */
@@ -173,7 +219,10 @@ public:
 
   static int nextPowerOf2(int n);
 
-  static JPetSinogramType::SparseMatrix doFFTW1D(const JPetSinogramType::SparseMatrix& sinogram, JPetFilterInterface& filter);
+  /*! \brief Ramp filtering of every angle of sinogram, plans and ramp filter are cached between calls (see JPetFFTWFilterEngine).
+   * Can be called from many threads.
+   */
+  static JPetSinogramType::Matrix doFFTW1D(const JPetSinogramType::Matrix& sinogram, JPetFilterInterface& filter);
 
 private:
   JPetRecoImageTools();
@@ -181,6 +230,18 @@ private:
   JPetRecoImageTools(const JPetRecoImageTools&) = delete;
   JPetRecoImageTools& operator=(const JPetRecoImageTools&) = delete;
 
+  /// Writes whole buffer to file with one call
+  static bool writeFile(const std::vector<char>& buffer, const std::string& outputFileName);
+
+  /// TOF backprojection with Gaussian kernel table, visiting only pixels within 3 sigma of TOF center of every TOF bin
+  static JPetSinogramType::Matrix backProjectTOF(const JPetSinogramType::Matrix3D& sinogram, float sinogramAccuracy, float tofWindow,
+                                                 float lorTOFSigma);
+
+  /// Backprojection of all TOF bins, with weighting function known at compile time
+  template <typename WeightFunction>
+  static JPetSinogramType::Matrix backProjectWithWeight(const JPetSinogramType::Matrix3D& sinogram, float sinogramAccuracy, float tofWindow,
+                                                        float lorTOFSigma, const WeightFunction& weight);
+
   static inline double setToZeroIfSmall(double value, double epsilon)
   {
     if (std::abs(value) < epsilon)
@@ -536,7 +536,7 @@ BOOST_AUTO_TEST_CASE(projection4)
 BOOST_AUTO_TEST_CASE(sinogram)
 {
   const auto inFile = "unitTestData/JPetRecoImageToolsTest/phantom.pgm";
-  const auto outFile = "sinogram.ppm";
+  const auto outFile = "sinogram.pgm";
   /// read phantom
   std::ifstream in(inFile);
   BOOST_REQUIRE(in);
@@ -580,7 +580,7 @@ BOOST_AUTO_TEST_CASE(sinogram)
 BOOST_AUTO_TEST_CASE(sinogram2)
 {
   const auto inFile = "unitTestData/JPetRecoImageToolsTest/phantom.pgm";
-  const auto outFile = "sinogram2.ppm";
+  const auto outFile = "sinogram2.pgm";
   /// read phantom
   std::ifstream in(inFile);
   BOOST_REQUIRE(in);
@@ -620,7 +620,7 @@ BOOST_AUTO_TEST_CASE(sinogram2)
 BOOST_AUTO_TEST_CASE(backProject)
 {
   const auto inFile = "unitTestData/JPetRecoImageToolsTest/phantom.pgm";
-  const auto outFile = "backproject.ppm";
+  const auto outFile = "backproject.pgm";
   /// read phantom
   std::ifstream in(inFile);
   BOOST_REQUIRE(in);
@@ -664,7 +664,7 @@ BOOST_AUTO_TEST_CASE(backProject)
 BOOST_AUTO_TEST_CASE(backProjectNone)
 {
   const auto inFile = "unitTestData/JPetRecoImageToolsTest/phantom.pgm";
-  const auto outFile = "backprojectNone.ppm";
+  const auto outFile = "backprojectNone.pgm";
   /// read phantom
   std::ifstream in(inFile);
   BOOST_REQUIRE(in);
@@ -709,7 +709,7 @@ BOOST_AUTO_TEST_CASE(backProjectNone)
 BOOST_AUTO_TEST_CASE(backProjectRamLak)
 {
   const auto inFile = "unitTestData/JPetRecoImageToolsTest/phantom.pgm";
-  const auto outFile = "backprojectRamLak.ppm";
+  const auto outFile = "backprojectRamLak.pgm";
   /// read phantom
   std::ifstream in(inFile);
   BOOST_REQUIRE(in);
@@ -754,7 +754,7 @@ BOOST_AUTO_TEST_CASE(backProjectRamLak)
 BOOST_AUTO_TEST_CASE(backProjectSheppLogan)
 {
   const auto inFile = "unitTestData/JPetRecoImageToolsTest/phantom.pgm";
-  const auto outFile = "backprojectSheppLogan.ppm";
+  const auto outFile = "backprojectSheppLogan.pgm";
   /// read phantom
   std::ifstream in(inFile);
   BOOST_REQUIRE(in);
@@ -799,7 +799,7 @@ BOOST_AUTO_TEST_CASE(backProjectSheppLogan)
 BOOST_AUTO_TEST_CASE(backProjectCosine)
 {
   const auto inFile = "unitTestData/JPetRecoImageToolsTest/phantom.pgm";
-  const auto outFile = "backprojectCosine.ppm";
+  const auto outFile = "backprojectCosine.pgm";
   /// read phantom
   std::ifstream in(inFile);
   BOOST_REQUIRE(in);
@@ -844,7 +844,7 @@ BOOST_AUTO_TEST_CASE(backProjectCosine)
 BOOST_AUTO_TEST_CASE(backProjectHamming)
 {
   const auto inFile = "unitTestData/JPetRecoImageToolsTest/phantom.pgm";
-  const auto outFile = "backprojectHamming.ppm";
+  const auto outFile = "backprojectHamming.pgm";
   /// read phantom
   std::ifstream in(inFile);
   BOOST_REQUIRE(in);
@@ -889,7 +889,7 @@ BOOST_AUTO_TEST_CASE(backProjectHamming)
 BOOST_AUTO_TEST_CASE(backProjectRidgelet)
 {
   const auto inFile = "unitTestData/JPetRecoImageToolsTest/phantom.pgm";
-  const auto outFile = "backprojectRidgelet.ppm";
+  const auto outFile = "backprojectRidgelet.pgm";
   /// read phantom
   std::ifstream in(inFile);
   BOOST_REQUIRE(in);
@@ -934,7 +934,7 @@ BOOST_AUTO_TEST_CASE(backProjectRidgelet)
 BOOST_AUTO_TEST_CASE(backProjectNoneSlow)
 {
   const auto inFile = "unitTestData/JPetRecoImageToolsTest/phantom.pgm";
-  const auto outFile = "backprojectNoneSlow.ppm";
+  const auto outFile = "backprojectNoneSlow.pgm";
   /// read phantom
   std::ifstream in(inFile);
   BOOST_REQUIRE(in);
@@ -980,7 +980,7 @@ BOOST_AUTO_TEST_CASE(backProjectNoneSlow)
 BOOST_AUTO_TEST_CASE(backProjectRamLakSlow)
 {
   const auto inFile = "unitTestData/JPetRecoImageToolsTest/phantom.pgm";
-  const auto outFile = "backprojectRamLakSlow.ppm";
+  const auto outFile = "backprojectRamLakSlow.pgm";
   /// read phantom
   std::ifstream in(inFile);
   BOOST_REQUIRE(in);
@@ -1026,7 +1026,7 @@ BOOST_AUTO_TEST_CASE(backProjectRamLakSlow)
 BOOST_AUTO_TEST_CASE(backProjectSheppLoganSlow)
 {
   const auto inFile = "unitTestData/JPetRecoImageToolsTest/phantom.pgm";
-  const auto outFile = "backprojectSheppLoganSlow.ppm";
+  const auto outFile = "backprojectSheppLoganSlow.pgm";
   /// read phantom
   std::ifstream in(inFile);
   BOOST_REQUIRE(in);
@@ -1072,7 +1072,7 @@ BOOST_AUTO_TEST_CASE(backProjectSheppLoganSlow)
 BOOST_AUTO_TEST_CASE(backProjectCosineSlow)
 {
   const auto inFile = "unitTestData/JPetRecoImageToolsTest/phantom.pgm";
-  const auto outFile = "backprojectCosineSlow.ppm";
+  const auto outFile = "backprojectCosineSlow.pgm";
   /// read phantom
   std::ifstream in(inFile);
   BOOST_REQUIRE(in);
@@ -1118,7 +1118,7 @@ BOOST_AUTO_TEST_CASE(backProjectCosineSlow)
 BOOST_AUTO_TEST_CASE(backProjectHammingSlow)
 {
   const auto inFile = "unitTestData/JPetRecoImageToolsTest/phantom.pgm";
-  const auto outFile = "backprojectHammingSlow.ppm";
+  const auto outFile = "backprojectHammingSlow.pgm";
   /// read phantom
   std::ifstream in(inFile);
   BOOST_REQUIRE(in);
@@ -1164,7 +1164,7 @@ BOOST_AUTO_TEST_CASE(backProjectHammingSlow)
 BOOST_AUTO_TEST_CASE(backProjectRidgeletSlow)
 {
   const auto inFile = "unitTestData/JPetRecoImageToolsTest/phantom.pgm";
-  const auto outFile = "backprojectRidgeletSlow.ppm";
+  const auto outFile = "backprojectRidgeletSlow.pgm";
   /// read phantom
   std::ifstream in(inFile);
   BOOST_REQUIRE(in);
@@ -1210,7 +1210,7 @@ BOOST_AUTO_TEST_CASE(backProjectRidgeletSlow)
 BOOST_AUTO_TEST_CASE(backProjectSinogramNone)
 {
   const auto inFile = "unitTestData/JPetRecoImageToolsTest/sinogramBackproject.ppm";
-  const auto outFile = "backprojectSinogramNone.ppm";
+  const auto outFile = "backprojectSinogramNone.pgm";
   /// read phantom
   std::ifstream in(inFile);
   BOOST_REQUIRE(in);
@@ -1259,7 +1259,7 @@ BOOST_AUTO_TEST_CASE(backProjectSinogramNone)
 BOOST_AUTO_TEST_CASE(backProjectSinogramRamLak)
 {
   const auto inFile = "unitTestData/JPetRecoImageToolsTest/sinogramBackproject.ppm";
-  const auto outFile = "backprojectSinogramRamLak.ppm";
+  const auto outFile = "backprojectSinogramRamLak.pgm";
   /// read phantom
   std::ifstream in(inFile);
   BOOST_REQUIRE(in);
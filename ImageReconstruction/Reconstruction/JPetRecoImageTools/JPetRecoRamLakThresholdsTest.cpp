@@ -91,7 +91,7 @@ BOOST_AUTO_TEST_CASE(backProjectSinogramRamLak)
   {
     for (double threshold = 0.01; threshold <= 1.; threshold += 0.01)
     {
-      const auto outFile = "ramlak/" + in + "RamLakT" + std::to_string(threshold) + ".ppm";
+      const auto outFile = "ramlak/" + in + "RamLakT" + std::to_string(threshold) + ".pgm";
       std::cout << "Reading file: " << test_files_path + in << " output file: " << outFile << std::endl;
       JPetRecoImageTools::SparseMatrix sinogram = readFile(test_files_path + in);
 
@@ -84,7 +84,7 @@ BOOST_AUTO_TEST_CASE(backProjectSinogramSheppLogan)
 {
   for (double threshold = 0.01; threshold <= 1.; threshold += 0.1)
   {
-    const auto outFile = "ramlak/backprojectSinogramRamLakT" + std::to_string(threshold) + ".ppm";
+    const auto outFile = "ramlak/backprojectSinogramRamLakT" + std::to_string(threshold) + ".pgm";
 
     JPetRecoImageTools::Matrix2DProj sinogram = readFile(inFile);
 
@@ -75,7 +75,7 @@ BOOST_AUTO_TEST_SUITE(FirstSuite)
 
 BOOST_AUTO_TEST_CASE(backProjectSinogramNone)
 {
-  const auto outFile = "backprojectSinogramNone.ppm";
+  const auto outFile = "backprojectSinogramNone.pgm";
 
   JPetRecoImageTools::Matrix2DProj sinogram = readFile(inFile);
 
@@ -93,7 +93,7 @@ BOOST_AUTO_TEST_CASE(backProjectSinogramNone)
 
 BOOST_AUTO_TEST_CASE(backProjectSinogramRamLak)
 {
-  const auto outFile = "backprojectSinogramRamLak.ppm";
+  const auto outFile = "backprojectSinogramRamLak.pgm";
 
   JPetRecoImageTools::Matrix2DProj sinogram = readFile(inFile);
 
@@ -111,7 +111,7 @@ BOOST_AUTO_TEST_CASE(backProjectSinogramRamLak)
 
 BOOST_AUTO_TEST_CASE(backProjectSinogramCosine)
 {
-  const auto outFile = "backprojectSinogramCosine.ppm";
+  const auto outFile = "backprojectSinogramCosine.pgm";
 
   JPetRecoImageTools::Matrix2DProj sinogram = readFile(inFile);
 
@@ -129,7 +129,7 @@ BOOST_AUTO_TEST_CASE(backProjectSinogramCosine)
 
 BOOST_AUTO_TEST_CASE(backProjectSinogramHamming)
 {
-  const auto outFile = "backprojectSinogramHamming.ppm";
+  const auto outFile = "backprojectSinogramHamming.pgm";
 
   JPetRecoImageTools::Matrix2DProj sinogram = readFile(inFile);
 
@@ -147,7 +147,7 @@ BOOST_AUTO_TEST_CASE(backProjectSinogramHamming)
 
 BOOST_AUTO_TEST_CASE(backProjectSinogramRidgelet)
 {
-  const auto outFile = "backprojectSinogramRidgelet.ppm";
+  const auto outFile = "backprojectSinogramRidgelet.pgm";
 
   JPetRecoImageTools::Matrix2DProj sinogram = readFile(inFile);
 
@@ -165,7 +165,7 @@ BOOST_AUTO_TEST_CASE(backProjectSinogramRidgelet)
 
 BOOST_AUTO_TEST_CASE(backProjectSinogramSheppLogan)
 {
-  const auto outFile = "backprojectSinogramSheppLogan.ppm";
+  const auto outFile = "backprojectSinogramSheppLogan.pgm";
 
   JPetRecoImageTools::Matrix2DProj sinogram = readFile(inFile);
 
@@ -0,0 +1,96 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file JPetSheppLoganPhantom.h
+ */
+
+#ifndef _JPET_SheppLoganPhantom_H_
+#define _JPET_SheppLoganPhantom_H_
+
+#include "JPetSinogramType.h"
+#include <cmath>
+#include <vector>
+
+/**
+ * Modified Shepp-Logan phantom (Toft) with its analytic sinogram, used by tests and benchmark of reconstructions
+ * as an input with known result.
+ */
+class JPetSheppLoganPhantom
+{
+public:
+  struct Ellipse
+  {
+    double x0;
+    double y0;
+    double a;
+    double b;
+    double phi; // in radians
+    double density;
+  };
+
+  /// Ellipses of the phantom scaled to radius in pixels
+  static std::vector<Ellipse> getSheppLogan(double radius)
+  {
+    const std::vector<Ellipse> unit = {{0., 0., 0.69, 0.92, 0., 1.},        {0., -0.0184, 0.6624, 0.874, 0., -0.8},
+                                       {0.22, 0., 0.11, 0.31, -18., -0.2},  {-0.22, 0., 0.16, 0.41, 18., -0.2},
+                                       {0., 0.35, 0.21, 0.25, 0., 0.1},     {0., 0.1, 0.046, 0.046, 0., 0.1},
+                                       {0., -0.1, 0.046, 0.046, 0., 0.1},   {-0.08, -0.605, 0.046, 0.023, 0., 0.1},
+                                       {0., -0.605, 0.023, 0.023, 0., 0.1}, {0.06, -0.605, 0.023, 0.046, 0., 0.1}};
+    std::vector<Ellipse> scaled;
+    for (const auto& e : unit)
+      scaled.push_back({e.x0 * radius, e.y0 * radius, e.a * radius, e.b * radius, e.phi * M_PI / 180., e.density});
+    return scaled;
+  }
+
+  /// Density of the phantom in point (x, y) relative to its center
+  static double getPhantomValue(const std::vector<Ellipse>& phantom, double x, double y)
+  {
+    double value = 0.;
+    for (const auto& e : phantom)
+    {
+      const double dx = x - e.x0;
+      const double dy = y - e.y0;
+      const double u = dx * std::cos(e.phi) + dy * std::sin(e.phi);
+      const double v = -dx * std::sin(e.phi) + dy * std::cos(e.phi);
+      if ((u * u) / (e.a * e.a) + (v * v) / (e.b * e.b) <= 1.)
+        value += e.density;
+    }
+    return value;
+  }
+
+  /// Analytic projections, distance bin k is distance k - ceil(projectionLength / 2) from the center, as in backProjectMatlab
+  static JPetSinogramType::Matrix getSinogram(const std::vector<Ellipse>& phantom, int projectionLength, int projectionAngles)
+  {
+    JPetSinogramType::Matrix sinogram(projectionLength, projectionAngles);
+    const int ctrIdx = std::ceil(projectionLength / 2.);
+    for (int angle = 0; angle < projectionAngles; angle++)
+    {
+      const double theta = angle * M_PI / projectionAngles;
+      for (const auto& e : phantom)
+      {
+        const double c = std::cos(theta - e.phi);
+        const double s = std::sin(theta - e.phi);
+        const double a2 = e.a * e.a * c * c + e.b * e.b * s * s;
+        const double shift = e.x0 * std::cos(theta) + e.y0 * std::sin(theta);
+        for (int k = 0; k < projectionLength; k++)
+        {
+          const double t = (k - ctrIdx) - shift;
+          if (t * t < a2)
+            sinogram(k, angle) += 2. * e.density * e.a * e.b * std::sqrt(a2 - t * t) / a2;
+        }
+      }
+    }
+    return sinogram;
+  }
+};
+
+#endif /*  !_JPET_SheppLoganPhantom_H_ */
@@ -14,7 +14,103 @@
  */
 
 #include "JPetSinogramType.h"
+#include <algorithm>
+#include <cmath>
 
 ClassImp(JPetSinogramType);
 
+namespace
+{
+/* Binning parameters are float values calculated from user options, they are compared with small relative tolerance,
+ * so the same options give the same binning regardless of how the values were saved.
+ */
+bool isSameParameter(float first, float second, const std::string& name)
+{
+  const float kRelativeTolerance = 1e-5f;
+  if (std::abs(first - second) <= kRelativeTolerance * std::max(1.f, std::max(std::abs(first), std::abs(second))))
+    return true;
+  WARNING("Sinograms have different " + name + ": " + std::to_string(first) + " and " + std::to_string(second));
+  return false;
+}
+} // namespace
+
 JPetSinogramType::~JPetSinogramType() {}
+
+JPetSinogramType::WholeSinogram JPetSinogramType::convertLegacySinogram(const LegacyWholeSinogram& legacy)
+{
+  WholeSinogram result(legacy.size(), Matrix3D());
+  for (unsigned int slice = 0; slice < legacy.size(); slice++)
+  {
+    for (const auto& tofWindow : legacy[slice])
+    {
+      const auto& sparse = tofWindow.second;
+      Matrix dense(sparse.size1(), sparse.size2());
+      for (auto row = sparse.begin1(); row != sparse.end1(); ++row)
+      {
+        for (auto element = row.begin(); element != row.end(); ++element) { dense(element.index1(), element.index2()) = *element; }
+      }
+      result[slice].insert({tofWindow.first, dense});
+    }
+  }
+  return result;
+}
+
+bool JPetSinogramType::hasSameBinning(const JPetSinogramType& other) const
+{
+  if (fZSplitNumber != other.fZSplitNumber || fMaxDistanceNumber != other.fMaxDistanceNumber)
+  {
+    WARNING("Sinograms have different number of slices (" + std::to_string(fZSplitNumber) + " and " + std::to_string(other.fZSplitNumber) +
+            ") or distances (" + std::to_string(fMaxDistanceNumber) + " and " + std::to_string(other.fMaxDistanceNumber) + ")");
+    return false;
+  }
+  if (!isSameParameter(fMaxReconstructionLayerRadius, other.fMaxReconstructionLayerRadius, "reconstruction layer radius") ||
+      !isSameParameter(fReconstructionDistanceAccuracy, other.fReconstructionDistanceAccuracy, "reconstruction distance accuracy") ||
+      !isSameParameter(fScintillatorLenght, other.fScintillatorLenght, "scintillator lenght") ||
+      !isSameParameter(fTOFWindowSize, other.fTOFWindowSize, "TOF window size"))
+    return false;
+  if (fZSplitRange.size() != other.fZSplitRange.size())
+  {
+    WARNING("Sinograms have different number of z ranges");
+    return false;
+  }
+  for (unsigned int i = 0; i < fZSplitRange.size(); i++)
+  {
+    if (!isSameParameter(fZSplitRange[i].first, other.fZSplitRange[i].first, "begin of z range " + std::to_string(i)) ||
+        !isSameParameter(fZSplitRange[i].second, other.fZSplitRange[i].second, "end of z range " + std::to_string(i)))
+      return false;
+  }
+  return true;
+}
+
+bool JPetSinogramType::add(const JPetSinogramType& other)
+{
+  if (!hasSameBinning(other) || fSinogramType.size() != other.fSinogramType.size())
+    return false;
+  for (unsigned int slice = 0; slice < fSinogramType.size(); slice++)
+  {
+    for (const auto& tofWindow : other.fSinogramType[slice])
+    {
+      const auto data = fSinogramType[slice].find(tofWindow.first);
+      if (data != fSinogramType[slice].end() &&
+          (data->second.size1() != tofWindow.second.size1() || data->second.size2() != tofWindow.second.size2()))
+      {
+        WARNING("Sinograms have different sizes of matrices in slice " + std::to_string(slice) + ", TOF window " + std::to_string(tofWindow.first));
+        return false;
+      }
+    }
+  }
+  for (unsigned int slice = 0; slice < fSinogramType.size(); slice++)
+  {
+    for (const auto& tofWindow : other.fSinogramType[slice])
+    {
+      auto data = fSinogramType[slice].find(tofWindow.first);
+      if (data != fSinogramType[slice].end())
+        data->second += tofWindow.second;
+      else
+        fSinogramType[slice].insert(tofWindow);
+    }
+  }
+  fNumberOfAllEvents += other.fNumberOfAllEvents;
+  fNumberOfEventsUsedToCreateSinogram += other.fNumberOfEventsUsedToCreateSinogram;
+  return true;
+}
@@ -27,16 +27,20 @@
 #include <vector>
 #endif
 
-
+#include "JPetDenseMatrix.h"
 #include "JPetWriter/JPetWriter.h"
 
 class JPetSinogramType : public TObject
 {
 public:
-  using SparseMatrix = boost::numeric::ublas::mapped_matrix<double>;
-  using Matrix3D = std::unordered_map<int, SparseMatrix>;
+  using Matrix = JPetDenseMatrix<double>;
+  using Matrix3D = std::unordered_map<int, Matrix>;
   using WholeSinogram = std::vector<Matrix3D>; // slice number, tof window, sinogram matrix
 
+  /// Sinogram types stored in files written before version 5 of this class
+  using LegacySparseMatrix = boost::numeric::ublas::mapped_matrix<double>;
+  using LegacyWholeSinogram = std::vector<std::unordered_map<int, LegacySparseMatrix>>;
+
   JPetSinogramType() : fName("test") {}
   explicit JPetSinogramType(std::string name, unsigned int zSplitNumber, unsigned int maxDistanceNumber, float maxReconstructionLayerRadius,
                             float reconstructionDistanceAccuracy, float scintillatorLenght, float TOFWindowSize,
@@ -77,7 +81,7 @@ public:
     return map;
   }
 
-  void addSlice(const SparseMatrix object, const int sliceNumber,
+  void addSlice(const Matrix object, const int sliceNumber,
                 const int tofWindow = 0) // copy object to make sure we do not assign temporary object
   {
     fSinogramType[sliceNumber].insert({tofWindow, object});
@@ -93,24 +97,41 @@ public:
     return fSinogramType;
   }
 
-  void setNumberOfAllEvents(unsigned int numberOfAllEvents) { fNumberOfAllEvents = numberOfAllEvents; }
+  const WholeSinogram& getSinogram() const { return fSinogramType; }
+
+  void setNumberOfAllEvents(unsigned long long numberOfAllEvents) { fNumberOfAllEvents = numberOfAllEvents; }
 
-  void setNumberOfEventsUsedToCreateSinogram(unsigned int numberOfEventsUsedToCreateSinogram)
+  void setNumberOfEventsUsedToCreateSinogram(unsigned long long numberOfEventsUsedToCreateSinogram)
   {
     fNumberOfEventsUsedToCreateSinogram = numberOfEventsUsedToCreateSinogram;
   }
 
+  /* @brief Converts sinogram from the old sparse format to dense matrices.
+   * Used by ROOT schema evolution rule, so Sinogram objects from older files are read transparently.
+   */
+  static WholeSinogram convertLegacySinogram(const LegacyWholeSinogram& legacy);
+
+  /* @brief Checks if other sinogram has the same binning: numbers of slices and distances, reconstruction layer radius,
+   * distance accuracy, scintillator length, TOF window size and z ranges of slices. Only such sinograms can be added.
+   */
+  bool hasSameBinning(const JPetSinogramType& other) const;
+
+  /* @brief Adds counts and numbers of events of other sinogram with the same binning, TOF windows missing
+   * in this sinogram are copied. If binning is different, returns false and this sinogram is not changed.
+   */
+  bool add(const JPetSinogramType& other);
+
   unsigned int getZSplitNumber() const { return fZSplitNumber; }
   unsigned int getMaxDistanceNumber() const { return fMaxDistanceNumber; }
-  unsigned int getNumberOfAllEvents() const { return fNumberOfAllEvents; }
-  unsigned int getNumberOfEventsUsedToCreateSinogram() const { return fNumberOfEventsUsedToCreateSinogram; }
+  unsigned long long getNumberOfAllEvents() const { return fNumberOfAllEvents; }
+  unsigned long long getNumberOfEventsUsedToCreateSinogram() const { return fNumberOfEventsUsedToCreateSinogram; }
   float getMaxReconstructionLayerRadius() const { return fMaxReconstructionLayerRadius; }
   float getReconstructionDistanceAccuracy() const { return fReconstructionDistanceAccuracy; }
   float getScintillatorLenght() const { return fScintillatorLenght; }
   float getTOFWindowSize() const { return fTOFWindowSize; }
   std::vector<std::pair<float, float>> getZSplitRange() const { return fZSplitRange; }
 
-  ClassDef(JPetSinogramType, 4);
+  ClassDef(JPetSinogramType, 6);
 
 private:
   std::string fName;           // name to save in root file.
@@ -118,8 +139,8 @@ private:
 
   unsigned int fZSplitNumber;
   unsigned int fMaxDistanceNumber;
-  unsigned int fNumberOfAllEvents;
-  unsigned int fNumberOfEventsUsedToCreateSinogram;
+  unsigned long long fNumberOfAllEvents = 0;
+  unsigned long long fNumberOfEventsUsedToCreateSinogram = 0;
   float fMaxReconstructionLayerRadius;
   float fReconstructionDistanceAccuracy;
   float fScintillatorLenght;
@@ -0,0 +1,263 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file JPetRecoImageToolsBenchmark.cpp
+ */
+
+#include "JPetFilterNone.h"
+#include "JPetRecoImageTools.h"
+#include "JPetSheppLoganPhantom.h"
+#include "JPetSinogramType.h"
+#include <sys/resource.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * Measures time of JPetRecoImageTools kernels on synthetic Shepp-Logan sinograms and prints results as JSON,
+ * so they can be compared between releases. Every kernel is run given number of times, minimal and mean time
+ * are reported, throughput is computed from the minimal time. Peak RSS is the peak of the whole process
+ * at the moment the kernel finished, so it only grows from one result to the next.
+ *
+ * Usage: recoImageToolsBenchmark.x [--repetitions N] [--threads N] [--case bins,angles,tofBins]... [--output file]
+ * When no case is given, default set of cases from 128 to 1024 bins, 180 to 720 angles and 1 to 50 TOF bins is used.
+ */
+
+namespace
+{
+struct BenchmarkCase
+{
+  int bins;
+  int angles;
+  int tofBins;
+};
+
+const float kSinogramAccuracy = 0.1f; // cm per bin, default of SinogramCreator
+const float kTOFWindow = 100.f;       // ps, default of SinogramCreator
+const float kLORTOFSigma = 150.f;     // ps, default of ReconstructionTask
+
+/// Analytic projections of the Shepp-Logan phantom, distance bin k is at k - ceil(bins / 2) from the center
+JPetSinogramType::Matrix getSinogram(int bins, int angles)
+{
+  // phantom fits in the image of backProjectMatlab, which has bins / sqrt(2) pixels
+  return JPetSheppLoganPhantom::getSinogram(JPetSheppLoganPhantom::getSheppLogan(0.9 * bins / (2. * std::sqrt(2.))), bins, angles);
+}
+
+/// Splits sinogram into TOF bins with keys centered around 0, weighted by Gaussian over the keys
+JPetSinogramType::Matrix3D getTOFSinogram(const JPetSinogramType::Matrix& sinogram, int tofBins)
+{
+  JPetSinogramType::Matrix3D tofSinogram;
+  const double width = std::max(1., tofBins / 4.);
+  std::vector<double> weights(tofBins);
+  for (int t = 0; t < tofBins; t++)
+  {
+    const double key = t - tofBins / 2;
+    weights[t] = std::exp(-key * key / (2. * width * width));
+  }
+  double weightsSum = 0.;
+  for (double weight : weights)
+    weightsSum += weight;
+  for (int t = 0; t < tofBins; t++)
+  {
+    JPetSinogramType::Matrix bin = sinogram;
+    bin *= weights[t] / weightsSum;
+    tofSinogram[t - tofBins / 2] = bin;
+  }
+  return tofSinogram;
+}
+
+/// Input of backProjectWithKDE: every LOR crossing the phantom has tofSamples TOF values, sinogram holds their number
+void getKDEInput(const JPetSinogramType::Matrix& sinogram, int tofSamples, JPetSinogramType::Matrix& counts, JPetRecoImageTools::Matrix2DTOF& tof)
+{
+  counts = JPetSinogramType::Matrix(sinogram.size1(), sinogram.size2());
+  std::uint32_t state = 12345;
+  const double maxTOF = sinogram.size1() / 2. / 0.299792458;
+  for (unsigned int distance = 0; distance < sinogram.size1(); distance++)
+  {
+    for (unsigned int angle = 0; angle < sinogram.size2(); angle++)
+    {
+      if (sinogram(distance, angle) <= 0.)
+        continue;
+      std::vector<float>& values = tof[std::make_pair(distance, angle)];
+      for (int i = 0; i < tofSamples; i++)
+      {
+        state = state * 1664525u + 1013904223u;
+        values.push_back((2. * state / 4294967296. - 1.) * maxTOF);
+      }
+      counts(distance, angle) = tofSamples;
+    }
+  }
+}
+
+long getPeakRSSKiB()
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return -1;
+  return usage.ru_maxrss; // kilobytes on Linux
+}
+
+class BenchmarkReport
+{
+public:
+  explicit BenchmarkReport(int repetitions) : fRepetitions(repetitions) {}
+
+  /// Runs kernel fRepetitions times, work is number of elementary operations of one run, used for throughput
+  void run(const std::string& kernel, const BenchmarkCase& benchmarkCase, int imageSize, double work, const std::string& unit,
+           const std::function<void()>& function)
+  {
+    // kernels print messages to std::cout, they are moved to std::cerr so that JSON written to std::cout stays valid
+    std::streambuf* coutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+    double minSeconds = 0.;
+    double sumSeconds = 0.;
+    for (int i = 0; i < fRepetitions; i++)
+    {
+      const auto begin = std::chrono::steady_clock::now();
+      function();
+      const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+      minSeconds = i == 0 ? seconds : std::min(minSeconds, seconds);
+      sumSeconds += seconds;
+    }
+    std::cout.rdbuf(coutBuffer);
+    std::ostringstream result;
+    result << "    {\"kernel\": \"" << kernel << "\", \"bins\": " << benchmarkCase.bins << ", \"angles\": " << benchmarkCase.angles
+           << ", \"tofBins\": " << benchmarkCase.tofBins << ", \"imageSize\": " << imageSize << ", \"minSeconds\": " << minSeconds
+           << ", \"meanSeconds\": " << sumSeconds / fRepetitions << ", \"throughput\": " << (minSeconds > 0. ? work / minSeconds : 0.)
+           << ", \"throughputUnit\": \"" << unit << "\", \"peakRSSKiB\": " << getPeakRSSKiB() << "}";
+    fResults.push_back(result.str());
+    std::cerr << kernel << " " << benchmarkCase.bins << "x" << benchmarkCase.angles << "x" << benchmarkCase.tofBins << ": " << minSeconds << " s"
+              << std::endl;
+  }
+
+  void write(std::ostream& out, int threads) const
+  {
+    out << "{\n  \"benchmark\": \"JPetRecoImageTools\",\n  \"repetitions\": " << fRepetitions << ",\n  \"threads\": " << threads
+        << ",\n  \"results\": [\n";
+    for (std::size_t i = 0; i < fResults.size(); i++)
+      out << fResults[i] << (i + 1 < fResults.size() ? ",\n" : "\n");
+    out << "  ],\n  \"peakRSSKiB\": " << getPeakRSSKiB() << "\n}" << std::endl;
+  }
+
+private:
+  int fRepetitions;
+  std::vector<std::string> fResults;
+};
+
+bool parseCase(const std::string& text, BenchmarkCase& benchmarkCase)
+{
+  char separator1 = 0;
+  char separator2 = 0;
+  std::istringstream in(text);
+  return (in >> benchmarkCase.bins >> separator1 >> benchmarkCase.angles >> separator2 >> benchmarkCase.tofBins) && separator1 == ',' &&
+         separator2 == ',' && benchmarkCase.bins > 1 && benchmarkCase.angles > 0 && benchmarkCase.tofBins > 0;
+}
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+  int repetitions = 3;
+  int threads = 1;
+  std::string outputFileName;
+  std::vector<BenchmarkCase> cases;
+  for (int i = 1; i < argc; i++)
+  {
+    const std::string argument = argv[i];
+    if (i + 1 < argc && argument == "--repetitions")
+    {
+      repetitions = std::max(1, std::atoi(argv[++i]));
+    }
+    else if (i + 1 < argc && argument == "--threads")
+    {
+      threads = std::max(1, std::atoi(argv[++i]));
+    }
+    else if (i + 1 < argc && argument == "--output")
+    {
+      outputFileName = argv[++i];
+    }
+    else if (i + 1 < argc && argument == "--case")
+    {
+      BenchmarkCase benchmarkCase;
+      if (!parseCase(argv[++i], benchmarkCase))
+      {
+        std::cerr << "Wrong case: " << argv[i] << ", expected bins,angles,tofBins" << std::endl;
+        return 1;
+      }
+      cases.push_back(benchmarkCase);
+    }
+    else
+    {
+      std::cerr << "Usage: " << argv[0] << " [--repetitions N] [--threads N] [--case bins,angles,tofBins]... [--output file]" << std::endl;
+      return 1;
+    }
+  }
+  if (cases.empty())
+    cases = {{128, 180, 1}, {128, 180, 10}, {256, 360, 1}, {256, 360, 10}, {256, 180, 50}, {512, 360, 1}, {512, 720, 10}, {1024, 720, 1}};
+
+  BenchmarkReport report(repetitions);
+  for (const auto& benchmarkCase : cases)
+  {
+    const JPetSinogramType::Matrix sinogram = getSinogram(benchmarkCase.bins, benchmarkCase.angles);
+    const JPetSinogramType::Matrix3D tofSinogram = getTOFSinogram(sinogram, benchmarkCase.tofBins);
+    const double samples = (double)benchmarkCase.bins * benchmarkCase.angles * benchmarkCase.tofBins;
+
+    JPetSinogramType::Matrix3D filtered;
+    JPetFilterNone filter;
+    report.run("doFFTW1D", benchmarkCase, 0, samples, "samples/s", [&]() {
+      for (const auto& tofBin : tofSinogram)
+        filtered[tofBin.first] = JPetRecoImageTools::doFFTW1D(tofBin.second, filter);
+    });
+
+    const int matlabImageSize = 2 * std::floor(benchmarkCase.bins / (2. * std::sqrt(2.)));
+    report.run("backProjectMatlab", benchmarkCase, matlabImageSize, (double)matlabImageSize * matlabImageSize * benchmarkCase.angles,
+               "pixel updates/s", [&]() {
+                 JPetRecoImageTools::backProjectMatlab(filtered, kSinogramAccuracy, kTOFWindow, kLORTOFSigma, JPetRecoImageTools::FBPWeight,
+                                                       JPetRecoImageTools::nonRescale, 0, 10000, threads);
+               });
+
+    const double imagePixels = (double)benchmarkCase.bins * benchmarkCase.bins;
+    report.run("backProject", benchmarkCase, benchmarkCase.bins, imagePixels * benchmarkCase.angles * benchmarkCase.tofBins, "pixel updates/s",
+               [&]() {
+                 JPetRecoImageTools::backProject(filtered, kSinogramAccuracy, kTOFWindow, kLORTOFSigma, JPetRecoImageTools::FBPTOFWeight,
+                                                 JPetRecoImageTools::nonRescale, 0, 10000);
+               });
+
+    // for KDE number of TOF bins is used as number of TOF values of every LOR
+    JPetSinogramType::Matrix counts;
+    JPetRecoImageTools::Matrix2DTOF tof;
+    getKDEInput(sinogram, benchmarkCase.tofBins, counts, tof);
+    report.run("backProjectWithKDE", benchmarkCase, benchmarkCase.bins, imagePixels * benchmarkCase.angles * benchmarkCase.tofBins,
+               "kernel evaluations/s",
+               [&]() { JPetRecoImageTools::backProjectWithKDE(counts, tof, benchmarkCase.angles, JPetRecoImageTools::nonRescale, 0, 10000); });
+  }
+
+  if (outputFileName.empty())
+  {
+    report.write(std::cout, threads);
+    return 0;
+  }
+  std::ofstream out(outputFileName);
+  report.write(out, threads);
+  if (!out)
+  {
+    std::cerr << "Could not write results to file: " << outputFileName << std::endl;
+    return 1;
+  }
+  return 0;
+}
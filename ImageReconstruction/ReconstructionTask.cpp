@@ -14,6 +14,10 @@
  */
 
 #include "ReconstructionTask.h"
+#include "JPetFFTWFilterEngine.h"
+#include <atomic>
+#include <memory>
+#include <thread>
 
 using namespace jpet_options_tools;
 
@@ -30,56 +34,35 @@ bool ReconstructionTask::init()
   {
     return false;
   }
+  if (!fFFTWWisdomFileName.empty() && std::ifstream(fFFTWWisdomFileName).good())
+  {
+    JPetFFTWFilterEngine::getInstance().importWisdom(fFFTWWisdomFileName);
+  }
   return true;
 }
 
 bool ReconstructionTask::exec() { return true; }
 
-int ReconstructionTask::getMaxValue(const JPetSinogramType::SparseMatrix& result)
+void ReconstructionTask::saveResult(const JPetSinogramType::Matrix& result, const std::string& outputFileName)
 {
-  int maxValue = 0;
-  for (unsigned int i = 0; i < result.size1(); i++)
-  {
-    for (unsigned int j = 0; j < result.size2(); j++)
-    {
-      if (static_cast<int>(result(i, j)) > maxValue)
-        maxValue = static_cast<int>(result(i, j));
-    }
-  }
-  return maxValue;
-}
-
-void ReconstructionTask::saveResult(const JPetSinogramType::SparseMatrix& result, const std::string& outputFileName)
-{
-  int maxValue = getMaxValue(result);
-  std::ofstream res(outputFileName);
-  res << "P2" << std::endl;
-  res << result.size2() << " " << result.size1() << std::endl;
-  res << maxValue << std::endl;
-  for (unsigned int i = 0; i < result.size1(); i++)
-  {
-    for (unsigned int j = 0; j < result.size2(); j++)
-    {
-      int resultInt = std::round(result(i, j));
-      if (resultInt < 0)
-      {
-        resultInt = 0;
-      }
-      res << resultInt << " ";
-    }
-    res << std::endl;
-  }
-  res.close();
+  if (fOutputFormat == "NRRD")
+    JPetRecoImageTools::saveNRRD(result, outputFileName + ".nrrd");
+  else
+    JPetRecoImageTools::savePGM(result, outputFileName + ".pgm");
 }
 
 bool ReconstructionTask::terminate()
 {
-  JPetRecoImageTools::FourierTransformFunction f = JPetRecoImageTools::doFFTW1D;
   const auto& sinogram = fSinogram->getSinogram();
   unsigned int zSplitNumber = fSinogram->getZSplitNumber();
   static std::map<std::string, int> reconstructionNameToWeight{{"FBP", ReconstructionTask::kWeightingType::kFBP},
-                                                               {"TOFFBP", ReconstructionTask::kWeightingType::kTOFFBP}};
+                                                               {"TOFFBP", ReconstructionTask::kWeightingType::kTOFFBP},
+                                                               {"DirectFourier", ReconstructionTask::kWeightingType::kDirectFourier},
+                                                               {"OSEM", ReconstructionTask::kWeightingType::kOSEM}};
   JPetRecoImageTools::FilteredBackProjectionWeightingFunction weightFunction;
+  bool directFourier = false;
+  bool osem = false;
+  bool tofBackProjection = false;
 
   switch (reconstructionNameToWeight[fReconstructionName])
   {
@@ -88,6 +71,13 @@ bool ReconstructionTask::terminate()
     break;
   case ReconstructionTask::kWeightingType::kTOFFBP:
     weightFunction = JPetRecoImageTools::FBPTOFWeight;
+    tofBackProjection = true;
+    break;
+  case ReconstructionTask::kWeightingType::kDirectFourier:
+    directFourier = true;
+    break;
+  case ReconstructionTask::kWeightingType::kOSEM:
+    osem = true;
     break;
   default:
     ERROR("Could not find reconstruction name: " + fReconstructionName + ", using FBP.");
@@ -95,68 +85,148 @@ bool ReconstructionTask::terminate()
     break;
   }
 
+  static const std::map<std::string, ReconstructionTask::kFilterType> filterNameToFilter{
+      {"None", ReconstructionTask::kFilterType::kFilterNone},           {"Cosine", ReconstructionTask::kFilterType::kFilterCosine},
+      {"Hamming", ReconstructionTask::kFilterType::kFilterHamming},     {"Hann", ReconstructionTask::kFilterType::kFilterHann},
+      {"Ridgelet", ReconstructionTask::kFilterType::kFilterRidgelet}, {"SheppLogan", ReconstructionTask::kFilterType::kFilterSheppLogan}};
+  ReconstructionTask::kFilterType filterType = ReconstructionTask::kFilterType::kFilterNotFound;
+  const auto filterIt = filterNameToFilter.find(fFilterName);
+  if (filterIt != filterNameToFilter.end())
+    filterType = filterIt->second;
+  else
+    ERROR("Could not find filter: " + fFilterName + ", using JPetFilterNone.");
+
+  std::vector<float> cutOffValues;
+  for (float cutOffValue = fCutOffValueBegin; cutOffValue <= fCutOffValueEnd; cutOffValue += fCutOffValueStep)
+    cutOffValues.push_back(cutOffValue);
+
+  std::vector<unsigned int> zSlices;
   for (unsigned int i = 0; i < zSplitNumber; i++)
   { // loop throught Z slices
     int sliceNumber = i - (zSplitNumber / 2);
     if (!fReconstructSliceNumbers.empty()) // if there we want to reconstruct only selected z slices, skip others
       if (std::find(fReconstructSliceNumbers.begin(), fReconstructSliceNumbers.end(), sliceNumber) == fReconstructSliceNumbers.end())
         continue;
-    for (float cutOffValue = fCutOffValueBegin; cutOffValue <= fCutOffValueEnd; cutOffValue += fCutOffValueStep)
+    zSlices.push_back(i);
+  }
+
+  // z slices are independent, they are shared between workers and the rest of threads splits rows of the image
+  const int jobWorkers = std::max(1, std::min<int>(fNumberOfThreads, zSlices.size()));
+  const int backProjectionThreads = std::max(1, fNumberOfThreads / jobWorkers);
+  std::atomic<std::size_t> nextJob(0);
+  const auto reconstruct = [&]() {
+    for (std::size_t job = nextJob++; job < zSlices.size(); job = nextJob++)
     {
-      JPetFilterInterface* filter;
-      static std::map<std::string, int> filterNameToFilter{{"None", ReconstructionTask::kFilterType::kFilterNone},
-                                                           {"Cosine", ReconstructionTask::kFilterType::kFilterCosine},
-                                                           {"Hamming", ReconstructionTask::kFilterType::kFilterHamming},
-                                                           {"Hann", ReconstructionTask::kFilterType::kFilterHann},
-                                                           {"Ridgelet", ReconstructionTask::kFilterType::kFilterRidgelet},
-                                                           {"SheppLogan", ReconstructionTask::kFilterType::kFilterSheppLogan}};
-
-      switch (filterNameToFilter[fFilterName])
+      const unsigned int i = zSlices[job];
+      const int sliceNumber = i - (zSplitNumber / 2);
+
+      if (osem)
+      {
+        // slice without TOF windows gives zero image, its size depends only on the number of distances
+        const int projectionAngles = sinogram[i].empty() ? 1 : sinogram[i].cbegin()->second.size2();
+        JPetOSEMReconstruction reconstruction(fSinogram->getMaxDistanceNumber(), projectionAngles);
+        reconstruction.setNumberOfSubsets(fOSEMSubsets);
+        reconstruction.setNumberOfThreads(backProjectionThreads);
+        const auto save = [&](int iteration, const JPetSinogramType::Matrix& image) {
+          JPetSinogramType::Matrix rescaled = image;
+          JPetRecoImageTools::rescale(rescaled, 0, 10000);
+          saveResult(rescaled, fOutFileName + "reconstruction_with_" + fReconstructionName + "_iteration_" + std::to_string(iteration) +
+                                   "_slicenumber_" + std::to_string(sliceNumber));
+        };
+        // image after the last iteration is always saved, checkpoints only every fOSEMCheckpointEvery iterations before it
+        const JPetSinogramType::Matrix result =
+            reconstruction.reconstruct(sinogram[i], fOSEMIterations, [&](int iteration, const JPetSinogramType::Matrix& image) {
+              if (fOSEMCheckpointEvery > 0 && iteration < fOSEMIterations && iteration % fOSEMCheckpointEvery == 0)
+                save(iteration, image);
+            });
+        save(fOSEMIterations, result);
+        continue;
+      }
+
+      if (directFourier)
       {
-      case ReconstructionTask::kFilterType::kFilterNone:
-        filter = new JPetFilterNone(cutOffValue);
-        break;
-      case ReconstructionTask::kFilterType::kFilterCosine:
-        filter = new JPetFilterCosine(cutOffValue);
-        break;
-      case ReconstructionTask::kFilterType::kFilterHamming:
-        filter = new JPetFilterHamming(cutOffValue);
-        break;
-      case ReconstructionTask::kFilterType::kFilterHann:
-        filter = new JPetFilterHann(cutOffValue);
-        break;
-      case ReconstructionTask::kFilterType::kFilterRidgelet:
-        filter = new JPetFilterRidgelet(cutOffValue);
-        break;
-      case ReconstructionTask::kFilterType::kFilterSheppLogan:
-        filter = new JPetFilterSheppLogan(cutOffValue);
-        break;
-      default:
-        ERROR("Could not find filter: " + fFilterName + ", using JPetFilterNone.");
-        filter = new JPetFilterNone(cutOffValue);
-        break;
+        for (float cutOffValue : cutOffValues)
+        {
+          std::unique_ptr<JPetFilterInterface> filter(createFilter(filterType, cutOffValue));
+          JPetSinogramType::Matrix result = JPetDirectFourierReconstruction::reconstruct(sinogram[i], *filter);
+          JPetRecoImageTools::rescale(result, 0, 10000);
+          saveResult(result, fOutFileName + "reconstruction_with_" + fReconstructionName + "_" + fFilterName + "_CutOff_" +
+                             std::to_string(cutOffValue) + "_slicenumber_" + std::to_string(sliceNumber));
+        }
+        continue;
       }
 
-      JPetSinogramType::Matrix3D filtered;
-      int tofID = 0;
-      for (auto& tofWindow : sinogram[i]) // filter sinogram in each TOF-windows(for FBP in single timewindow)
+      // forward transform of each TOF window is done once, only filter and inverse transform are repeated for every cut-off value
+      std::map<int, JPetFFTWFilterEngine::SinogramSpectrum> spectra;
+      for (auto& tofWindow : sinogram[i])
       {
-        filtered[tofWindow.first] = JPetRecoImageTools::FilterSinogram(f, *filter, tofWindow.second);
-        tofID++;
+        spectra[tofWindow.first] = JPetFFTWFilterEngine::getInstance().transform(tofWindow.second);
       }
 
-      JPetSinogramType::SparseMatrix result =
-          JPetRecoImageTools::backProjectMatlab(filtered, fSinogram->getReconstructionDistanceAccuracy(), fSinogram->getTOFWindowSize(), fLORTOFSigma,
-                                          weightFunction, JPetRecoImageTools::rescale, 0, 10000);
+      for (float cutOffValue : cutOffValues)
+      {
+        std::unique_ptr<JPetFilterInterface> filter(createFilter(filterType, cutOffValue));
+
+        JPetSinogramType::Matrix3D filtered;
+        for (auto& tofWindow : spectra) // filter sinogram in each TOF-windows(for FBP in single timewindow)
+        {
+          filtered[tofWindow.first] = JPetFFTWFilterEngine::getInstance().filter(tofWindow.second, *filter);
+        }
+
+        // TOF bins are weighted only by backProject, backProjectMatlab sums them with equal weights
+        JPetSinogramType::Matrix result =
+            tofBackProjection
+                ? JPetRecoImageTools::backProject(filtered, fSinogram->getReconstructionDistanceAccuracy(), fSinogram->getTOFWindowSize(),
+                                                  fLORTOFSigma, weightFunction, JPetRecoImageTools::rescale, 0, 10000)
+                : JPetRecoImageTools::backProjectMatlab(filtered, fSinogram->getReconstructionDistanceAccuracy(), fSinogram->getTOFWindowSize(),
+                                                        fLORTOFSigma, weightFunction, JPetRecoImageTools::rescale, 0, 10000,
+                                                        backProjectionThreads);
 
-      saveResult(result, fOutFileName + "reconstruction_with_" + fReconstructionName + "_" + fFilterName + "_CutOff_" + std::to_string(cutOffValue) +
-                             "_slicenumber_" + std::to_string(sliceNumber) + ".ppm");
-      delete filter;
+        saveResult(result, fOutFileName + "reconstruction_with_" + fReconstructionName + "_" + fFilterName + "_CutOff_" +
+                               std::to_string(cutOffValue) + "_slicenumber_" + std::to_string(sliceNumber));
+      }
     }
+  };
+
+  if (jobWorkers == 1)
+  {
+    reconstruct();
+  }
+  else
+  {
+    std::vector<std::thread> workers;
+    for (int t = 0; t < jobWorkers; t++)
+      workers.emplace_back(reconstruct);
+    for (auto& worker : workers)
+      worker.join();
+  }
+
+  if (!fFFTWWisdomFileName.empty())
+  {
+    JPetFFTWFilterEngine::getInstance().exportWisdom(fFFTWWisdomFileName);
   }
   return true;
 }
 
+JPetFilterInterface* ReconstructionTask::createFilter(kFilterType filterType, float cutOffValue) const
+{
+  switch (filterType)
+  {
+  case ReconstructionTask::kFilterType::kFilterCosine:
+    return new JPetFilterCosine(cutOffValue);
+  case ReconstructionTask::kFilterType::kFilterHamming:
+    return new JPetFilterHamming(cutOffValue);
+  case ReconstructionTask::kFilterType::kFilterHann:
+    return new JPetFilterHann(cutOffValue);
+  case ReconstructionTask::kFilterType::kFilterRidgelet:
+    return new JPetFilterRidgelet(cutOffValue);
+  case ReconstructionTask::kFilterType::kFilterSheppLogan:
+    return new JPetFilterSheppLogan(cutOffValue);
+  default:
+    return new JPetFilterNone(cutOffValue);
+  }
+}
+
 void ReconstructionTask::setUpOptions()
 {
   auto opts = getOptions();
@@ -196,4 +266,52 @@ void ReconstructionTask::setUpOptions()
   {
     fReconstructionName = getOptionAsString(opts, kReconstructionName);
   }
+  if (isOptionSet(opts, kLORTOFSigma))
+  {
+    fLORTOFSigma = getOptionAsFloat(opts, kLORTOFSigma);
+  }
+  if (isOptionSet(opts, kNumberOfThreads))
+  {
+    fNumberOfThreads = getOptionAsInt(opts, kNumberOfThreads);
+    if (fNumberOfThreads < 1)
+    {
+      WARNING("Number of threads for reconstruction has to be positive, using 1 thread.");
+      fNumberOfThreads = 1;
+    }
+  }
+  if (isOptionSet(opts, kFFTWWisdomFileName))
+  {
+    fFFTWWisdomFileName = getOptionAsString(opts, kFFTWWisdomFileName);
+  }
+  if (isOptionSet(opts, kOutputFormat))
+  {
+    fOutputFormat = getOptionAsString(opts, kOutputFormat);
+    if (fOutputFormat != "PGM" && fOutputFormat != "NRRD")
+    {
+      WARNING("Unknown output format: " + fOutputFormat + ", using PGM.");
+      fOutputFormat = "PGM";
+    }
+  }
+  if (isOptionSet(opts, kOSEMIterations))
+  {
+    fOSEMIterations = getOptionAsInt(opts, kOSEMIterations);
+    if (fOSEMIterations < 1)
+    {
+      WARNING("Number of OSEM iterations has to be positive, using 1 iteration.");
+      fOSEMIterations = 1;
+    }
+  }
+  if (isOptionSet(opts, kOSEMSubsets))
+  {
+    fOSEMSubsets = getOptionAsInt(opts, kOSEMSubsets);
+    if (fOSEMSubsets < 1)
+    {
+      WARNING("Number of OSEM subsets has to be positive, using 1 subset.");
+      fOSEMSubsets = 1;
+    }
+  }
+  if (isOptionSet(opts, kOSEMCheckpointEvery))
+  {
+    fOSEMCheckpointEvery = getOptionAsInt(opts, kOSEMCheckpointEvery);
+  }
 }
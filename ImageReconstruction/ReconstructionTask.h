@@ -25,6 +25,7 @@
 #include <string>
 #include <vector>
 
+#include "JPetDirectFourierReconstruction.h"
 #include "JPetFilterCosine.h"
 #include "JPetFilterHamming.h"
 #include "JPetFilterHann.h"
@@ -32,6 +33,7 @@
 #include "JPetFilterNone.h"
 #include "JPetFilterRidgelet.h"
 #include "JPetFilterSheppLogan.h"
+#include "JPetOSEMReconstruction.h"
 #include "JPetRecoImageTools.h"
 #include "JPetUserTask/JPetUserTask.h"
 
@@ -61,25 +63,21 @@ public:
   {
     kWeightNotFound,
     kFBP,
-    kTOFFBP
+    kTOFFBP,
+    kDirectFourier,
+    kOSEM
   };
 
 private:
   ReconstructionTask(const ReconstructionTask&) = delete;
   ReconstructionTask& operator=(const ReconstructionTask&) = delete;
 
-  /**
-   * @brief Helper function used in saving result
-   * \param result matrix to find max value
-   * \return max value of matrix
-   */
-  int getMaxValue(const JPetSinogramType::SparseMatrix& result);
   /**
    * @brief Helper function used to save results(sinograms and reconstructed images)
    * \param result resulted matrix to save
-   * \param outputFileName name with path where to save result
+   * \param outputFileName name with path where to save result, without extension, which depends on output format
    */
-  void saveResult(const JPetSinogramType::SparseMatrix& result, const std::string& outputFileName);
+  void saveResult(const JPetSinogramType::Matrix& result, const std::string& outputFileName);
 
   /**
    * @brief Function where all options from user params are readed and setted.
@@ -88,6 +86,12 @@ private:
 
   void setUpOptions();
 
+  /**
+   * @brief Creates filter of given type, JPetFilterNone is used when type is not known.
+   * Only reads configuration of the task, so it can be called from many threads.
+   */
+  JPetFilterInterface* createFilter(kFilterType filterType, float cutOffValue) const;
+
   const std::string kInFileNameKey = "SinogramCreator_OutFileName_std::string"; // input file for Reconstruction is output from SinogramCreator
 
   const std::string kReconstructSliceNumbers = "ReconstructionTask_ReconstructSliceNumbers_std::vector<int>";
@@ -103,6 +107,13 @@ private:
   const std::string kLORTOFSigma = "ReconstructionTask_LORTOFSigma_float";
 
   const std::string kOutFileNameKey = "ReconstructionTask_OutFileName_std::string";
+  const std::string kNumberOfThreads = "ReconstructionTask_NumberOfThreads_int";
+  const std::string kFFTWWisdomFileName = "ReconstructionTask_FFTWWisdomFileName_std::string";
+  const std::string kOutputFormat = "ReconstructionTask_OutputFormat_std::string";
+
+  const std::string kOSEMIterations = "ReconstructionTask_OSEMIterations_int";
+  const std::string kOSEMSubsets = "ReconstructionTask_OSEMSubsets_int";
+  const std::string kOSEMCheckpointEvery = "ReconstructionTask_OSEMCheckpointEvery_int";
 
   std::vector<int> fReconstructSliceNumbers; // reconstruct only slices that was given in userParams
 
@@ -114,10 +125,18 @@ private:
 
   float fLORTOFSigma = 150.f;
 
+  int fNumberOfThreads = 1;
+
+  int fOSEMIterations = 10;
+  int fOSEMSubsets = 10;
+  int fOSEMCheckpointEvery = 0;
+
   std::string fFilterName = "RamLak";
   std::string fReconstructionName = "FBP";
   std::string fOutFileName = "sinogram.root";
   std::string fInFileName = "sinogram.root";
+  std::string fFFTWWisdomFileName = "";
+  std::string fOutputFormat = "PGM";
 
   JPetSinogramType* fSinogram = nullptr;
 };
@@ -14,10 +14,14 @@
  */
 
 #include "SinogramCreator.h"
+#include "../LargeBarrelAnalysis/EventColumnarFormat.h"
+#include "LORFileTools.h"
+#include <TH1D.h>
 #include <TH1I.h>
 #include <TH2F.h>
 #include <TH2I.h>
 #include <TH3F.h>
+#include <thread>
 using namespace jpet_options_tools;
 
 SinogramCreator::SinogramCreator(const char* name) : JPetUserTask(name) {}
@@ -30,68 +34,92 @@ bool SinogramCreator::init()
 
   fOutputEvents = new JPetTimeWindow("JPetEvent");
   fSinogramData = JPetSinogramType::WholeSinogram(fZSplitNumber, JPetSinogramType::Matrix3D());
+  if (!fInputSinogramFileName.empty() && !loadInputSinogram())
+  {
+    return false;
+  }
+  if (fNumberOfThreads > 1)
+  {
+    fThreadSinogramData.assign(fNumberOfThreads, JPetSinogramType::WholeSinogram(fZSplitNumber, JPetSinogramType::Matrix3D()));
+  }
+  fThreadSinogramBins.resize(fNumberOfThreads);
+  fLORBuffer.reserve(kLORBufferSize);
+  if (!fMichelogramOutFileName.empty())
+  {
+    if (!createMichelogram())
+      return false;
+    fThreadMichelogramIndices.resize(fNumberOfThreads);
+  }
 
   if (!fGojaInputFilePath.empty())
   {
     readAndAnalyzeGojaFile();
   }
+  if (!fColumnarInputFilePath.empty())
+  {
+    readAndAnalyzeColumnarFiles();
+  }
 
   return true;
 }
 
 void SinogramCreator::readAndAnalyzeGojaFile()
 {
-  float firstX = 0.f;
-  float firstY = 0.f;
-  float secondX = 0.f;
-  float secondY = 0.f;
-  float firstZ = 0.f;
-  float secondZ = 0.f;
-  double firstT = 0.f;
-  double secondT = 0.f;
-
   float sourceX = 0.f;
   float sourceY = 0.f;
   float sourceZ = 0.f;
+  // position of the source does not change between LORs, so the attenuation fit is evaluated once
+  const double attenuationProbability =
+      fEnableNEMAAttenuation ? SinogramCreatorTools::getPolyFit(std::sqrt(sourceX * sourceX + sourceY * sourceY), -std::abs(sourceZ)) : 0.;
 
-  float skip = 0.f;
-  float skipInt = 0.f;
-  int coincidence = 0;
-
-  for (const auto& inputPath : fGojaInputFilePath)
-  {
-    std::ifstream in(inputPath);
-    while (in.peek() != EOF)
+  const auto analyzeLORs = [&](const std::vector<SinogramLOR>& lors) {
+    for (const auto& lor : lors)
     {
-      in >> firstX >> firstY >> firstZ >> firstT >> secondX >> secondY >> secondZ >> secondT >> skipInt >> skipInt >> skip >> skip >> coincidence >> skip >>
-          skip >> skip;
-      //in >> firstX >> firstY >> firstZ >> firstT >> secondX >> secondY >> secondZ >> secondT;
-      //if (coincidence != 1) // 1 == true event
-      //  continue;
-
       fTotalAnalyzedHits++;
 
       if (fEnableNEMAAttenuation)
       {
-        if (firstZ - secondZ < 30. &&
-            atenuation(SinogramCreatorTools::getPolyFit(std::vector<double>{(std::sqrt(sourceX * sourceX + sourceY * sourceY), -std::abs(sourceZ))})))
+        if (lor.firstZ - lor.secondZ < 30. && atenuation(attenuationProbability))
         {
-          fTotalAttenuatedHits++;
+          fRejections.add(SinogramRejectionCounters::kAttenuated);
           continue;
         }
       }
 
-      if (analyzeHits(firstX, firstY, firstZ, firstT, secondX, secondY, secondZ, secondT))
+      analyzeHits(lor);
+    }
+  };
+
+  for (const auto& inputPath : fGojaInputFilePath)
+  {
+    LORFileTools::readLORFile(inputPath, fNumberOfThreads, analyzeLORs);
+  }
+}
+
+void SinogramCreator::readAndAnalyzeColumnarFiles()
+{
+  ColumnarEvent event;
+  for (const auto& inputPath : fColumnarInputFilePath)
+  {
+    EventColumnarReader reader(inputPath);
+    const long long numberOfEvents = reader.getNumberOfEvents();
+    for (long long i = 0; i < numberOfEvents; i++)
+    {
+      if (!reader.readEvent(i, event) || event.hits.size() != 2)
       {
-        fNumberOfCorrectHits++;
+        continue;
       }
+      const auto& firstHit = event.hits[0];
+      const auto& secondHit = event.hits[1];
+      analyzeHits(firstHit.pos, firstHit.time, secondHit.pos, secondHit.time);
+      fTotalAnalyzedHits++;
     }
   }
 }
 
 bool SinogramCreator::exec()
 {
-  if (!fGojaInputFilePath.empty())
+  if (!fGojaInputFilePath.empty() || !fColumnarInputFilePath.empty())
   {
     return true;
   }
@@ -109,8 +137,7 @@ bool SinogramCreator::exec()
       }
       const auto& firstHit = hits[0];
       const auto& secondHit = hits[1];
-      if (analyzeHits(firstHit, secondHit))
-        fNumberOfCorrectHits++;
+      analyzeHits(firstHit, secondHit);
       fTotalAnalyzedHits++;
     }
   }
@@ -122,52 +149,147 @@ bool SinogramCreator::exec()
   return true;
 }
 
-bool SinogramCreator::analyzeHits(const JPetHit& firstHit, const JPetHit& secondHit)
+void SinogramCreator::analyzeHits(const JPetHit& firstHit, const JPetHit& secondHit)
 {
-  return analyzeHits(firstHit.getPos(), firstHit.getTime(), secondHit.getPos(), secondHit.getTime());
+  analyzeHits(firstHit.getPos(), firstHit.getTime(), secondHit.getPos(), secondHit.getTime());
 }
 
-bool SinogramCreator::analyzeHits(const float firstX, const float firstY, const float firstZ, const double firstTOF, const float secondX,
+void SinogramCreator::analyzeHits(const float firstX, const float firstY, const float firstZ, const double firstTOF, const float secondX,
                                   const float secondY, const float secondZ, const double secondTOF)
 {
-  int i = -1;
-  if (!fEnableObliqueLORRemapping)
+  analyzeHits(SinogramLOR{firstX, firstY, firstZ, firstTOF, secondX, secondY, secondZ, secondTOF});
+}
+
+void SinogramCreator::analyzeHits(const SinogramLOR& lor)
+{
+  fLORBuffer.push_back(lor);
+  if (fLORBuffer.size() >= kLORBufferSize)
+    processLORBuffer();
+}
+
+/**
+ * Buffered LORs are split into continuous chunks, one per thread, and each thread fills only its own sinogram.
+ */
+void SinogramCreator::processLORBuffer()
+{
+  if (fLORBuffer.empty())
+    return;
+  if (fNumberOfThreads <= 1)
   {
-    i = SinogramCreatorTools::getSplitRangeNumber(firstZ, secondZ, fZSplitRange);
+    fNumberOfCorrectHits += fillSinogram(fLORBuffer.data(), fLORBuffer.size(), fThreadSinogramBins[0], fSinogramData, fRejections);
+    if (fMichelogram.isOpen())
+    {
+      fNumberOfMichelogramLORs +=
+          fMichelogram.getBinIndices(fLORBuffer.data(), fLORBuffer.size(), fThreadSinogramBins[0], fThreadMichelogramIndices[0]);
+      fMichelogram.addCounts(fThreadMichelogramIndices[0]);
+    }
+    fLORBuffer.clear();
+    return;
   }
-  else
+  const std::size_t chunkSize = (fLORBuffer.size() + fNumberOfThreads - 1) / fNumberOfThreads;
+  std::vector<unsigned int> correctHits(fNumberOfThreads, 0);
+  std::vector<std::size_t> michelogramLORs(fNumberOfThreads, 0);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < fNumberOfThreads; t++)
   {
-    i = SinogramCreatorTools::getSinogramSlice(firstX, firstY, firstZ, firstTOF, secondX, secondY, secondZ, secondTOF, fZSplitRange);
+    const std::size_t begin = std::min(t * chunkSize, fLORBuffer.size());
+    const std::size_t end = std::min(begin + chunkSize, fLORBuffer.size());
+    workers.emplace_back([this, t, begin, end, &correctHits, &michelogramLORs]() {
+      correctHits[t] = fillSinogram(fLORBuffer.data() + begin, end - begin, fThreadSinogramBins[t], fThreadSinogramData[t], fRejections);
+      if (fMichelogram.isOpen())
+        michelogramLORs[t] = fMichelogram.getBinIndices(fLORBuffer.data() + begin, end - begin, fThreadSinogramBins[t], fThreadMichelogramIndices[t]);
+    });
   }
-  if (i < 0 || i >= fZSplitNumber)
+  for (auto& worker : workers)
+    worker.join();
+  for (auto hits : correctHits)
+    fNumberOfCorrectHits += hits;
+  if (fMichelogram.isOpen())
   {
-    WARNING("WARNING, reconstructed sinogram slice on 'z' is out of range: " + std::to_string(i) +
-            " max slice number: " + std::to_string(fZSplitNumber));
-    return false;
+    for (int t = 0; t < fNumberOfThreads; t++)
+    {
+      fNumberOfMichelogramLORs += michelogramLORs[t];
+      fMichelogram.addCounts(fThreadMichelogramIndices[t]);
+    }
   }
-  const auto sinogramResult = SinogramCreatorTools::getSinogramRepresentation(
-      firstX, firstY, secondX, secondY, fMaxReconstructionLayerRadius, fReconstructionDistanceAccuracy, fMaxDistanceNumber, kReconstructionMaxAngle);
-  const auto TOFSlice = SinogramCreatorTools::getTOFSlice(firstTOF, secondTOF, fTOFBinSliceSize);
-  const auto data = fSinogramData[i].find(TOFSlice);
-  if (sinogramResult.first >= fMaxDistanceNumber || sinogramResult.second >= kReconstructionMaxAngle)
-    return false;
-  if (data != fSinogramData[i].end())
+  fLORBuffer.clear();
+}
+
+/**
+ * Sinograms of threads are added in the order of threads, so the result does not depend on scheduling.
+ */
+void SinogramCreator::mergeThreadSinograms()
+{
+  processLORBuffer();
+  for (auto& threadSinogram : fThreadSinogramData)
   {
-    data->second(sinogramResult.first, sinogramResult.second) += 1.;
+    for (int slice = 0; slice < fZSplitNumber; slice++)
+    {
+      for (auto& tofWindow : threadSinogram[slice])
+      {
+        auto data = fSinogramData[slice].find(tofWindow.first);
+        if (data != fSinogramData[slice].end())
+          data->second += tofWindow.second;
+        else
+          fSinogramData[slice].insert(std::make_pair(tofWindow.first, std::move(tofWindow.second)));
+      }
+    }
   }
-  else
+  fThreadSinogramData.clear();
+}
+
+/**
+ * LORs are mapped to sinogram bins in one pass by SinogramCreatorTools::getSinogramBins, then bins are filled.
+ * Rejected LORs are counted locally and added to the shared counters once per call.
+ */
+unsigned int SinogramCreator::fillSinogram(const SinogramLOR* lors, std::size_t numberOfLORs, SinogramBins& bins,
+                                           JPetSinogramType::WholeSinogram& sinogram, SinogramRejectionCounters& rejections) const
+{
+  SinogramCreatorTools::getSinogramBins(lors, numberOfLORs, fSinogramBinning, bins);
+  unsigned int correctLORs = 0;
+  unsigned long long outOfZRange = 0;
+  unsigned long long distanceOverflow = 0;
+  unsigned long long angleOverflow = 0;
+  for (std::size_t j = 0; j < numberOfLORs; j++)
   {
-    fSinogramData[i].insert(std::make_pair(
-        TOFSlice, JPetSinogramType::SparseMatrix(fMaxDistanceNumber, kReconstructionMaxAngle, fMaxDistanceNumber * kReconstructionMaxAngle)));
-    fSinogramData[i][TOFSlice](sinogramResult.first, sinogramResult.second) += 1.;
+    const int i = bins.zSlice[j];
+    if (i < 0 || i >= fZSplitNumber)
+    {
+      if (rejections.shouldLog(SinogramRejectionCounters::kOutOfZRange))
+      {
+        WARNING("Reconstructed sinogram slice on 'z' is out of range: " + std::to_string(i) + " max slice number: " + std::to_string(fZSplitNumber) +
+                " (only first " + std::to_string(SinogramRejectionCounters::kMaxLoggedRejections) + " such LORs are reported)");
+      }
+      outOfZRange++;
+      continue;
+    }
+    if (bins.distance[j] >= fMaxDistanceNumber)
+    {
+      distanceOverflow++;
+      continue;
+    }
+    if (bins.angle[j] >= kReconstructionMaxAngle)
+    {
+      angleOverflow++;
+      continue;
+    }
+    auto data = sinogram[i].find(bins.tofSlice[j]);
+    if (data == sinogram[i].end())
+    {
+      data = sinogram[i].insert(std::make_pair(bins.tofSlice[j], JPetSinogramType::Matrix(fMaxDistanceNumber, kReconstructionMaxAngle))).first;
+    }
+    data->second(bins.distance[j], bins.angle[j]) += 1.;
+    correctLORs++;
   }
-
-  return true;
+  rejections.add(SinogramRejectionCounters::kOutOfZRange, outOfZRange);
+  rejections.add(SinogramRejectionCounters::kDistanceOverflow, distanceOverflow);
+  rejections.add(SinogramRejectionCounters::kAngleOverflow, angleOverflow);
+  return correctLORs;
 }
 
-bool SinogramCreator::analyzeHits(const TVector3& firstHit, const float firstTOF, const TVector3& secondHit, const float secondTOF)
+void SinogramCreator::analyzeHits(const TVector3& firstHit, const float firstTOF, const TVector3& secondHit, const float secondTOF)
 {
-  return analyzeHits(firstHit.X(), firstHit.Y(), firstHit.Z(), firstTOF, secondHit.X(), secondHit.Y(), secondHit.Z(), secondTOF);
+  analyzeHits(firstHit.X(), firstHit.Y(), firstHit.Z(), firstTOF, secondHit.X(), secondHit.Y(), secondHit.Z(), secondTOF);
 }
 
 float SinogramCreator::getTOFRescaleFactor(const TVector3& posDiff) const
@@ -181,29 +303,134 @@ float SinogramCreator::getTOFRescaleFactor(const TVector3& posDiff) const
 
 bool SinogramCreator::terminate()
 {
+  mergeThreadSinograms();
   // Save sinogram to root file.
-  JPetSinogramType map("Sinogram", fZSplitNumber, fMaxDistanceNumber, fMaxReconstructionLayerRadius, fReconstructionDistanceAccuracy,
-                       fScintillatorLenght, fTOFBinSliceSize, fZSplitRange);
+  JPetSinogramType map = createSinogramType();
   map.addSinogram(fSinogramData);
-  map.setNumberOfAllEvents(fTotalAnalyzedHits);
-  map.setNumberOfEventsUsedToCreateSinogram(fNumberOfCorrectHits);
+  map.setNumberOfAllEvents(fInputNumberOfAllEvents + fTotalAnalyzedHits);
+  map.setNumberOfEventsUsedToCreateSinogram(fInputNumberOfCorrectEvents + fNumberOfCorrectHits);
   JPetWriter* writer = new JPetWriter(fOutFileName.c_str());
   map.saveSinogramToFile(writer);
+  saveRejectionCounters(writer);
   writer->closeFile();
 
   float totalCorrectProcentage = 0.f;
   if (fTotalAnalyzedHits != 0)
     totalCorrectProcentage = (((float)fNumberOfCorrectHits * 100.f) / (float)fTotalAnalyzedHits);
   std::cout << "Correct hits: " << fNumberOfCorrectHits << " total hits: " << fTotalAnalyzedHits << " (correct percentage: " << totalCorrectProcentage
-            << "%)"
-            << " attenuated: " << fTotalAttenuatedHits << std::endl
+            << "%)" << std::endl
             << std::endl;
+  std::string rejectionSummary = "Rejected LORs:";
+  for (int reason = 0; reason < SinogramRejectionCounters::kNumberOfReasons; reason++)
+  {
+    const auto rejectionReason = static_cast<SinogramRejectionCounters::Reason>(reason);
+    rejectionSummary += std::string(" ") + SinogramRejectionCounters::getReasonName(rejectionReason) + ": " +
+                        std::to_string(fRejections.get(rejectionReason)) + ",";
+  }
+  rejectionSummary += " total: " + std::to_string(fRejections.getTotal());
+  INFO(rejectionSummary);
+
+  if (fMichelogram.isOpen())
+  {
+    fMichelogram.close();
+    INFO("Michelogram saved to " + fMichelogramOutFileName + ", LORs inside of the michelogram: " + std::to_string(fNumberOfMichelogramLORs));
+  }
 
   return true;
 }
 
 bool SinogramCreator::atenuation(const float value) { return distribution(generator) <= value; }
 
+/**
+ * Numbers of rejected LORs are saved next to the sinogram as histogram with one labeled bin per reason.
+ */
+void SinogramCreator::saveRejectionCounters(JPetWriter* writer) const
+{
+  if (!writer->isOpen())
+  {
+    ERROR("Could not write rejection counters to file. The provided JPetWriter is closed.");
+    return;
+  }
+  TH1D rejections("SinogramRejections", "Number of LORs rejected during sinogram creation", SinogramRejectionCounters::kNumberOfReasons, 0.,
+                  SinogramRejectionCounters::kNumberOfReasons);
+  rejections.SetDirectory(nullptr);
+  for (int reason = 0; reason < SinogramRejectionCounters::kNumberOfReasons; reason++)
+  {
+    const auto rejectionReason = static_cast<SinogramRejectionCounters::Reason>(reason);
+    rejections.GetXaxis()->SetBinLabel(reason + 1, SinogramRejectionCounters::getReasonName(rejectionReason));
+    rejections.SetBinContent(reason + 1, fRejections.get(rejectionReason));
+  }
+  writer->writeObject(&rejections, "SinogramRejections");
+}
+
+JPetSinogramType SinogramCreator::createSinogramType() const
+{
+  return JPetSinogramType("Sinogram", fZSplitNumber, fMaxDistanceNumber, fMaxReconstructionLayerRadius, fReconstructionDistanceAccuracy,
+                          fScintillatorLenght, fTOFBinSliceSize, fZSplitRange);
+}
+
+/**
+ * Sinogram from the input file becomes the starting state of the task. It is accepted only if it has
+ * the same binning as the one given by the options, otherwise counts of both could not be added.
+ */
+bool SinogramCreator::loadInputSinogram()
+{
+  JPetSinogramType* input = JPetSinogramType::readMapFromFile(fInputSinogramFileName, "Sinogram");
+  if (!input)
+  {
+    ERROR("Could not read sinogram from file: " + fInputSinogramFileName);
+    return false;
+  }
+  if (!createSinogramType().hasSameBinning(*input) || input->getSinogram().size() != fSinogramData.size())
+  {
+    ERROR("Binning of sinogram in file " + fInputSinogramFileName + " does not match options of the task, it can not be continued.");
+    delete input;
+    return false;
+  }
+  fSinogramData = input->getSinogram();
+  fInputNumberOfAllEvents = input->getNumberOfAllEvents();
+  fInputNumberOfCorrectEvents = input->getNumberOfEventsUsedToCreateSinogram();
+  delete input;
+  INFO("Sinogram continued from file " + fInputSinogramFileName + ", events already used: " + std::to_string(fInputNumberOfCorrectEvents) +
+       " of " + std::to_string(fInputNumberOfAllEvents));
+  return true;
+}
+
+/**
+ * Rings of the michelogram are z slices of the sinogram. Maximal TOF is given by the longest LOR inside of the detector.
+ */
+bool SinogramCreator::createMichelogram()
+{
+  const float kSpeedOfLight = 0.0299792458f; // in cm/ps
+  if (fZSplitRange.empty())
+  {
+    ERROR("Michelogram requires positive number of z slices.");
+    return false;
+  }
+  MichelogramGeometry geometry;
+  geometry.numberOfRings = fZSplitNumber;
+  geometry.zBegin = fZSplitRange.front().first;
+  geometry.ringWidth = fZSplitRange.front().second - fZSplitRange.front().first;
+  geometry.span = fMichelogramSpan;
+  geometry.maxRingDifference = fMichelogramMaxRingDifference;
+  geometry.numberOfDistances = fMaxDistanceNumber;
+  geometry.numberOfAngles = kReconstructionMaxAngle;
+  geometry.maxReconstructionLayerRadius = fMaxReconstructionLayerRadius;
+  geometry.reconstructionDistanceAccuracy = fReconstructionDistanceAccuracy;
+  geometry.tofSliceSize = fTOFBinSliceSize;
+  const float diameter = 2.f * fMaxReconstructionLayerRadius;
+  geometry.maxTOF = std::sqrt(diameter * diameter + fScintillatorLenght * fScintillatorLenght) / kSpeedOfLight / 2.f;
+  if (!fMichelogram.create(fMichelogramOutFileName, geometry))
+  {
+    ERROR("Could not create michelogram in file: " + fMichelogramOutFileName);
+    return false;
+  }
+  const auto& header = fMichelogram.getHeader();
+  INFO("Michelogram with " + std::to_string(header.numberOfSegments) + " segments, " + std::to_string(header.numberOfPlanes) + " planes and " +
+       std::to_string(header.numberOfTOFBins) + " TOF bins created in " + fMichelogramOutFileName);
+  return true;
+}
+
 void SinogramCreator::setUpOptions()
 {
   auto opts = getOptions();
@@ -235,6 +462,35 @@ void SinogramCreator::setUpOptions()
   {
     fGojaInputFilePath = getOptionAsVectorOfStrings(opts, kGojaInputFilePath);
   }
+  if (isOptionSet(opts, kColumnarInputFilePath))
+  {
+    fColumnarInputFilePath = getOptionAsVectorOfStrings(opts, kColumnarInputFilePath);
+  }
+  if (isOptionSet(opts, kNumberOfThreads))
+  {
+    fNumberOfThreads = getOptionAsInt(opts, kNumberOfThreads);
+    if (fNumberOfThreads < 1)
+    {
+      WARNING("Number of threads for sinogram creation has to be positive, using 1 thread.");
+      fNumberOfThreads = 1;
+    }
+  }
+  if (isOptionSet(opts, kInputSinogramFileName))
+  {
+    fInputSinogramFileName = getOptionAsString(opts, kInputSinogramFileName);
+  }
+  if (isOptionSet(opts, kMichelogramOutFileName))
+  {
+    fMichelogramOutFileName = getOptionAsString(opts, kMichelogramOutFileName);
+  }
+  if (isOptionSet(opts, kMichelogramSpan))
+  {
+    fMichelogramSpan = getOptionAsInt(opts, kMichelogramSpan);
+  }
+  if (isOptionSet(opts, kMichelogramMaxRingDifference))
+  {
+    fMichelogramMaxRingDifference = getOptionAsInt(opts, kMichelogramMaxRingDifference);
+  }
   if (isOptionSet(opts, kEnableNEMAAttenuation))
   {
     fEnableNEMAAttenuation = getOptionAsBool(opts, kEnableNEMAAttenuation);
@@ -265,4 +521,12 @@ void SinogramCreator::setUpOptions()
   }
 
   fMaxDistanceNumber = std::ceil(fMaxReconstructionLayerRadius * 2 * (1.f / fReconstructionDistanceAccuracy)) + 1;
+
+  fSinogramBinning.maxReconstructionLayerRadius = fMaxReconstructionLayerRadius;
+  fSinogramBinning.reconstructionDistanceAccuracy = fReconstructionDistanceAccuracy;
+  fSinogramBinning.maxDistanceNumber = fMaxDistanceNumber;
+  fSinogramBinning.maxAngle = kReconstructionMaxAngle;
+  fSinogramBinning.tofSliceSize = fTOFBinSliceSize;
+  fSinogramBinning.obliqueLORRemapping = fEnableObliqueLORRemapping;
+  fSinogramBinning.zSplitRange = fZSplitRange;
 }
@@ -25,6 +25,7 @@
 #include "JPetGeomMapping/JPetGeomMapping.h"
 #include "JPetHit/JPetHit.h"
 #include "JPetUserTask/JPetUserTask.h"
+#include "Michelogram.h"
 #include "SinogramCreatorTools.h"
 #include <random>
 #include <string>
@@ -36,17 +37,14 @@
  * @brief Module creating sinogram from data
  *
  * Input: *.reco.unk.evt
- * Output: *.sino with root diagrams and sinogram *.ppm with calculated sinogram.
+ * Output: *.sino with root diagrams and ROOT file with calculated sinogram (JPetSinogramType).
  *
- * Module creates 2D x/y sinogram as *.ppm files for further reconstruction, e.g. FBP.
+ * Module creates 2D x/y sinograms for further reconstruction, e.g. FBP in ReconstructionTask,
+ * which writes reconstructed images as *.pgm or *.nrrd files.
  *
  * It is also possible to split Z coordinate into smaller sections, then for each section sinogram is created.
  * Split is done by dividing Z coordinate into equal sections starting from negative values to positive, assuming that center of Z axis is in 0.
- * It is saved as matrix(fi, r) with values corresponding to number of hits registered with that angle and distance from center,
- * with header needed by ppm P2 file:
- * P2
- * (number of horizontal elements) (number of vertical elements)
- * (maximal value in matrix).
+ * It is saved as matrix(r, fi) with values corresponding to number of hits registered with that distance from center and angle.
  *
  * It defines 5 user options:
  * - "SinogramCreator_OutFileName_std::string": defines output file name where sinogram is saved
@@ -54,6 +52,26 @@
  * corresponds to 0.1 cm in reality
  * - "SinogramCreator_SinogramZSplitNumber_int": defines number of splits around "z" coordinate
  * - "SinogramCreator_ScintillatorLenght_float": defines scintillator lenght in "z" coordinate
+ *
+ * Instead of time windows, LORs can be read from GOJA output files ("SinogramCreator_GojaInputFilesPaths_std::vector<std::string>"),
+ * or from binary LOR files created from them with convertGojaToBinary.x, which are recognised by their header,
+ * or from columnar files of categorized events saved by EventCategorizer ("SinogramCreator_ColumnarInputFilesPaths_std::vector<std::string>").
+ *
+ * LORs are buffered and binned in batches. With "SinogramCreator_NumberOfThreads_int" greater than 1, each buffer is split between worker threads.
+ * Every worker fills its own sinogram, so memory grows with one sinogram per thread. Sinograms of workers are added
+ * to the main one in terminate(), always in the same order.
+ *
+ * LORs outside of the sinogram (out of z range, distance or angle overflow) and LORs removed by NEMA attenuation are counted per reason.
+ * Counts are reported once in terminate() and saved in the output file as "SinogramRejections" histogram.
+ *
+ * With "SinogramCreator_MichelogramOutFileName_std::string" LORs are also binned into fully 3D TOF michelogram
+ * (see Michelogram), keeping oblique LORs. Z slices are used as rings, "SinogramCreator_MichelogramSpan_int" and
+ * "SinogramCreator_MichelogramMaxRingDifference_int" define its segments. Bins of LORs are found by worker threads,
+ * counts are added to the memory mapped file by the main thread.
+ *
+ * Sinogram can be built incrementally: with "SinogramCreator_InputSinogramFileName_std::string" sinogram saved earlier
+ * is loaded as the starting state, if its binning matches the options of the task. New LORs and numbers of events
+ * are added to it and the result is saved to the output file. Independently created sinograms can be added with mergeSinograms.x.
  */
 class SinogramCreator : public JPetUserTask
 {
@@ -65,10 +83,23 @@ public:
   virtual bool terminate() override;
 
 protected:
-  bool analyzeHits(const JPetHit& firstHit, const JPetHit& secondHit);
-  bool analyzeHits(const TVector3& firstHit, const float firstTOF, const TVector3& secondHit, const float secondTOF);
-  bool analyzeHits(const float firstX, const float firstY, const float firstZ, const double firstTOF, const float secondX, const float secondY,
+  void analyzeHits(const JPetHit& firstHit, const JPetHit& secondHit);
+  void analyzeHits(const TVector3& firstHit, const float firstTOF, const TVector3& secondHit, const float secondTOF);
+  void analyzeHits(const float firstX, const float firstY, const float firstZ, const double firstTOF, const float secondX, const float secondY,
                    const float secondZ, const double secondTOF);
+  void analyzeHits(const SinogramLOR& lor);
+  /**
+   * @brief Function adding LORs to the sinogram, returns number of LORs inside of the sinogram range.
+   * It only reads configuration of the task, so it can be called from many threads filling different sinograms.
+   */
+  unsigned int fillSinogram(const SinogramLOR* lors, std::size_t numberOfLORs, SinogramBins& bins, JPetSinogramType::WholeSinogram& sinogram,
+                            SinogramRejectionCounters& rejections) const;
+  void processLORBuffer();
+  void mergeThreadSinograms();
+  void saveRejectionCounters(JPetWriter* writer) const;
+  bool createMichelogram();
+  bool loadInputSinogram();
+  JPetSinogramType createSinogramType() const;
   /**
    * @brief Function returing value of TOF rescale, to match same annihilation point after projection from 3d to 2d
    * \param x_diff difference on x axis between hit ends
@@ -78,6 +109,7 @@ protected:
   float getTOFRescaleFactor(const TVector3& posDiff) const;
 
   void readAndAnalyzeGojaFile();
+  void readAndAnalyzeColumnarFiles();
   bool atenuation(const float value);
 
   const int kReconstructionMaxAngle = 180;
@@ -111,18 +143,41 @@ private:
   const std::string kTOFBinSliceSize = "SinogramCreator_TOFBinSliceSize_float";
 
   const std::string kGojaInputFilePath = "SinogramCreator_GojaInputFilesPaths_std::vector<std::string>";
+  const std::string kColumnarInputFilePath = "SinogramCreator_ColumnarInputFilesPaths_std::vector<std::string>";
+  const std::string kNumberOfThreads = "SinogramCreator_NumberOfThreads_int";
+  const std::string kInputSinogramFileName = "SinogramCreator_InputSinogramFileName_std::string";
+  const std::string kMichelogramOutFileName = "SinogramCreator_MichelogramOutFileName_std::string";
+  const std::string kMichelogramSpan = "SinogramCreator_MichelogramSpan_int";
+  const std::string kMichelogramMaxRingDifference = "SinogramCreator_MichelogramMaxRingDifference_int";
 
   std::string fOutFileName = "sinogram.root";
   std::vector<std::string> fGojaInputFilePath;
+  std::vector<std::string> fColumnarInputFilePath;
+  std::string fInputSinogramFileName;
 
   JPetSinogramType::WholeSinogram fSinogramData;
+  std::vector<JPetSinogramType::WholeSinogram> fThreadSinogramData;
+  std::vector<SinogramBins> fThreadSinogramBins;
+  std::vector<SinogramLOR> fLORBuffer;
+  SinogramBinning fSinogramBinning;
+  static const std::size_t kLORBufferSize = 1 << 18;
+  int fNumberOfThreads = 1;
   float fTOFBinSliceSize = 100.f;
 
   bool fEnableNEMAAttenuation = false;
 
-  unsigned int fTotalAnalyzedHits = 0;
-  unsigned int fNumberOfCorrectHits = 0;
-  unsigned int fTotalAttenuatedHits = 0;
+  unsigned long long fTotalAnalyzedHits = 0;
+  unsigned long long fNumberOfCorrectHits = 0;
+  unsigned long long fInputNumberOfAllEvents = 0;
+  unsigned long long fInputNumberOfCorrectEvents = 0;
+  SinogramRejectionCounters fRejections;
+
+  std::string fMichelogramOutFileName;
+  int fMichelogramSpan = 1;
+  int fMichelogramMaxRingDifference = -1;
+  Michelogram fMichelogram;
+  std::vector<std::vector<int64_t>> fThreadMichelogramIndices;
+  unsigned long long fNumberOfMichelogramLORs = 0;
 
   std::default_random_engine generator;
   std::uniform_real_distribution<double> distribution;
@@ -15,59 +15,136 @@
 
 #include "SinogramCreatorTools.h"
 #include "JPetLoggerInclude.h"
-#include <iostream>
+#include <algorithm>
+#include <cassert>
 #include <math.h>
 
-unsigned int SinogramCreatorTools::roundToNearesMultiplicity(double numberToRound, double accuracy)
+const unsigned int SinogramRejectionCounters::kMaxLoggedRejections;
+
+SinogramRejectionCounters::SinogramRejectionCounters() { reset(); }
+
+void SinogramRejectionCounters::add(Reason reason, unsigned long long count)
 {
-  return std::floor((numberToRound / accuracy) + (accuracy / 2.));
+  if (count > 0)
+    fCounters[reason].fetch_add(count, std::memory_order_relaxed);
 }
 
-std::pair<int, float> SinogramCreatorTools::getAngleAndDistance(float firstX, float firstY, float secondX, float secondY)
+unsigned long long SinogramRejectionCounters::get(Reason reason) const { return fCounters[reason].load(std::memory_order_relaxed); }
+
+unsigned long long SinogramRejectionCounters::getTotal() const
+{
+  unsigned long long total = 0;
+  for (const auto& counter : fCounters)
+    total += counter.load(std::memory_order_relaxed);
+  return total;
+}
+
+/**
+ * Returns true only for first kMaxLoggedRejections calls for given reason, so messages about rejected LORs
+ * do not flood the output with large data sets.
+ */
+bool SinogramRejectionCounters::shouldLog(Reason reason)
+{
+  return fLoggedRejections[reason].fetch_add(1, std::memory_order_relaxed) < kMaxLoggedRejections;
+}
+
+void SinogramRejectionCounters::reset()
 {
-  float dx = (secondX - firstX);
-  float dy = (secondY - firstY);
-  if (std::abs(dx) < kEPSILON) return std::make_pair(0, firstX < 0 ? -std::sqrt(firstY * firstY) : std::sqrt(firstY * firstY));
-  if (std::abs(dy) < kEPSILON) return std::make_pair(90, firstY < 0 ? - std::sqrt(firstX * firstX) : std::sqrt(firstX * firstX));
-  float slope = dy / dx;
-  if (std::abs(slope) < kEPSILON)
-    slope = -1.f;
-  float perpendicularSlope = -(1.f / slope);
-  float d = firstY - (slope * firstX);
+  for (auto& counter : fCounters)
+    counter.store(0, std::memory_order_relaxed);
+  for (auto& logged : fLoggedRejections)
+    logged.store(0, std::memory_order_relaxed);
+}
+
+const char* SinogramRejectionCounters::getReasonName(Reason reason)
+{
+  switch (reason)
+  {
+  case kOutOfZRange:
+    return "Out of z range";
+  case kDistanceOverflow:
+    return "Distance overflow";
+  case kAngleOverflow:
+    return "Angle overflow";
+  case kAttenuated:
+    return "Attenuated";
+  default:
+    return "Unknown";
+  }
+}
 
-  if (std::abs(d) < kEPSILON)
-    d = 1.f;
+unsigned int SinogramCreatorTools::roundToNearesMultiplicity(double numberToRound, double accuracy)
+{
+  return std::floor((numberToRound / accuracy) + (accuracy / 2.));
+}
 
-  if(std::abs(slope - perpendicularSlope) < kEPSILON)
-    return std::make_pair(90, std::sqrt(std::pow((firstX), 2)));
+namespace
+{
+/* Normal form of the LOR: n = (dy, -dx) is perpendicular to the LOR and s = (x1 * y2 - x2 * y1) / |d| is the
+ * distance of the LOR from the center, so the point of the LOR closest to the center is s * n / |n|.
+ * Angle of n is folded to [0, 180) degrees. Distance is negative when the closest point has negative x,
+ * or lies on the negative y semi-axis. There are no special cases for vertical, horizontal and centered LORs.
+ */
+inline void getNormalForm(float firstX, float firstY, float secondX, float secondY, int& angle, float& distance)
+{
+  const float dx = secondX - firstX;
+  const float dy = secondY - firstY;
+  const float length = std::sqrt(dx * dx + dy * dy);
+  const float normalX = dy;
+  const float normalY = -dx;
+  float theta = std::atan2(normalY, normalX);
+  theta += normalY < 0.f ? M_PI : 0.;
+  const float degrees = theta * (180.f / M_PI);
+  angle = static_cast<int>(std::round(degrees)) % 180;
+  const float s = length > 0.f ? (firstX * secondY - secondX * firstY) / length : 0.f;
+  const float closestX = s * normalX;
+  const float closestY = s * normalY;
+  distance = std::abs(s);
+  distance = (closestX < 0.f || (closestX == 0.f && closestY < 0.f)) ? -distance : distance;
+}
 
-  float xAngle = -d / (slope - perpendicularSlope);
-  float yAngle = slope * (-d / (slope - perpendicularSlope)) + d;
+/* Returns the first and the last range containing z, or -1 if there is none. Only ranges around
+ * the one given by index arithmetic are checked, as ranges are equal and consecutive.
+ */
+inline std::pair<int, int> findZRanges(float z, const std::vector<std::pair<float, float>>& zSplitRange, float begin, float width)
+{
+  const int numberOfRanges = zSplitRange.size();
+  float candidate = std::floor((z - begin) / width);
+  if (!(candidate >= -1.f))
+    candidate = -1.f;
+  if (candidate > numberOfRanges)
+    candidate = numberOfRanges;
+  const int index = static_cast<int>(candidate);
+  int first = -1;
+  int last = -1;
+  for (int i = std::max(index - 1, 0); i <= std::min(index + 1, numberOfRanges - 1); i++)
+  {
+    if (z >= zSplitRange[i].first && z <= zSplitRange[i].second)
+    {
+      if (first < 0)
+        first = i;
+      last = i;
+    }
+  }
+  return std::make_pair(first, last);
+}
+} // namespace
 
-  float angle = std::atan2(yAngle, xAngle);
-  if (yAngle < 0) angle += M_PI;
-  angle *= (180.f / M_PI);
-  int angleResult = std::round(angle);
-  angleResult = angleResult % 180;
-  float distance = std::sqrt(std::pow((xAngle), 2) + std::pow((yAngle), 2));
-  if (xAngle < 0) distance = -distance;
-  
-  return std::make_pair(angleResult, distance);
+std::pair<int, float> SinogramCreatorTools::getAngleAndDistance(float firstX, float firstY, float secondX, float secondY)
+{
+  int angle = 0;
+  float distance = 0.f;
+  getNormalForm(firstX, firstY, secondX, secondY, angle, distance);
+  return std::make_pair(angle, distance);
 }
 
 std::pair<int, int> SinogramCreatorTools::getSinogramRepresentation(float firstX, float firstY, float secondX, float secondY,
-                                                                    float fMaxReconstructionLayer, float fReconstructionDistanceAccuracy,
-                                                                    int maxDistanceNumber, int kReconstructionMaxAngle)
+                                                                    float fMaxReconstructionLayer, float fReconstructionDistanceAccuracy)
 {
   std::pair<int, float> angleAndDistance = SinogramCreatorTools::getAngleAndDistance(firstX, firstY, secondX, secondY);
 
   int distanceRound =
       SinogramCreatorTools::roundToNearesMultiplicity(angleAndDistance.second + fMaxReconstructionLayer, fReconstructionDistanceAccuracy);
-  if (distanceRound >= maxDistanceNumber || angleAndDistance.first >= kReconstructionMaxAngle)
-  {
-    std::cout << "Distance or angle > then max, distance: " << distanceRound << " (max : " << maxDistanceNumber << ")"
-              << " angle: " << angleAndDistance.first << " (max: " << kReconstructionMaxAngle << ")" << std::endl;
-  }
   if (distanceRound < 0) distanceRound = 0;
   return std::make_pair(distanceRound, angleAndDistance.first);
 }
@@ -148,12 +225,59 @@ int SinogramCreatorTools::getSinogramSlice(float firstX, float firstY, float fir
   return getSplitRangeNumber(result, zSplitRange);
 }
 
-unsigned int SinogramCreatorTools::getTOFSlice(double firstTOF, double secondTOF, double sliceSize)
+int SinogramCreatorTools::getTOFSlice(double firstTOF, double secondTOF, double sliceSize)
 {
   double tofDiff = (secondTOF - firstTOF) / 2.;
   return tofDiff / sliceSize;
 }
 
+void SinogramCreatorTools::getSinogramBins(const SinogramLOR* lors, std::size_t numberOfLORs, const SinogramBinning& binning, SinogramBins& bins)
+{
+  bins.distance.resize(numberOfLORs);
+  bins.angle.resize(numberOfLORs);
+  bins.zSlice.resize(numberOfLORs);
+  bins.tofSlice.resize(numberOfLORs);
+
+  const double accuracy = binning.reconstructionDistanceAccuracy;
+  for (std::size_t i = 0; i < numberOfLORs; i++)
+  {
+    const SinogramLOR& lor = lors[i];
+    int angle = 0;
+    float distance = 0.f;
+    getNormalForm(lor.firstX, lor.firstY, lor.secondX, lor.secondY, angle, distance);
+    const float shiftedDistance = distance + binning.maxReconstructionLayerRadius;
+    const double distanceBin = std::floor((shiftedDistance / accuracy) + (accuracy / 2.));
+    bins.distance[i] = distanceBin > 0. ? static_cast<int>(distanceBin) : 0;
+    bins.angle[i] = angle;
+    bins.tofSlice[i] = static_cast<int>(((lor.secondTOF - lor.firstTOF) / 2.) / binning.tofSliceSize);
+  }
+
+  const auto& zSplitRange = binning.zSplitRange;
+  if (zSplitRange.empty())
+  {
+    std::fill(bins.zSlice.begin(), bins.zSlice.end(), -1);
+    return;
+  }
+  const float zBegin = zSplitRange.front().first;
+  const float zWidth = zSplitRange.front().second - zSplitRange.front().first;
+  for (std::size_t i = 0; i < numberOfLORs; i++)
+  {
+    const SinogramLOR& lor = lors[i];
+    if (binning.obliqueLORRemapping)
+    {
+      const float z = calculateLORSlice(lor.firstX, lor.firstY, lor.firstZ, lor.firstTOF, lor.secondX, lor.secondY, lor.secondZ, lor.secondTOF);
+      bins.zSlice[i] = findZRanges(z, zSplitRange, zBegin, zWidth).first;
+    }
+    else
+    {
+      const auto first = findZRanges(lor.firstZ, zSplitRange, zBegin, zWidth);
+      const auto second = findZRanges(lor.secondZ, zSplitRange, zBegin, zWidth);
+      const int slice = std::max(first.first, second.first);
+      bins.zSlice[i] = (first.first >= 0 && second.first >= 0 && slice <= std::min(first.second, second.second)) ? slice : -1;
+    }
+  }
+}
+
 //TODO: add time remapping also
 std::pair<TVector3,TVector3> SinogramCreatorTools::remapToSingleLayer(const TVector3& firstHit, const TVector3& secondHit, const float r)
 {
@@ -212,31 +336,49 @@ std::pair<TVector3,TVector3> SinogramCreatorTools::remapToSingleLayer(const TVec
   return std::make_pair(TVector3(x1, y1, z1), TVector3(x2, y2, z2));
 }
 
-// indepvar[0] = dist_xy
-// indepvar[1] = -abs(z) for NEMA Phantom only
-double SinogramCreatorTools::getPolyFit(std::vector<double> indepvar)
-{
-  const std::vector<std::vector<double>> modelTerms{{6, 0}, {5, 1}, {5, 0}, {4, 2}, {4, 1}, {4, 0}, {3, 3}, {3, 2}, {3, 1}, {3, 0},
-                                                    {2, 4}, {2, 3}, {2, 2}, {2, 1}, {2, 0}, {1, 5}, {1, 4}, {1, 3}, {1, 2}, {1, 1},
-                                                    {1, 0}, {0, 6}, {0, 5}, {0, 4}, {0, 3}, {0, 2}, {0, 1}, {0, 0}};
-  const std::vector<double> coefficients{
-      -4.134801885659948e-07, -2.300107024422413e-08, 1.63726635335888e-05,   1.73001508731807e-06,  1.359112755021784e-05, -0.0003483024181997085,
-      3.0824911712077e-06,    -1.671743900149295e-05, -0.0002755710560288588, 0.006195186956691909,  2.139575490180591e-06, -3.604595062410784e-05,
-      -0.0001028583160383859, 0.001337241556475614,   -0.07459337521834991,   4.354695109287826e-06, 7.061215552547179e-05, 0.0006737187696296268,
-      0.002313067110373971,   0.002549526937584952,   0.3926701790901366,     1.707921126250134e-06, 5.241438152857635e-06, -0.0005029848848941915,
-      -0.005095141886803388,  -0.01607730907583253,   -0.03130108005714758,   0.2797848665191068};
-
-  int nt = modelTerms.size();
-  assert(nt > 0);
-  double ypred = 0;
-  for (int i = 0; i < nt; i++)
+namespace
+{
+/* Coefficients of the NEMA attenuation fit, kNEMAAttenuationCoefficients[i][j] multiplies dist_xy^i * (-|z|)^j,
+ * terms with i + j > 6 are zero.
+ */
+constexpr int kNEMAAttenuationDegree = 6;
+constexpr double kNEMAAttenuationCoefficients[kNEMAAttenuationDegree + 1][kNEMAAttenuationDegree + 1] = {
+    {0.2797848665191068, -0.03130108005714758, -0.01607730907583253, -0.005095141886803388, -0.0005029848848941915, 5.241438152857635e-06,
+     1.707921126250134e-06},
+    {0.3926701790901366, 0.002549526937584952, 0.002313067110373971, 0.0006737187696296268, 7.061215552547179e-05, 4.354695109287826e-06},
+    {-0.07459337521834991, 0.001337241556475614, -0.0001028583160383859, -3.604595062410784e-05, 2.139575490180591e-06},
+    {0.006195186956691909, -0.0002755710560288588, -1.671743900149295e-05, 3.0824911712077e-06},
+    {-0.0003483024181997085, 1.359112755021784e-05, 1.73001508731807e-06},
+    {1.63726635335888e-05, -2.300107024422413e-08},
+    {-4.134801885659948e-07}};
+} // namespace
+
+/**
+ * Polynomial is evaluated with Horner scheme in dist_xy, each of its coefficients being polynomial in z, also evaluated with Horner scheme.
+ */
+double SinogramCreatorTools::getPolyFit(double distanceXY, double negativeAbsZ)
+{
+  double result = 0.;
+  for (int i = kNEMAAttenuationDegree; i >= 0; i--)
   {
-    double t = 1;
-    for (unsigned int j = 0; j < modelTerms[0].size(); j++)
-    {
-      t = t * std::pow(indepvar[j], modelTerms.at(i).at(j));
-    }
-    ypred = ypred + t * coefficients[i];
+    double coefficient = 0.;
+    for (int j = kNEMAAttenuationDegree - i; j >= 0; j--)
+      coefficient = coefficient * negativeAbsZ + kNEMAAttenuationCoefficients[i][j];
+    result = result * distanceXY + coefficient;
   }
-  return ypred;
+  return result;
+}
+
+// indepvar[0] = dist_xy
+// indepvar[1] = -abs(z) for NEMA Phantom only
+double SinogramCreatorTools::getPolyFit(const std::vector<double>& indepvar)
+{
+  assert(indepvar.size() >= 2);
+  return getPolyFit(indepvar[0], indepvar[1]);
+}
+
+void SinogramCreatorTools::getPolyFit(const double* distanceXY, const double* negativeAbsZ, std::size_t size, double* result)
+{
+  for (std::size_t i = 0; i < size; i++)
+    result[i] = getPolyFit(distanceXY[i], negativeAbsZ[i]);
 }
@@ -22,20 +22,104 @@
 #define override
 #endif
 
+#include <array>
+#include <atomic>
 #include <cmath>
 #include <tuple>
 #include <utility>
 #include <vector>
 #include "TVector3.h"
 
+/**
+ * @brief Line of response given by positions (in cm) and times (in ps) of both hits
+ */
+struct SinogramLOR
+{
+  float firstX;
+  float firstY;
+  float firstZ;
+  double firstTOF;
+  float secondX;
+  float secondY;
+  float secondZ;
+  double secondTOF;
+};
+
+/**
+ * @brief Binning of the sinogram used by SinogramCreatorTools::getSinogramBins
+ */
+struct SinogramBinning
+{
+  float maxReconstructionLayerRadius = 0.f; // in cm
+  float reconstructionDistanceAccuracy = 0.1f; // in cm
+  int maxDistanceNumber = 0;
+  int maxAngle = 180;
+  double tofSliceSize = 100.; // in ps
+  bool obliqueLORRemapping = false;
+  std::vector<std::pair<float, float>> zSplitRange;
+};
+
+/**
+ * @brief Sinogram bins of LORs in structure of arrays layout. LOR is outside of the sinogram if
+ * zSlice is -1, distance is not less than maxDistanceNumber or angle is not less than maxAngle.
+ */
+struct SinogramBins
+{
+  std::vector<int> distance;
+  std::vector<int> angle;
+  std::vector<int> zSlice;
+  std::vector<int> tofSlice;
+};
+
+/**
+ * @brief Numbers of LORs rejected during sinogram creation, counted per reason
+ *
+ * Counters are atomic, so they can be increased from many threads at once. Rejections are first
+ * counted for the whole batch of LORs and added once, so workers do not touch shared memory per LOR.
+ * shouldLog() allows to print only first kMaxLoggedRejections messages for every reason.
+ */
+class SinogramRejectionCounters
+{
+public:
+  enum Reason
+  {
+    kOutOfZRange = 0,
+    kDistanceOverflow,
+    kAngleOverflow,
+    kAttenuated,
+    kNumberOfReasons
+  };
+  static const unsigned int kMaxLoggedRejections = 10;
+
+  SinogramRejectionCounters();
+  SinogramRejectionCounters(const SinogramRejectionCounters&) = delete;
+  SinogramRejectionCounters& operator=(const SinogramRejectionCounters&) = delete;
+
+  void add(Reason reason, unsigned long long count = 1);
+  unsigned long long get(Reason reason) const;
+  unsigned long long getTotal() const;
+  bool shouldLog(Reason reason);
+  void reset();
+
+  static const char* getReasonName(Reason reason);
+
+private:
+  std::array<std::atomic<unsigned long long>, kNumberOfReasons> fCounters;
+  std::array<std::atomic<unsigned int>, kNumberOfReasons> fLoggedRejections;
+};
+
 class SinogramCreatorTools
 {
 public:
   static unsigned int roundToNearesMultiplicity(double numberToRound, double muliFactor);
   static std::pair<int, float> getAngleAndDistance(float firstX, float firstY, float secondX, float secondY);
 
+  /**
+   * @brief Returns (distance bin, angle bin) of the LOR. Bins are not checked against maxDistanceNumber and kReconstructionMaxAngle,
+   * caller has to reject LORs outside of the sinogram.
+   */
   static std::pair<int, int> getSinogramRepresentation(float firstX, float firstY, float secondX, float secondY, float fMaxReconstructionLayerRadius,
-                                                       float fReconstructionDistanceAccuracy, int maxDistanceNumber, int kReconstructionMaxAngle);
+                                                       float fReconstructionDistanceAccuracy);
 
   static float calculateLORSlice(float x1, float y1, float z1, double t1, float x2, float y2, float z2, double t2);
 
@@ -43,11 +127,24 @@ public:
   static int getSplitRangeNumber(float z, const std::vector<std::pair<float, float>>& zSplitRange);
   static int getSinogramSlice(float firstX, float firstY, float firstZ, double firstTOF, float secondX, float secondY, float secondZ,
                               double secondTOF, const std::vector<std::pair<float, float>>& zSplitRange);
-  static unsigned int getTOFSlice(double firstTOF, double secondTOF, double sliceSize);
+  static int getTOFSlice(double firstTOF, double secondTOF, double sliceSize);
+
+  /**
+   * @brief Maps all LORs to (distance bin, angle bin, z slice, TOF bin) in one pass, giving the same bins
+   * as getSinogramRepresentation, getSplitRangeNumber/getSinogramSlice and getTOFSlice called for each LOR.
+   * Z slice is found by index arithmetic, as zSplitRange is assumed to be made of equal consecutive ranges.
+   */
+  static void getSinogramBins(const SinogramLOR* lors, std::size_t numberOfLORs, const SinogramBinning& binning, SinogramBins& bins);
 
   static std::pair<TVector3,TVector3> remapToSingleLayer(const TVector3& firstHit, const TVector3& secondHit, const float radius);
 
-  static double getPolyFit(std::vector<double> indepvar);
+  /**
+   * @brief Probability of registering LOR from NEMA phantom, given by polynomial of 6th degree fitted to simulation,
+   * in distance of the annihilation point from the axis (dist_xy) and -|z|, both in cm.
+   */
+  static double getPolyFit(double distanceXY, double negativeAbsZ);
+  static double getPolyFit(const std::vector<double>& indepvar);
+  static void getPolyFit(const double* distanceXY, const double* negativeAbsZ, std::size_t size, double* result);
 
 private:
   SinogramCreatorTools() = delete;
@@ -32,7 +32,7 @@ BOOST_AUTO_TEST_CASE(test_angle_middle)
     const float x2 = r * std::cos((i + 180) * (M_PI / 180.f));
     const float y2 = r * std::sin((i + 180) * (M_PI / 180.f));
     const auto result =
-        SinogramCreatorTools::getSinogramRepresentation(x1, y1, x2, y2, maxDistance, accuracy, std::ceil(maxDistance * 2.f * (1.f / accuracy)), 180);
+        SinogramCreatorTools::getSinogramRepresentation(x1, y1, x2, y2, maxDistance, accuracy);
     int resultAngle = i < 90 ? 90 + i : i < 180 ? i - 90 : i < 270 ? i - 90 : i - 270;
     BOOST_REQUIRE_EQUAL(result.second, resultAngle);
     const float distanceResult = SinogramCreatorTools::roundToNearesMultiplicity(maxDistance, accuracy);
@@ -0,0 +1,65 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE DirectFourierReconstructionTest
+#include <boost/test/unit_test.hpp>
+
+#include "JPetDirectFourierReconstruction.h"
+#include "JPetFilterNone.h"
+#include "JPetRecoImageTools.h"
+#include "JPetSheppLoganPhantom.h"
+#include <cmath>
+
+BOOST_AUTO_TEST_SUITE(FirstSuite)
+
+BOOST_AUTO_TEST_CASE(kernel_test)
+{
+  BOOST_REQUIRE_CLOSE(JPetDirectFourierReconstruction::besselI0(0.), 1., 1e-12);
+  BOOST_REQUIRE_CLOSE(JPetDirectFourierReconstruction::besselI0(1.), 1.2660658777520082, 1e-10);
+  BOOST_REQUIRE_CLOSE(JPetDirectFourierReconstruction::besselI0(10.), 2815.716628466254, 1e-10);
+  const double beta = JPetDirectFourierReconstruction::getKernelBeta(2.);
+  const auto table = JPetDirectFourierReconstruction::getKernelTable(beta);
+  BOOST_REQUIRE_EQUAL(table.size(), JPetDirectFourierReconstruction::kKernelWidth * JPetDirectFourierReconstruction::kKernelTableDensity / 2 + 1u);
+  BOOST_REQUIRE_CLOSE(table.front(), JPetDirectFourierReconstruction::besselI0(beta), 1e-12);
+  BOOST_REQUIRE_CLOSE(table.back(), 1., 1e-12);
+  // deapodization is the integral of the kernel, in the center of image
+  double integral = 0.;
+  for (std::size_t i = 1; i < table.size(); i++)
+    integral += (table[i - 1] + table[i]) / JPetDirectFourierReconstruction::kKernelTableDensity;
+  BOOST_REQUIRE_CLOSE(JPetDirectFourierReconstruction::getDeapodization(0., 256, beta), integral, 1e-3);
+}
+
+BOOST_AUTO_TEST_CASE(sheppLogan_test)
+{
+  const int projectionLength = 129;
+  const int projectionAngles = 180;
+  const auto phantom = JPetSheppLoganPhantom::getSheppLogan(40.);
+  JPetFilterNone filter(1.);
+  const JPetSinogramType::Matrix reconstructed =
+      JPetDirectFourierReconstruction::reconstruct(JPetSheppLoganPhantom::getSinogram(phantom, projectionLength, projectionAngles), filter);
+  const int N = reconstructed.size1();
+  BOOST_REQUIRE_EQUAL(N, 90);
+  BOOST_REQUIRE_EQUAL(reconstructed.size2(), 90u);
+
+  const int center = (N + 1) / 2;
+  double errorSum = 0.;
+  double phantomSum = 0.;
+  for (int i = 0; i < N; i++)
+  {
+    for (int j = 0; j < N; j++)
+    {
+      const double expected = JPetSheppLoganPhantom::getPhantomValue(phantom, j - center + 1, center - 1 - i);
+      errorSum += (reconstructed(i, j) - expected) * (reconstructed(i, j) - expected);
+      phantomSum += expected * expected;
+    }
+  }
+  BOOST_REQUIRE_LT(std::sqrt(errorSum / phantomSum), 0.4);
+  // mean inside of the skull, in uniform region around (0, -16)
+  double mean = 0.;
+  for (int i = -3; i <= 3; i++)
+    for (int j = -3; j <= 3; j++)
+      mean += reconstructed(center - 1 + 16 + i, center - 1 + j) / 49.;
+  BOOST_REQUIRE_CLOSE(mean, JPetSheppLoganPhantom::getPhantomValue(phantom, 0., -16.), 10.);
+  // outside of the phantom
+  BOOST_REQUIRE_SMALL(reconstructed(2, 2), 0.05);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,121 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE LORFileToolsTest
+#include <boost/test/unit_test.hpp>
+
+#include "../LORFileTools.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+std::vector<SinogramLOR> readAll(const std::string& fileName, int numberOfThreads)
+{
+  std::vector<SinogramLOR> result;
+  LORFileTools::readLORFile(fileName, numberOfThreads,
+                            [&result](const std::vector<SinogramLOR>& lors) { result.insert(result.end(), lors.begin(), lors.end()); });
+  return result;
+}
+
+BOOST_AUTO_TEST_SUITE(FirstSuite)
+
+BOOST_AUTO_TEST_CASE(parseNumber_test) {
+  const std::vector<std::pair<std::string, double>> numbers = {
+      {"0", 0.}, {"12", 12.}, {"-3.25", -3.25}, {"+0.5", 0.5}, {"1e3", 1000.}, {"  -2.5E-2", -0.025}, {"1000000000123.5", 1000000000123.5}, {".75", 0.75}};
+  for (const auto& number : numbers)
+  {
+    double value = 0.;
+    const char* begin = number.first.c_str();
+    const char* end = begin + number.first.size();
+    BOOST_REQUIRE(LORFileTools::parseNumber(begin, end, value) == end);
+    BOOST_REQUIRE_CLOSE(value + 1., number.second + 1., 1e-12);
+  }
+  double value = 0.;
+  const std::string notNumber = "  abc";
+  BOOST_REQUIRE(!LORFileTools::parseNumber(notNumber.c_str(), notNumber.c_str() + notNumber.size(), value));
+}
+
+BOOST_AUTO_TEST_CASE(parseGojaChunk_test) {
+  const std::string goja = "1 2 3 100.5 -1 -2 -3 200.5 1 2 0.3 0.4 1 0 0 0\n"
+                           "\n"
+                           "1 2 3\n"
+                           "4.5 5 6 7 8 9 10 11 0 0 0 0 1 0 0 0";
+  std::vector<SinogramLOR> lors;
+  LORFileTools::parseGojaChunk(goja.c_str(), goja.c_str() + goja.size(), lors);
+  BOOST_REQUIRE_EQUAL(lors.size(), 2u);
+  BOOST_REQUIRE_EQUAL(lors[0].firstZ, 3.f);
+  BOOST_REQUIRE_EQUAL(lors[0].secondX, -1.f);
+  BOOST_REQUIRE_EQUAL(lors[0].secondTOF, 200.5);
+  BOOST_REQUIRE_EQUAL(lors[1].firstX, 4.5f);
+  BOOST_REQUIRE_EQUAL(lors[1].secondTOF, 11.);
+}
+
+BOOST_AUTO_TEST_CASE(convertGojaToBinary_test) {
+  std::ofstream goja("LORFileToolsTest.goja");
+  for (int i = 0; i < 1000; i++)
+    goja << i << " " << -i << " 0.5 " << 1000. + i << " 1 2 3 " << 2000. + 2 * i << " 1 2 0.3 0.4 1 0 0 0\n";
+  goja.close();
+
+  const auto fromText = readAll("LORFileToolsTest.goja", 1);
+  BOOST_REQUIRE_EQUAL(fromText.size(), 1000u);
+  const auto fromTextParallel = readAll("LORFileToolsTest.goja", 4);
+  BOOST_REQUIRE_EQUAL(fromTextParallel.size(), 1000u);
+  BOOST_REQUIRE(std::memcmp(fromText.data(), fromTextParallel.data(), fromText.size() * sizeof(SinogramLOR)) == 0);
+
+  BOOST_REQUIRE(!LORFileTools::isBinaryLORFile("LORFileToolsTest.goja"));
+  BOOST_REQUIRE(LORFileTools::convertGojaToBinary("LORFileToolsTest.goja", "LORFileToolsTest.bin", 2));
+  BOOST_REQUIRE(LORFileTools::isBinaryLORFile("LORFileToolsTest.bin"));
+  const auto fromBinary = readAll("LORFileToolsTest.bin", 1);
+  BOOST_REQUIRE_EQUAL(fromBinary.size(), 1000u);
+  for (unsigned int i = 0; i < fromBinary.size(); i++)
+  {
+    BOOST_REQUIRE_EQUAL(fromBinary[i].firstX, fromText[i].firstX);
+    BOOST_REQUIRE_EQUAL(fromBinary[i].firstY, fromText[i].firstY);
+    BOOST_REQUIRE_EQUAL(fromBinary[i].secondZ, fromText[i].secondZ);
+    BOOST_REQUIRE_EQUAL(fromBinary[i].secondTOF - fromBinary[i].firstTOF, fromText[i].secondTOF - fromText[i].firstTOF);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(binaryLORByteOrder_test) {
+  BinaryLORHeader header;
+  std::memcpy(header.magic, "JPETLOR", 8);
+  header.version = LORFileTools::kBinaryLORVersion;
+  header.recordSize = 32;
+  char bytes[sizeof(BinaryLORHeader)];
+  LORFileTools::writeBinaryLORHeader(header, bytes);
+  const unsigned char expectedNumbers[8] = {1, 0, 0, 0, 32, 0, 0, 0};
+  BOOST_REQUIRE(std::memcmp(bytes + 8, expectedNumbers, sizeof(expectedNumbers)) == 0);
+  const BinaryLORHeader readHeader = LORFileTools::readBinaryLORHeader(bytes);
+  BOOST_REQUIRE_EQUAL(readHeader.version, header.version);
+  BOOST_REQUIRE_EQUAL(readHeader.recordSize, header.recordSize);
+
+  std::ofstream goja("LORFileToolsByteOrderTest.goja");
+  goja << "1 2 3 0 4 5 6 10 1 2 0.3 0.4 1 0 0 0\n";
+  goja.close();
+  BOOST_REQUIRE(LORFileTools::convertGojaToBinary("LORFileToolsByteOrderTest.goja", "LORFileToolsByteOrderTest.bin"));
+  std::ifstream littleEndianFile("LORFileToolsByteOrderTest.bin", std::ios::binary);
+  std::vector<char> file((std::istreambuf_iterator<char>(littleEndianFile)), std::istreambuf_iterator<char>());
+  littleEndianFile.close();
+  BOOST_REQUIRE_EQUAL(file.size(), sizeof(BinaryLORHeader) + 32u);
+  // 1.0f is 0x3f800000, in little endian the last byte of the value is 0x3f
+  const unsigned char expectedFirstX[4] = {0x00, 0x00, 0x80, 0x3f};
+  BOOST_REQUIRE(std::memcmp(file.data() + sizeof(BinaryLORHeader), expectedFirstX, sizeof(expectedFirstX)) == 0);
+  const auto lors = readAll("LORFileToolsByteOrderTest.bin", 1);
+  BOOST_REQUIRE_EQUAL(lors.size(), 1u);
+  BOOST_REQUIRE_EQUAL(lors[0].firstX, 1.f);
+  BOOST_REQUIRE_EQUAL(lors[0].secondTOF - lors[0].firstTOF, 10.);
+
+  // the same file with all numbers in big endian order is rejected
+  for (std::size_t offset = 8; offset < file.size(); offset += 4)
+    std::reverse(file.begin() + offset, file.begin() + offset + 4);
+  std::ofstream bigEndianFile("LORFileToolsByteOrderTest.bin", std::ios::binary | std::ios::trunc);
+  bigEndianFile.write(file.data(), file.size());
+  bigEndianFile.close();
+  BOOST_REQUIRE(LORFileTools::isBinaryLORFile("LORFileToolsByteOrderTest.bin"));
+  BOOST_REQUIRE(!LORFileTools::readBinaryLORFile("LORFileToolsByteOrderTest.bin", [](const std::vector<SinogramLOR>&) {}));
+}
+
+BOOST_AUTO_TEST_CASE(readLORFile_no_file) {
+  BOOST_REQUIRE(!LORFileTools::readLORFile("blabalbaahl.goja", 1, [](const std::vector<SinogramLOR>&) {}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
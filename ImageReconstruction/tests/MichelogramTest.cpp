@@ -0,0 +1,121 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE MichelogramTest
+#include <boost/test/unit_test.hpp>
+
+#include "../Michelogram.h"
+#include <cstdio>
+
+MichelogramGeometry getTestGeometry(int span, int maxRingDifference)
+{
+  MichelogramGeometry geometry;
+  geometry.numberOfRings = 4;
+  geometry.zBegin = -20.f;
+  geometry.ringWidth = 10.f;
+  geometry.span = span;
+  geometry.maxRingDifference = maxRingDifference;
+  geometry.numberOfDistances = 101;
+  geometry.numberOfAngles = 180;
+  geometry.maxReconstructionLayerRadius = 50.f;
+  geometry.reconstructionDistanceAccuracy = 1.f;
+  geometry.tofSliceSize = 100.f;
+  geometry.maxTOF = 350.f;
+  return geometry;
+}
+
+SinogramBins getBins(const std::vector<SinogramLOR>& lors)
+{
+  SinogramBinning binning;
+  binning.maxReconstructionLayerRadius = 50.f;
+  binning.reconstructionDistanceAccuracy = 1.f;
+  binning.maxDistanceNumber = 101;
+  binning.zSplitRange = {{-20.f, -10.f}, {-10.f, 0.f}, {0.f, 10.f}, {10.f, 20.f}};
+  SinogramBins bins;
+  SinogramCreatorTools::getSinogramBins(lors.data(), lors.size(), binning, bins);
+  return bins;
+}
+
+BOOST_AUTO_TEST_SUITE(FirstSuite)
+
+BOOST_AUTO_TEST_CASE(segmentTable_test) {
+  const auto spanOne = Michelogram::getSegmentTable(4, 1, 3);
+  BOOST_REQUIRE_EQUAL(spanOne.size(), 7u);
+  const std::vector<int> segmentsOrder = {0, 1, -1, 2, -2, 3, -3};
+  const std::vector<unsigned int> planesOfSegments = {4, 3, 3, 2, 2, 1, 1};
+  unsigned int firstPlane = 0;
+  for (std::size_t i = 0; i < spanOne.size(); i++) {
+    BOOST_REQUIRE_EQUAL(spanOne[i].segment, segmentsOrder[i]);
+    BOOST_REQUIRE_EQUAL(spanOne[i].minRingDifference, segmentsOrder[i]);
+    BOOST_REQUIRE_EQUAL(spanOne[i].maxRingDifference, segmentsOrder[i]);
+    BOOST_REQUIRE_EQUAL(spanOne[i].numberOfPlanes, planesOfSegments[i]);
+    BOOST_REQUIRE_EQUAL(spanOne[i].firstPlane, firstPlane);
+    firstPlane += spanOne[i].numberOfPlanes;
+  }
+
+  const auto spanThree = Michelogram::getSegmentTable(4, 3, 3);
+  BOOST_REQUIRE_EQUAL(spanThree.size(), 3u);
+  BOOST_REQUIRE_EQUAL(spanThree[0].minRingDifference, -1);
+  BOOST_REQUIRE_EQUAL(spanThree[0].maxRingDifference, 1);
+  BOOST_REQUIRE_EQUAL(spanThree[0].numberOfPlanes, 7u);
+  BOOST_REQUIRE_EQUAL(spanThree[1].minRingDifference, 2);
+  BOOST_REQUIRE_EQUAL(spanThree[1].maxRingDifference, 3);
+  BOOST_REQUIRE_EQUAL(spanThree[1].numberOfPlanes, 3u);
+  BOOST_REQUIRE_EQUAL(spanThree[2].minRingDifference, -3);
+  BOOST_REQUIRE_EQUAL(spanThree[2].maxRingDifference, -2);
+}
+
+BOOST_AUTO_TEST_CASE(planes_test) {
+  const std::string fileName = "michelogramPlanesTest.bin";
+  Michelogram michelogram;
+  BOOST_REQUIRE(michelogram.create(fileName, getTestGeometry(1, 2)));
+  BOOST_REQUIRE_EQUAL(michelogram.getHeader().numberOfPlanes, 4u + 3u + 3u + 2u + 2u);
+  BOOST_REQUIRE_EQUAL(michelogram.getHeader().numberOfTOFBins, 7u);
+  BOOST_REQUIRE_EQUAL(michelogram.getPlane(0, 0), 0);
+  BOOST_REQUIRE_EQUAL(michelogram.getPlane(3, 3), 3);
+  BOOST_REQUIRE_EQUAL(michelogram.getPlane(1, 2), 5);
+  BOOST_REQUIRE_EQUAL(michelogram.getPlane(2, 1), 8);
+  BOOST_REQUIRE_EQUAL(michelogram.getPlane(0, 3), -1);
+  BOOST_REQUIRE_EQUAL(michelogram.getRing(-20.f), 0);
+  BOOST_REQUIRE_EQUAL(michelogram.getRing(20.f), 3);
+  BOOST_REQUIRE_EQUAL(michelogram.getRing(20.5f), -1);
+  BOOST_REQUIRE_EQUAL(michelogram.getRing(-20.5f), -1);
+  michelogram.close();
+  std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(fill_and_reopen_test) {
+  const std::string fileName = "michelogramFillTest.bin";
+  const std::vector<SinogramLOR> lors = {{-40.f, 10.f, -15.f, 0., 40.f, 10.f, 15.f, 250.},
+                                         {40.f, 10.f, 15.f, 250., -40.f, 10.f, -15.f, 0.},
+                                         {-40.f, 10.f, -15.f, 0., 40.f, 10.f, 15.f, 2000.},
+                                         {-40.f, 10.f, -15.f, 0., 40.f, 10.f, 25.f, 0.}};
+  const SinogramBins bins = getBins(lors);
+  {
+    Michelogram michelogram;
+    BOOST_REQUIRE(michelogram.create(fileName, getTestGeometry(1, -1)));
+    std::vector<int64_t> indices;
+    BOOST_REQUIRE_EQUAL(michelogram.getBinIndices(lors.data(), lors.size(), bins, indices), 2u);
+    BOOST_REQUIRE(indices[0] >= 0);
+    BOOST_REQUIRE_EQUAL(indices[0], indices[1]);
+    BOOST_REQUIRE_EQUAL(indices[2], -1);
+    BOOST_REQUIRE_EQUAL(indices[3], -1);
+    michelogram.addCounts(indices);
+  }
+  Michelogram michelogram;
+  BOOST_REQUIRE(michelogram.open(fileName));
+  BOOST_REQUIRE_EQUAL(michelogram.getHeader().numberOfPlanes, 16u);
+  double total = 0.;
+  for (std::size_t i = 0; i < michelogram.getNumberOfBins(); i++) {
+    total += michelogram.data()[i];
+  }
+  BOOST_REQUIRE_CLOSE(total, 2., 1e-9);
+  // direction of angle 90 is negative x, so rings and sign of TOF of the first LOR are swapped
+  const float* sinogram = michelogram.getSinogram(michelogram.getPlane(3, 0), -1);
+  BOOST_REQUIRE_EQUAL(bins.angle[0], 90);
+  BOOST_REQUIRE_CLOSE(sinogram[bins.distance[0] * 180 + 90], 2.f, 1e-6);
+  michelogram.close();
+  std::remove(fileName.c_str());
+
+  BOOST_REQUIRE(!michelogram.open(fileName));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,163 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE OSEMReconstructionTest
+#include <boost/test/unit_test.hpp>
+
+#include "JPetOSEMReconstruction.h"
+#include <cmath>
+
+const int kProjectionLength = 65;
+const int kProjectionAngles = 60;
+
+// image of the size used by JPetOSEMReconstruction: uniform disk with hot spot
+JPetSinogramType::Matrix getPhantom(int imageSize)
+{
+  JPetSinogramType::Matrix image(imageSize, imageSize);
+  const double center = (imageSize - 1) / 2.;
+  for (int i = 0; i < imageSize; i++)
+  {
+    for (int j = 0; j < imageSize; j++)
+    {
+      const double x = j - center;
+      const double y = center - i;
+      if (x * x + y * y < 0.35 * imageSize * 0.35 * imageSize)
+        image(i, j) = 1.;
+      if ((x - 5.) * (x - 5.) + (y - 3.) * (y - 3.) < 16.)
+        image(i, j) = 4.;
+    }
+  }
+  return image;
+}
+
+std::vector<int> getAllAngles()
+{
+  std::vector<int> angles;
+  for (int angle = 0; angle < kProjectionAngles; angle++)
+    angles.push_back(angle);
+  return angles;
+}
+
+double getRelativeError(const JPetSinogramType::Matrix& image, const JPetSinogramType::Matrix& phantom)
+{
+  double difference = 0.;
+  double norm = 0.;
+  for (std::size_t p = 0; p < image.size(); p++)
+  {
+    difference += (image.data()[p] - phantom.data()[p]) * (image.data()[p] - phantom.data()[p]);
+    norm += phantom.data()[p] * phantom.data()[p];
+  }
+  return std::sqrt(difference / norm);
+}
+
+BOOST_AUTO_TEST_SUITE(OSEMReconstructionTestSuite)
+
+BOOST_AUTO_TEST_CASE(imageSizeTest)
+{
+  JPetOSEMReconstruction reconstruction(kProjectionLength, kProjectionAngles);
+  BOOST_REQUIRE_EQUAL(reconstruction.getImageSize(), 44);
+  reconstruction.setNumberOfSubsets(0);
+  BOOST_REQUIRE_EQUAL(reconstruction.getNumberOfSubsets(), 1);
+  reconstruction.setNumberOfSubsets(1000);
+  BOOST_REQUIRE_EQUAL(reconstruction.getNumberOfSubsets(), kProjectionAngles);
+  BOOST_REQUIRE_EQUAL(reconstruction.reconstruct(JPetSinogramType::Matrix(10, 10), 1).size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(backProjectionIsTransposeOfProjectionTest)
+{
+  JPetOSEMReconstruction reconstruction(kProjectionLength, kProjectionAngles);
+  const int imageSize = reconstruction.getImageSize();
+  JPetSinogramType::Matrix image(imageSize, imageSize);
+  JPetSinogramType::Matrix sinogram(kProjectionLength, kProjectionAngles);
+  for (std::size_t p = 0; p < image.size(); p++)
+    image.data()[p] = std::sin(0.37 * p) + 1.;
+  for (std::size_t p = 0; p < sinogram.size(); p++)
+    sinogram.data()[p] = std::cos(0.11 * p) + 1.;
+
+  JPetSinogramType::Matrix projected(kProjectionLength, kProjectionAngles);
+  JPetSinogramType::Matrix backProjected(imageSize, imageSize);
+  reconstruction.forwardProject(image, projected, getAllAngles());
+  reconstruction.backProject(sinogram, backProjected, getAllAngles());
+
+  double sinogramProduct = 0.;
+  for (std::size_t p = 0; p < sinogram.size(); p++)
+    sinogramProduct += projected.data()[p] * sinogram.data()[p];
+  double imageProduct = 0.;
+  for (std::size_t p = 0; p < image.size(); p++)
+    imageProduct += image.data()[p] * backProjected.data()[p];
+  BOOST_REQUIRE_CLOSE(sinogramProduct, imageProduct, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(projectionOfUniformImageTest)
+{
+  // LOR through the center crosses whole image, its projection is its length, independently of the angle
+  JPetOSEMReconstruction reconstruction(kProjectionLength, 4);
+  const int imageSize = reconstruction.getImageSize();
+  JPetSinogramType::Matrix sinogram(kProjectionLength, 4);
+  reconstruction.forwardProject(JPetSinogramType::Matrix(imageSize, imageSize, 1.), sinogram, {0, 2});
+  const int ctrIdx = std::ceil(kProjectionLength / 2.);
+  BOOST_REQUIRE_CLOSE(sinogram(ctrIdx, 0), imageSize, 1e-9);
+  BOOST_REQUIRE_CLOSE(sinogram(ctrIdx, 2), imageSize, 1e-9);
+  BOOST_REQUIRE_EQUAL(sinogram(ctrIdx, 1), 0.);
+}
+
+BOOST_AUTO_TEST_CASE(convergenceTest)
+{
+  JPetOSEMReconstruction reconstruction(kProjectionLength, kProjectionAngles);
+  reconstruction.setNumberOfSubsets(6);
+  const JPetSinogramType::Matrix phantom = getPhantom(reconstruction.getImageSize());
+  JPetSinogramType::Matrix sinogram(kProjectionLength, kProjectionAngles);
+  reconstruction.forwardProject(phantom, sinogram, getAllAngles());
+
+  std::vector<double> errors;
+  const JPetSinogramType::Matrix result = reconstruction.reconstruct(
+      sinogram, 20, [&](int iteration, const JPetSinogramType::Matrix& image) {
+        BOOST_REQUIRE_EQUAL(iteration, (int)errors.size() + 1);
+        errors.push_back(getRelativeError(image, phantom));
+      });
+  BOOST_REQUIRE_EQUAL(errors.size(), 20u);
+  BOOST_REQUIRE_LT(errors.back(), errors.front());
+  BOOST_REQUIRE_LT(errors.back(), 0.1);
+  BOOST_REQUIRE_EQUAL(getRelativeError(result, phantom), errors.back());
+}
+
+BOOST_AUTO_TEST_CASE(threadsAndTOFWindowsTest)
+{
+  JPetOSEMReconstruction reconstruction(kProjectionLength, kProjectionAngles);
+  reconstruction.setNumberOfSubsets(4);
+  const JPetSinogramType::Matrix phantom = getPhantom(reconstruction.getImageSize());
+  JPetSinogramType::Matrix sinogram(kProjectionLength, kProjectionAngles);
+  reconstruction.forwardProject(phantom, sinogram, getAllAngles());
+  const JPetSinogramType::Matrix singleThread = reconstruction.reconstruct(sinogram, 3);
+
+  // sinogram split into two TOF windows gives the same sum
+  JPetSinogramType::Matrix3D tofSinogram;
+  tofSinogram[-1] = sinogram;
+  tofSinogram[1] = sinogram;
+  for (std::size_t p = 0; p < sinogram.size(); p++)
+  {
+    tofSinogram[-1].data()[p] *= 0.25;
+    tofSinogram[1].data()[p] *= 0.75;
+  }
+  reconstruction.setNumberOfThreads(4);
+  const JPetSinogramType::Matrix multiThread = reconstruction.reconstruct(tofSinogram, 3);
+
+  BOOST_REQUIRE_EQUAL(multiThread.size(), singleThread.size());
+  for (std::size_t p = 0; p < singleThread.size(); p++)
+    BOOST_REQUIRE_SMALL(multiThread.data()[p] - singleThread.data()[p], 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(emptySliceTest)
+{
+  // slice where no LOR fell has no TOF windows
+  JPetOSEMReconstruction reconstruction(kProjectionLength, kProjectionAngles);
+  reconstruction.setNumberOfSubsets(4);
+  int checkpoints = 0;
+  const JPetSinogramType::Matrix result =
+      reconstruction.reconstruct(JPetSinogramType::Matrix3D(), 3, [&](int, const JPetSinogramType::Matrix&) { checkpoints++; });
+  BOOST_REQUIRE_EQUAL(checkpoints, 3);
+  BOOST_REQUIRE_EQUAL(result.size1(), (std::size_t)reconstruction.getImageSize());
+  BOOST_REQUIRE_EQUAL(result.size2(), (std::size_t)reconstruction.getImageSize());
+  for (std::size_t p = 0; p < result.size(); p++)
+    BOOST_REQUIRE_EQUAL(result.data()[p], 0.);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,103 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE RecoImageToolsTest
+#include <boost/test/unit_test.hpp>
+
+#include "JPetRecoImageTools.h"
+#include <fstream>
+#include <iterator>
+
+JPetSinogramType::Matrix getMatrix(const std::vector<double>& values, int rows, int columns)
+{
+  JPetSinogramType::Matrix matrix(rows, columns);
+  std::copy(values.begin(), values.end(), matrix.data());
+  return matrix;
+}
+
+std::string readFile(const std::string& fileName)
+{
+  std::ifstream file(fileName, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+BOOST_AUTO_TEST_SUITE(RecoImageToolsTestSuite)
+
+BOOST_AUTO_TEST_CASE(matrixAtTest)
+{
+  JPetSinogramType::Matrix matrix = getMatrix({1, 2, 3, 4, 5, 6}, 2, 3);
+  BOOST_REQUIRE_EQUAL(matrix.at(1, 2), 6.);
+  matrix.at(0, 1) = 7.;
+  BOOST_REQUIRE_EQUAL(matrix(0, 1), 7.);
+  BOOST_REQUIRE_THROW(matrix.at(2, 0), std::out_of_range);
+  BOOST_REQUIRE_THROW(matrix.at(0, 3), std::out_of_range);
+  const JPetSinogramType::Matrix empty;
+  BOOST_REQUIRE_THROW(empty.at(0, 0), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(rescaleTest)
+{
+  JPetSinogramType::Matrix matrix = getMatrix({5, 2, 1, 2}, 2, 2);
+  JPetRecoImageTools::rescale(matrix, 0, 2);
+  BOOST_REQUIRE_CLOSE(matrix(0, 0), 2, 1e-9);
+  BOOST_REQUIRE_CLOSE(matrix(0, 1), 0.5, 1e-9);
+  BOOST_REQUIRE_SMALL(matrix(1, 0), 1e-9);
+  BOOST_REQUIRE_CLOSE(matrix(1, 1), 0.5, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(rescaleWithCutoffTest)
+{
+  // first value is below the cutoff, so background is the cutoff: 2, 3, 2, 5 -> 0, 1, 0, 3
+  JPetSinogramType::Matrix matrix = getMatrix({-4, 3, 1, 5}, 2, 2);
+  JPetRecoImageTools::rescale(matrix, 2, 8);
+  BOOST_REQUIRE_SMALL(matrix(0, 0), 1e-9);
+  BOOST_REQUIRE_CLOSE(matrix(0, 1), 8. / 3., 1e-9);
+  BOOST_REQUIRE_SMALL(matrix(1, 0), 1e-9);
+  BOOST_REQUIRE_CLOSE(matrix(1, 1), 8., 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(rescaleConstantTest)
+{
+  JPetSinogramType::Matrix matrix = getMatrix({3, 3, 3, 3}, 2, 2);
+  JPetRecoImageTools::rescale(matrix, 0, 10);
+  for (std::size_t i = 0; i < matrix.size(); i++)
+    BOOST_REQUIRE_EQUAL(matrix.data()[i], 3.);
+}
+
+BOOST_AUTO_TEST_CASE(statisticsTest)
+{
+  const JPetSinogramType::Matrix matrix = getMatrix({-1.5, 7.25, 2, 0.25, 3, -0.5}, 2, 3);
+  const auto statistics = JPetRecoImageTools::getStatistics(matrix);
+  BOOST_REQUIRE_EQUAL(statistics.min, -1.5);
+  BOOST_REQUIRE_EQUAL(statistics.max, 7.25);
+  BOOST_REQUIRE_CLOSE(statistics.sum, 10.5, 1e-9);
+  BOOST_REQUIRE_EQUAL(JPetRecoImageTools::getMaxValue(matrix), 7);
+  BOOST_REQUIRE_EQUAL(JPetRecoImageTools::getMaxValue(getMatrix({-3, -2}, 1, 2)), 0);
+}
+
+BOOST_AUTO_TEST_CASE(savePGMTest)
+{
+  BOOST_REQUIRE(JPetRecoImageTools::savePGM(getMatrix({-1, 2.6, 255, 0}, 2, 2), "recoImageToolsTest8bit.pgm"));
+  BOOST_REQUIRE_EQUAL(readFile("recoImageToolsTest8bit.pgm"), std::string("P5\n2 2\n255\n\x00\x03\xFF\x00", 15));
+
+  BOOST_REQUIRE(JPetRecoImageTools::savePGM(getMatrix({10000, 1, 70000}, 1, 3), "recoImageToolsTest16bit.pgm"));
+  BOOST_REQUIRE_EQUAL(readFile("recoImageToolsTest16bit.pgm"), std::string("P5\n3 1\n65535\n\x27\x10\x00\x01\xFF\xFF", 19));
+}
+
+BOOST_AUTO_TEST_CASE(saveNRRDTest)
+{
+  const JPetSinogramType::Matrix matrix = getMatrix({-1.5, 2, 3.25, 4, 5, 6}, 2, 3);
+  BOOST_REQUIRE(JPetRecoImageTools::saveNRRD(matrix, "recoImageToolsTest.nrrd"));
+  const std::string content = readFile("recoImageToolsTest.nrrd");
+  const std::size_t headerEnd = content.find("\n\n");
+  BOOST_REQUIRE(headerEnd != std::string::npos);
+  const std::string header = content.substr(0, headerEnd + 2);
+  BOOST_REQUIRE(header.find("NRRD0004\n") == 0);
+  BOOST_REQUIRE(header.find("type: float\n") != std::string::npos);
+  BOOST_REQUIRE(header.find("sizes: 3 2\n") != std::string::npos);
+  BOOST_REQUIRE_EQUAL(content.size(), header.size() + matrix.size() * sizeof(float));
+  std::vector<float> values(matrix.size());
+  std::copy(content.begin() + header.size(), content.end(), reinterpret_cast<char*>(values.data()));
+  for (std::size_t i = 0; i < matrix.size(); i++)
+    BOOST_REQUIRE_EQUAL(values[i], (float)matrix.data()[i]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,7 @@
 
 #include "../SinogramCreatorTools.h"
 #include <iostream>
+#include <thread>
 
 BOOST_AUTO_TEST_SUITE(FirstSuite)
 
@@ -40,8 +41,7 @@ BOOST_AUTO_TEST_CASE(test_angle_middle) {
     const float x2 = r * std::cos(angle2);
     const float y2 = r * std::sin(angle2);
     const auto result = SinogramCreatorTools::getSinogramRepresentation(
-        x1, y1, x2, y2, maxDistance, accuracy,
-        std::ceil(maxDistance * 2.f * (1.f / accuracy)), 180);
+        x1, y1, x2, y2, maxDistance, accuracy);
     int resultAngle =
         i < 90 ? 90 + i : i < 180 ? i - 90 : i < 270 ? i - 90 : i - 270;
     BOOST_REQUIRE_EQUAL(result.second, resultAngle);
@@ -211,5 +211,120 @@ BOOST_AUTO_TEST_CASE(polyfit_test) {
       7.430144030486940e-01, kEPSILON);
 }
 
+BOOST_AUTO_TEST_CASE(polyfit_batch_test) {
+  const std::vector<double> distances = {0., 5., 14.26, 9.61, 12.12, 9.08};
+  const std::vector<double> z = {0., -1., -3.39, -2.49, -2.72, -4.77};
+  std::vector<double> results(distances.size());
+  SinogramCreatorTools::getPolyFit(distances.data(), z.data(), distances.size(), results.data());
+  for (std::size_t i = 0; i < distances.size(); i++) {
+    BOOST_REQUIRE_EQUAL(results[i], SinogramCreatorTools::getPolyFit(distances[i], z[i]));
+    BOOST_REQUIRE_EQUAL(results[i], SinogramCreatorTools::getPolyFit({distances[i], z[i]}));
+  }
+  BOOST_REQUIRE_CLOSE(results[0], 0.2797848665191068, 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(getSinogramBins_test) {
+  const float maxDistance = 20.f;
+  const float accuracy = 0.1f;
+  const int maxDistanceNumber = std::ceil(maxDistance * 2.f * (1.f / accuracy));
+  SinogramBinning binning;
+  binning.maxReconstructionLayerRadius = maxDistance;
+  binning.reconstructionDistanceAccuracy = accuracy;
+  binning.maxDistanceNumber = maxDistanceNumber;
+  binning.tofSliceSize = 50.;
+  const int zSplitNumber = 5;
+  const float zRange = 50.f / zSplitNumber;
+  for (int i = 0; i < zSplitNumber; i++)
+    binning.zSplitRange.push_back(std::make_pair(i * zRange - 25.f, (i + 1) * zRange - 25.f));
+
+  std::vector<SinogramLOR> lors;
+  for (int i = 0; i < 360; i++) {
+    const float angle1 = (i + 45) * 0.0174532925;
+    const float angle2 = (i + 135) * 0.0174532925;
+    lors.push_back({10.f * std::cos(angle1), 10.f * std::sin(angle1), -25.f + i * 0.14f, 100.f * i,
+                    10.f * std::cos(angle2), 10.f * std::sin(angle2), -25.f + i * 0.139f, 3.f * i * i});
+  }
+  lors.push_back({0.f, 10.f, 15.f, 0., 0.f, -10.f, 15.f, 0.});
+  lors.push_back({5.f, 10.f, -5.f, 0., 5.f, -10.f, 5.f, 0.});
+  lors.push_back({-10.f, -3.f, 0.f, 0., 10.f, -3.f, 0.f, 0.});
+  lors.push_back({-10.f, -10.f, 25.f, 0., 10.f, 10.f, 25.f, 0.});
+  lors.push_back({-10.f, -10.f, 26.f, 0., 10.f, 10.f, 0.f, 0.});
+
+  for (bool oblique : {false, true}) {
+    binning.obliqueLORRemapping = oblique;
+    SinogramBins bins;
+    SinogramCreatorTools::getSinogramBins(lors.data(), lors.size(), binning, bins);
+    BOOST_REQUIRE_EQUAL(bins.distance.size(), lors.size());
+    for (unsigned int i = 0; i < lors.size(); i++) {
+      const auto& lor = lors[i];
+      const auto representation = SinogramCreatorTools::getSinogramRepresentation(
+          lor.firstX, lor.firstY, lor.secondX, lor.secondY, maxDistance, accuracy);
+      BOOST_REQUIRE_EQUAL(bins.distance[i], representation.first);
+      BOOST_REQUIRE_EQUAL(bins.angle[i], representation.second);
+      const int zSlice = oblique
+          ? SinogramCreatorTools::getSinogramSlice(lor.firstX, lor.firstY, lor.firstZ, lor.firstTOF, lor.secondX, lor.secondY,
+                                                   lor.secondZ, lor.secondTOF, binning.zSplitRange)
+          : SinogramCreatorTools::getSplitRangeNumber(lor.firstZ, lor.secondZ, binning.zSplitRange);
+      BOOST_REQUIRE_EQUAL(bins.zSlice[i], zSlice);
+      BOOST_REQUIRE_EQUAL(bins.tofSlice[i], SinogramCreatorTools::getTOFSlice(lor.firstTOF, lor.secondTOF, binning.tofSliceSize));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(getTOFSlice_test) {
+  BOOST_REQUIRE_EQUAL(SinogramCreatorTools::getTOFSlice(0., 0., 50.), 0);
+  BOOST_REQUIRE_EQUAL(SinogramCreatorTools::getTOFSlice(0., 250., 50.), 2);
+  BOOST_REQUIRE_EQUAL(SinogramCreatorTools::getTOFSlice(250., 0., 50.), -2);
+  BOOST_REQUIRE_EQUAL(SinogramCreatorTools::getTOFSlice(1000., 300., 50.), -7);
+  BOOST_REQUIRE_EQUAL(SinogramCreatorTools::getTOFSlice(60., 0., 50.), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_angle_vertical_and_horizontal) {
+  auto result = SinogramCreatorTools::getAngleAndDistance(5.f, 10.f, 5.f, -10.f);
+  BOOST_REQUIRE_EQUAL(result.first, 0);
+  BOOST_REQUIRE_CLOSE(result.second, 5.f, 0.001f);
+  result = SinogramCreatorTools::getAngleAndDistance(-10.f, -3.f, 10.f, -3.f);
+  BOOST_REQUIRE_EQUAL(result.first, 90);
+  BOOST_REQUIRE_CLOSE(result.second, -3.f, 0.001f);
+  result = SinogramCreatorTools::getAngleAndDistance(-10.f, -10.f, 10.f, 10.f);
+  BOOST_REQUIRE_EQUAL(result.first, 135);
+  BOOST_REQUIRE_SMALL(result.second, 0.001f);
+}
+
+BOOST_AUTO_TEST_CASE(rejectionCounters_test) {
+  SinogramRejectionCounters counters;
+  BOOST_REQUIRE_EQUAL(counters.getTotal(), 0u);
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 4; t++) {
+    workers.emplace_back([&counters]() {
+      for (int i = 0; i < 1000; i++) {
+        counters.add(SinogramRejectionCounters::kOutOfZRange);
+      }
+      counters.add(SinogramRejectionCounters::kDistanceOverflow, 5);
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  BOOST_REQUIRE_EQUAL(counters.get(SinogramRejectionCounters::kOutOfZRange), 4000u);
+  BOOST_REQUIRE_EQUAL(counters.get(SinogramRejectionCounters::kDistanceOverflow), 20u);
+  BOOST_REQUIRE_EQUAL(counters.get(SinogramRejectionCounters::kAngleOverflow), 0u);
+  BOOST_REQUIRE_EQUAL(counters.getTotal(), 4020u);
+
+  unsigned int logged = 0;
+  for (unsigned int i = 0; i < 3 * SinogramRejectionCounters::kMaxLoggedRejections; i++) {
+    if (counters.shouldLog(SinogramRejectionCounters::kAttenuated)) {
+      logged++;
+    }
+  }
+  BOOST_REQUIRE_EQUAL(logged, SinogramRejectionCounters::kMaxLoggedRejections);
+  BOOST_REQUIRE(counters.shouldLog(SinogramRejectionCounters::kOutOfZRange));
+
+  counters.reset();
+  BOOST_REQUIRE_EQUAL(counters.getTotal(), 0u);
+  BOOST_REQUIRE(counters.shouldLog(SinogramRejectionCounters::kAttenuated));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
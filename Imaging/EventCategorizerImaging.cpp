@@ -72,7 +72,19 @@ bool EventCategorizerImaging::init()
   } else {
     WARNING("No TOT calculation option given by the user. Using standard sum.");
   }
-  
+
+  fTOTType = HitFinderTools::getTOTCalculationType(fTOTCalculationType);
+  fCategorizerEngine = EventCategorizerEngine(fTOTType);
+  fCategorizerEngine.addPairPredicate(JPetEventType::k2Gamma,
+    EventCategorizerEngine::make2GammaPredicate(
+      getStatistics(), fSaveControlHistos, fBackToBackAngleWindow, fMaxTimeDiff
+    )
+  );
+  fCategorizerEngine.addTriplePredicate(JPetEventType::k3Gamma,
+    EventCategorizerEngine::make3GammaPredicate(getStatistics(), fSaveControlHistos),
+    !fSaveControlHistos
+  );
+
   if(fSaveControlHistos) initialiseHistograms();
   return true;
 }
@@ -85,8 +97,7 @@ bool EventCategorizerImaging::exec()
     for (uint i = 0; i < n; ++i) {
       const auto& event = dynamic_cast<const JPetEvent&>(timeWindow->operator[](i));
       if (event.getHits().size() > 1) {
-        vector<JPetHit> hits = event.getHits();
-        JPetEvent imagingEvent = imageReconstruction(hits);
+        JPetEvent imagingEvent = imageReconstruction(event.getHits());
         if (imagingEvent.getHits().size()) { events.push_back(imagingEvent); }
       }
     }
@@ -111,20 +122,20 @@ void EventCategorizerImaging::saveEvents(const vector<JPetEvent>& events)
   }
 }
 
-JPetEvent EventCategorizerImaging::imageReconstruction(vector<JPetHit> hits)
+JPetEvent EventCategorizerImaging::imageReconstruction(const vector<JPetHit>& hits)
 {
   JPetEvent imagingEvent;
+  fImagingHits.clear();
   for (unsigned i = 0; i < hits.size(); i++) {
-    double TOTofHit = HitFinderTools::calculateTOT(hits[i], HitFinderTools::getTOTCalculationType(fTOTCalculationType));
-    if (TOTofHit >= fMinAnnihilationTOT && TOTofHit <= fMaxAnnihilationTOT && fabs(hits[i].getPosZ()) < fMaxZPos) {
+    HitFeatures hitFeatures = EventCategorizerEngine::computeFeatures(hits[i], fTOTType);
+    if (hitFeatures.tot >= fMinAnnihilationTOT && hitFeatures.tot <= fMaxAnnihilationTOT
+      && fabs(hitFeatures.pos.Z()) < fMaxZPos) {
       imagingEvent.addHit(hits[i]);
+      fImagingHits.push_back(hitFeatures);
     }
   }
-  if (EventCategorizerTools::checkFor2Gamma(imagingEvent, getStatistics(), fSaveControlHistos, fBackToBackAngleWindow, fMaxTimeDiff)) {
-    imagingEvent.addEventType(JPetEventType::k2Gamma);
-  }
-  if (EventCategorizerTools::checkFor3Gamma(imagingEvent, getStatistics(), fSaveControlHistos)) {
-    imagingEvent.addEventType(JPetEventType::k3Gamma);
+  for (auto type : fCategorizerEngine.categorize(fImagingHits)) {
+    imagingEvent.addEventType(type);
   }
   return imagingEvent;
 }
@@ -16,6 +16,8 @@
 #ifndef EVENTCATEGORIZERIMAGING_H
 #define EVENTCATEGORIZERIMAGING_H
 
+#include "../LargeBarrelAnalysis/EventCategorizerEngine.h"
+#include "../LargeBarrelAnalysis/HitFinderTools.h"
 #include <JPetStatistics/JPetStatistics.h>
 #include <JPetEventType/JPetEventType.h>
 #include <JPetUserTask/JPetUserTask.h>
@@ -38,7 +40,7 @@ public:
 	virtual bool init() override;
 	virtual bool exec() override;
 	virtual bool terminate() override;
-	JPetEvent imageReconstruction(std::vector<JPetHit> hits);
+	JPetEvent imageReconstruction(const std::vector<JPetHit>& hits);
 
 protected:
 	const std::string kMaxDistOfDecayPlaneFromCenterParamKey = "EventCategorizer_MaxDistOfDecayPlaneFromCenter_float";
@@ -59,6 +61,9 @@ protected:
 	double fMaxZPos = 23.;
 	bool fSaveControlHistos = true;
     std::string fTOTCalculationType = "";
+	HitFinderTools::TOTCalculationType fTOTType = HitFinderTools::kSimplified;
+	EventCategorizerEngine fCategorizerEngine;
+	std::vector<HitFeatures> fImagingHits;
 	void saveEvents(const std::vector<JPetEvent>& event);
     void initialiseHistograms();
 };
@@ -19,6 +19,7 @@
 #include <sstream>
 #include <cctype>
 #include "InterThresholdCalibration.h"
+#include "../LargeBarrelAnalysis/SlimSignalTools.h"
 #include <TF1.h>
 #include <TString.h>
 #include <TDirectory.h>
@@ -134,6 +135,10 @@ bool InterThresholdCalibration::exec()
 
     for (uint i = 0; i < n; ++i) {
       const JPetHit& hit = dynamic_cast<const JPetHit&>(timeWindow->operator[](i));
+      if (SlimSignalTools::isSlimHit(hit)) {
+        ERROR("Hits saved with HitFinder_SlimHits_bool option have no Signal Channels, they can not be used for calibration.");
+        return false;
+      }
 
       fhitsCalib.push_back(hit);
 
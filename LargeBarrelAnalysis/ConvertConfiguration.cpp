@@ -0,0 +1,30 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *  @file ConvertConfiguration.cpp
+ */
+
+#include "UniversalFileLoader.h"
+#include <iostream>
+
+/**
+ * Converter of ASCII files with configuration parameters (time calibration,
+ * thresholds, velocities) to the binary format read by UniversalFileLoader
+ */
+int main(int argc, const char* argv[])
+{
+  if (argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " <input ASCII file> <output binary file>" << std::endl;
+    return 1;
+  }
+  return UniversalFileLoader::convertToBinaryConfFile(argv[1], argv[2]) ? 0 : 1;
+}
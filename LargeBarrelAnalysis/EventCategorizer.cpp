@@ -15,7 +15,9 @@
 
 #include <JPetOptionsTools/JPetOptionsTools.h>
 #include <JPetWriter/JPetWriter.h>
+#include "EventCategorizerEngine.h"
 #include "EventCategorizerTools.h"
+#include "HitFinderTools.h"
 #include "EventCategorizer.h"
 #include <iostream>
 
@@ -80,6 +82,38 @@ bool EventCategorizer::init()
   }
 
 
+  // Predicates are evaluated in the order of the previous checks:
+  // 2 gamma, 3 gamma, prompt and scatter
+  fCategorizerEngine = EventCategorizerEngine(
+    HitFinderTools::getTOTCalculationType(fTOTCalculationType)
+  );
+  fCategorizerEngine.addPairPredicate(JPetEventType::k2Gamma,
+    EventCategorizerEngine::make2GammaPredicate(
+      getStatistics(), fSaveControlHistos, fB2BSlotThetaDiff, fMaxTimeDiff
+    )
+  );
+  fCategorizerEngine.addTriplePredicate(JPetEventType::k3Gamma,
+    EventCategorizerEngine::make3GammaPredicate(getStatistics(), fSaveControlHistos),
+    !fSaveControlHistos
+  );
+  fCategorizerEngine.addHitPredicate(JPetEventType::kPrompt,
+    EventCategorizerEngine::makePromptPredicate(
+      getStatistics(), fSaveControlHistos, fDeexTOTCutMin, fDeexTOTCutMax
+    )
+  );
+  fCategorizerEngine.addPairPredicate(JPetEventType::kScattered,
+    EventCategorizerEngine::makeScatterPredicate(
+      getStatistics(), fSaveControlHistos, fScatterTOFTimeDiff
+    )
+  );
+
+  // Optional flat output next to the events
+  if (isOptionSet(fParams.getOptions(), kColumnarOutputFileParamKey)) {
+    fColumnarWriter.reset(new EventColumnarWriter(
+      getOptionAsString(fParams.getOptions(), kColumnarOutputFileParamKey)
+    ));
+  }
+
   // Input events type
   fOutputEvents = new JPetTimeWindow("JPetEvent");
   // Initialise hisotgrams
@@ -91,35 +125,26 @@ bool EventCategorizer::exec()
 {
   if (auto timeWindow = dynamic_cast<const JPetTimeWindow* const>(fEvent)) {
     vector<JPetEvent> events;
+    events.reserve(timeWindow->getNumberOfEvents());
     for (uint i = 0; i < timeWindow->getNumberOfEvents(); i++) {
       const auto& event = dynamic_cast<const JPetEvent&>(timeWindow->operator[](i));
 
-      // Check types of current event
-      bool is2Gamma = EventCategorizerTools::checkFor2Gamma(
-        event, getStatistics(), fSaveControlHistos, fB2BSlotThetaDiff, fMaxTimeDiff
-      );
-      bool is3Gamma = EventCategorizerTools::checkFor3Gamma(
-        event, getStatistics(), fSaveControlHistos
-      );
-      bool isPrompt = EventCategorizerTools::checkForPrompt(
-        event, getStatistics(), fSaveControlHistos, fDeexTOTCutMin, fDeexTOTCutMax, fTOTCalculationType
-      );
-      bool isScattered = EventCategorizerTools::checkForScatter(
-        event, getStatistics(), fSaveControlHistos, fScatterTOFTimeDiff, fTOTCalculationType
-      );
-
-      JPetEvent newEvent = event;
-      if(is2Gamma) newEvent.addEventType(JPetEventType::k2Gamma);
-      if(is3Gamma) newEvent.addEventType(JPetEventType::k3Gamma);
-      if(isPrompt) newEvent.addEventType(JPetEventType::kPrompt);
-      if(isScattered) newEvent.addEventType(JPetEventType::kScattered);
+      // Check types of current event in a single pass over its hits
+      const auto& hitFeatures = fCategorizerEngine.computeFeatures(event);
+      auto eventTypes = fCategorizerEngine.categorize(hitFeatures);
+
+      // Tag the event in place, after it is stored
+      events.push_back(event);
+      for (auto type : eventTypes) { events.back().addEventType(type); }
+      if (fColumnarWriter) {
+        fColumnarWriter->write(events.back().getEventType(), hitFeatures);
+      }
 
       if(fSaveControlHistos){
-        for(auto hit : event.getHits()){
-          getStatistics().fillHistogram("All_XYpos", hit.getPosX(), hit.getPosY());
+        for(const auto& hit : hitFeatures){
+          getStatistics().fillHistogram("All_XYpos", hit.pos.X(), hit.pos.Y());
         }
       }
-      events.push_back(newEvent);
     }
     saveEvents(events);
   } else { return false; }
@@ -128,6 +153,7 @@ bool EventCategorizer::exec()
 
 bool EventCategorizer::terminate()
 {
+  if (fColumnarWriter) { fColumnarWriter->close(); }
   INFO("Event categorization completed.");
   return true;
 }
@@ -17,9 +17,12 @@
 #define EVENTCATEGORIZER_H
 
 #include <JPetUserTask/JPetUserTask.h>
+#include "EventCategorizerEngine.h"
+#include "EventColumnarFormat.h"
 #include "EventCategorizerTools.h"
 #include <JPetEvent/JPetEvent.h>
 #include <JPetHit/JPetHit.h>
+#include <memory>
 #include <vector>
 #include <map>
 
@@ -33,8 +36,10 @@ class JPetWriter;
  * @brief User Task categorizing Events
  *
  * Task attempts to add types of events to each event. Each category/type
- * has separate method for checking, if current event fulfills set of conditions.
- * These methods are defined in tools class. More than one type can be added to an event.
+ * has separate predicate for checking, if current event fulfills set of conditions.
+ * Predicates are evaluated in a single pass by EventCategorizerEngine. More than
+ * one type can be added to an event. Optionally, positions, times, thetas and TOTs
+ * of hits together with event types are also saved in the flat columnar format.
  * Set of controll histograms are created, unless the user decides not to produce them.
  */
 class EventCategorizer : public JPetUserTask{
@@ -53,6 +58,7 @@ protected:
 	const std::string kMaxTimeDiffParamKey = "EventCategorizer_MaxTimeDiff_float";
 	const std::string kSaveControlHistosParamKey = "Save_Control_Histograms_bool";
     const std::string kTOTCalculationType = "HitFinder_TOTCalculationType_std::string";
+	const std::string kColumnarOutputFileParamKey = "EventCategorizer_ColumnarOutputFile_std::string";
 	void saveEvents(const std::vector<JPetEvent>& event);
 	double fScatterTOFTimeDiff = 2000.0;
 	double fB2BSlotThetaDiff = 3.0;
@@ -61,6 +67,8 @@ protected:
 	double fMaxTimeDiff = 1000.;
 	bool fSaveControlHistos = true;
     std::string fTOTCalculationType = "";
+	EventCategorizerEngine fCategorizerEngine;
+	std::unique_ptr<EventColumnarWriter> fColumnarWriter;
 	void initialiseHistograms();
 };
 #endif /* !EVENTCATEGORIZER_H */
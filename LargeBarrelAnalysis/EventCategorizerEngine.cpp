@@ -0,0 +1,270 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file EventCategorizerEngine.cpp
+ */
+
+#include "EventCategorizerEngine.h"
+#include "EventCategorizerTools.h"
+#include <algorithm>
+#include <TMath.h>
+#include <cmath>
+
+using namespace std;
+
+EventCategorizerEngine::EventCategorizerEngine(HitFinderTools::TOTCalculationType totType):
+  fTOTCalculationType(totType) {}
+
+void EventCategorizerEngine::addHitPredicate(
+  JPetEventType type, HitPredicate predicate, bool stopOnMatch
+) {
+  fHitPredicates.push_back({type, predicate, stopOnMatch});
+}
+
+void EventCategorizerEngine::addPairPredicate(
+  JPetEventType type, PairPredicate predicate, bool stopOnMatch
+) {
+  fPairPredicates.push_back({type, predicate, stopOnMatch});
+}
+
+void EventCategorizerEngine::addTriplePredicate(
+  JPetEventType type, TriplePredicate predicate, bool stopOnMatch
+) {
+  fTriplePredicates.push_back({type, predicate, stopOnMatch});
+}
+
+/**
+ * Calculation of all quantities of a hit, that are used by the predicates
+ */
+HitFeatures EventCategorizerEngine::computeFeatures(
+  const JPetHit& hit, HitFinderTools::TOTCalculationType totType
+) {
+  HitFeatures features;
+  features.pos = hit.getPos();
+  features.time = hit.getTime();
+  features.theta = hit.getBarrelSlot().getTheta();
+  features.tot = HitFinderTools::calculateTOT(hit, totType);
+  return features;
+}
+
+/**
+ * Filling the feature cache with all hits of the event. Returned reference
+ * is valid until the next call of this method.
+ */
+const vector<HitFeatures>& EventCategorizerEngine::computeFeatures(const JPetEvent& event)
+{
+  const auto& hits = event.getHits();
+  fFeatures.clear();
+  fFeatures.reserve(hits.size());
+  for (const auto& hit : hits) {
+    fFeatures.push_back(computeFeatures(hit, fTOTCalculationType));
+  }
+  return fFeatures;
+}
+
+vector<JPetEventType> EventCategorizerEngine::categorize(const JPetEvent& event)
+{
+  return categorize(computeFeatures(event));
+}
+
+/**
+ * Evaluation of all registered predicates in shared loops. Returns types
+ * of the predicates, that were fulfilled at least once.
+ */
+vector<JPetEventType> EventCategorizerEngine::categorize(const vector<HitFeatures>& features)
+{
+  const size_t nHitPredicates = fHitPredicates.size();
+  const size_t nPairPredicates = fPairPredicates.size();
+  fMatched.assign(nHitPredicates + nPairPredicates + fTriplePredicates.size(), false);
+
+  // Returns true if any of the predicates has to be evaluated further
+  auto evaluate = [this](auto& entries, size_t offset, auto&& call) {
+    bool anyActive = false;
+    for (size_t p = 0; p < entries.size(); p++) {
+      if (fMatched[offset + p] && entries[p].stopOnMatch) { continue; }
+      if (call(entries[p].predicate)) { fMatched[offset + p] = true; }
+      if (!fMatched[offset + p] || !entries[p].stopOnMatch) { anyActive = true; }
+    }
+    return anyActive;
+  };
+
+  const size_t nHits = features.size();
+  bool active = nHitPredicates > 0;
+  for (size_t i = 0; i < nHits && active; i++) {
+    active = evaluate(fHitPredicates, 0, [&](const HitPredicate& predicate) {
+      return predicate(features[i]);
+    });
+  }
+
+  active = nPairPredicates > 0;
+  for (size_t i = 0; i < nHits && active; i++) {
+    for (size_t j = i + 1; j < nHits && active; j++) {
+      const auto& firstHit = features[i].time < features[j].time ? features[i] : features[j];
+      const auto& secondHit = features[i].time < features[j].time ? features[j] : features[i];
+      active = evaluate(fPairPredicates, nHitPredicates, [&](const PairPredicate& predicate) {
+        return predicate(firstHit, secondHit);
+      });
+    }
+  }
+
+  active = !fTriplePredicates.empty();
+  for (size_t i = 0; i < nHits && active; i++) {
+    for (size_t j = i + 1; j < nHits && active; j++) {
+      for (size_t k = j + 1; k < nHits && active; k++) {
+        active = evaluate(fTriplePredicates, nHitPredicates + nPairPredicates,
+          [&](const TriplePredicate& predicate) {
+            return predicate(features[i], features[j], features[k]);
+          }
+        );
+      }
+    }
+  }
+
+  vector<JPetEventType> types;
+  for (size_t p = 0; p < nHitPredicates; p++) {
+    if (fMatched[p]) { types.push_back(fHitPredicates[p].type); }
+  }
+  for (size_t p = 0; p < nPairPredicates; p++) {
+    if (fMatched[nHitPredicates + p]) { types.push_back(fPairPredicates[p].type); }
+  }
+  for (size_t p = 0; p < fTriplePredicates.size(); p++) {
+    if (fMatched[nHitPredicates + nPairPredicates + p]) { types.push_back(fTriplePredicates[p].type); }
+  }
+  return types;
+}
+
+/**
+ * Tagging the event with types, replacing the unknown type if it is the only one set
+ */
+void EventCategorizerEngine::addEventTypes(JPetEvent& event, const vector<JPetEventType>& types)
+{
+  for (auto type : types) {
+    if (event.isOnlyTypeOf(JPetEventType::kUnknown)) {
+      event.setEventType(type);
+    } else {
+      event.addEventType(type);
+    }
+  }
+}
+
+/**
+ * Predicate for type of event - back to back 2 gamma,
+ * equivalent of EventCategorizerTools::checkFor2Gamma
+ */
+EventCategorizerEngine::PairPredicate EventCategorizerEngine::make2GammaPredicate(
+  JPetStatistics& stats, bool saveHistos, double b2bSlotThetaDiff, double b2bTimeDiff
+) {
+  return [&stats, saveHistos, b2bSlotThetaDiff, b2bTimeDiff](
+    const HitFeatures& firstHit, const HitFeatures& secondHit
+  ) {
+    double timeDiff = fabs(firstHit.time - secondHit.time);
+    double deltaLor = (secondHit.time - firstHit.time) * kLightVelocity_cm_ps / 2.;
+    double theta1 = min(firstHit.theta, secondHit.theta);
+    double theta2 = max(firstHit.theta, secondHit.theta);
+    double thetaDiff = min(theta2 - theta1, 360.0 - theta2 + theta1);
+    if (saveHistos) {
+      stats.fillHistogram("2Gamma_Zpos", firstHit.pos.Z());
+      stats.fillHistogram("2Gamma_Zpos", secondHit.pos.Z());
+      stats.fillHistogram("2Gamma_TimeDiff", timeDiff / 1000.0);
+      stats.fillHistogram("2Gamma_DLOR", deltaLor);
+      stats.fillHistogram("2Gamma_ThetaDiff", thetaDiff);
+      stats.fillHistogram("2Gamma_Dist", (firstHit.pos - secondHit.pos).Mag());
+    }
+    if (fabs(thetaDiff - 180.0) < b2bSlotThetaDiff && timeDiff < b2bTimeDiff) {
+      if (saveHistos) {
+        TVector3 annhilationPoint = EventCategorizerTools::calculateAnnihilationPoint(
+          firstHit.pos, secondHit.pos, EventCategorizerTools::calculateTOF(firstHit.time, secondHit.time)
+        );
+        double tofByConvention = firstHit.theta < secondHit.theta
+          ? EventCategorizerTools::calculateTOF(firstHit.time, secondHit.time)
+          : EventCategorizerTools::calculateTOF(secondHit.time, firstHit.time);
+        stats.fillHistogram("Annih_TOF", tofByConvention);
+        stats.fillHistogram("AnnihPoint_XY", annhilationPoint.X(), annhilationPoint.Y());
+        stats.fillHistogram("AnnihPoint_ZX", annhilationPoint.Z(), annhilationPoint.X());
+        stats.fillHistogram("AnnihPoint_ZY", annhilationPoint.Z(), annhilationPoint.Y());
+        stats.fillHistogram("Annih_DLOR", deltaLor);
+      }
+      return true;
+    }
+    return false;
+  };
+}
+
+/**
+ * Predicate for type of event - 3Gamma, equivalent of EventCategorizerTools::checkFor3Gamma.
+ * To fill histograms with all triples it should be registered with stopOnMatch equal false.
+ */
+EventCategorizerEngine::TriplePredicate EventCategorizerEngine::make3GammaPredicate(
+  JPetStatistics& stats, bool saveHistos
+) {
+  return [&stats, saveHistos](
+    const HitFeatures& firstHit, const HitFeatures& secondHit, const HitFeatures& thirdHit
+  ) {
+    if (saveHistos) {
+      double thetaAngles[3] = {firstHit.theta, secondHit.theta, thirdHit.theta};
+      sort(thetaAngles, thetaAngles + 3);
+      double relativeAngles[3] = {
+        thetaAngles[1] - thetaAngles[0],
+        thetaAngles[2] - thetaAngles[1],
+        360.0 - thetaAngles[2] + thetaAngles[0]
+      };
+      sort(relativeAngles, relativeAngles + 3);
+      double transformedX = relativeAngles[1] + relativeAngles[0];
+      double transformedY = relativeAngles[1] - relativeAngles[0];
+      stats.fillHistogram("3Gamma_Angles", transformedX, transformedY);
+    }
+    return true;
+  };
+}
+
+/**
+ * Predicate for type of event - prompt, equivalent of EventCategorizerTools::checkForPrompt
+ */
+EventCategorizerEngine::HitPredicate EventCategorizerEngine::makePromptPredicate(
+  JPetStatistics& stats, bool saveHistos, double deexTOTCutMin, double deexTOTCutMax
+) {
+  return [&stats, saveHistos, deexTOTCutMin, deexTOTCutMax](const HitFeatures& hit) {
+    if (hit.tot > deexTOTCutMin && hit.tot < deexTOTCutMax) {
+      if (saveHistos) {
+        stats.fillHistogram("Deex_TOT_cut", hit.tot);
+      }
+      return true;
+    }
+    return false;
+  };
+}
+
+/**
+ * Predicate for type of event - scatter, equivalent of EventCategorizerTools::checkForScatter
+ */
+EventCategorizerEngine::PairPredicate EventCategorizerEngine::makeScatterPredicate(
+  JPetStatistics& stats, bool saveHistos, double scatterTOFTimeDiff
+) {
+  return [&stats, saveHistos, scatterTOFTimeDiff](
+    const HitFeatures& primaryHit, const HitFeatures& scatterHit
+  ) {
+    double scattTOF = (primaryHit.pos - scatterHit.pos).Mag() / kLightVelocity_cm_ps;
+    double timeDiff = scatterHit.time - primaryHit.time;
+    if (saveHistos) {
+      stats.fillHistogram("ScatterTOF_TimeDiff", fabs(scattTOF - timeDiff));
+    }
+    if (fabs(scattTOF - timeDiff) < scatterTOFTimeDiff) {
+      if (saveHistos) {
+        double scattAngle = TMath::RadToDeg() * primaryHit.pos.Angle(scatterHit.pos - primaryHit.pos);
+        stats.fillHistogram("ScatterAngle_PrimaryTOT", scattAngle, primaryHit.tot);
+        stats.fillHistogram("ScatterAngle_ScatterTOT", scattAngle, scatterHit.tot);
+      }
+      return true;
+    }
+    return false;
+  };
+}
@@ -0,0 +1,101 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file EventCategorizerEngine.h
+ */
+
+#ifndef EVENTCATEGORIZERENGINE_H
+#define EVENTCATEGORIZERENGINE_H
+
+#include <JPetStatistics/JPetStatistics.h>
+#include <JPetEventType/JPetEventType.h>
+#include <JPetEvent/JPetEvent.h>
+#include <JPetHit/JPetHit.h>
+#include "HitFinderTools.h"
+#include <functional>
+#include <TVector3.h>
+#include <vector>
+
+/**
+ * @brief Quantities of a hit used by the categorization predicates
+ *
+ * Filled once per hit, so that none of the predicates has to access
+ * the signal object graph of the hit again.
+ */
+struct HitFeatures
+{
+  TVector3 pos;
+  double time = 0.0;
+  double theta = 0.0;
+  double tot = 0.0;
+};
+
+/**
+ * @brief Single-pass engine for categorization of Events
+ *
+ * Features of hits are calculated once per event and all registered predicates
+ * are evaluated over shared loops on hits, pairs of hits and triples of hits.
+ * Pair predicates obtain hits ordered by time (earlier hit first), triple
+ * predicates obtain them in the order of the event. A predicate registered
+ * with stopOnMatch equal true is not evaluated after its first positive
+ * result, that reproduces early returns of EventCategorizerTools::checkFor...
+ * methods. Loops are stopped as soon as all the predicates in them are matched.
+ */
+class EventCategorizerEngine
+{
+public:
+  using HitPredicate = std::function<bool(const HitFeatures&)>;
+  using PairPredicate = std::function<bool(const HitFeatures&, const HitFeatures&)>;
+  using TriplePredicate = std::function<bool(const HitFeatures&, const HitFeatures&, const HitFeatures&)>;
+
+  explicit EventCategorizerEngine(
+    HitFinderTools::TOTCalculationType totType = HitFinderTools::kSimplified
+  );
+  void addHitPredicate(JPetEventType type, HitPredicate predicate, bool stopOnMatch = true);
+  void addPairPredicate(JPetEventType type, PairPredicate predicate, bool stopOnMatch = true);
+  void addTriplePredicate(JPetEventType type, TriplePredicate predicate, bool stopOnMatch = true);
+  const std::vector<HitFeatures>& computeFeatures(const JPetEvent& event);
+  std::vector<JPetEventType> categorize(const std::vector<HitFeatures>& features);
+  std::vector<JPetEventType> categorize(const JPetEvent& event);
+  static HitFeatures computeFeatures(
+    const JPetHit& hit, HitFinderTools::TOTCalculationType totType
+  );
+  static void addEventTypes(JPetEvent& event, const std::vector<JPetEventType>& types);
+
+  static PairPredicate make2GammaPredicate(
+    JPetStatistics& stats, bool saveHistos, double b2bSlotThetaDiff, double b2bTimeDiff
+  );
+  static TriplePredicate make3GammaPredicate(JPetStatistics& stats, bool saveHistos);
+  static HitPredicate makePromptPredicate(
+    JPetStatistics& stats, bool saveHistos, double deexTOTCutMin, double deexTOTCutMax
+  );
+  static PairPredicate makeScatterPredicate(
+    JPetStatistics& stats, bool saveHistos, double scatterTOFTimeDiff
+  );
+
+private:
+  template <typename Predicate>
+  struct Entry
+  {
+    JPetEventType type;
+    Predicate predicate;
+    bool stopOnMatch;
+  };
+  HitFinderTools::TOTCalculationType fTOTCalculationType;
+  std::vector<Entry<HitPredicate>> fHitPredicates;
+  std::vector<Entry<PairPredicate>> fPairPredicates;
+  std::vector<Entry<TriplePredicate>> fTriplePredicates;
+  std::vector<HitFeatures> fFeatures;
+  std::vector<bool> fMatched;
+};
+
+#endif /* !EVENTCATEGORIZERENGINE_H */
@@ -0,0 +1,161 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file EventColumnarFormat.cpp
+ */
+
+#include "EventColumnarFormat.h"
+#include <TDirectory.h>
+#include <TFile.h>
+#include <TTree.h>
+
+using namespace std;
+
+const char* const EventColumnarWriter::kTreeName = "CategorizedEvents";
+
+EventColumnarWriter::EventColumnarWriter(const string& fileName)
+{
+  // Current directory is restored, so histograms of the task are not attached to this file
+  TDirectory::TContext context;
+  fFile = new TFile(fileName.c_str(), "RECREATE");
+  if (fFile->IsZombie()) {
+    ERROR("Could not open file " + fileName + " for the columnar output of events.");
+    delete fFile;
+    fFile = nullptr;
+    return;
+  }
+  fTree = new TTree(kTreeName, "Categorized events in columnar format");
+  fTree->Branch("type", &fType, "type/i");
+  fTree->Branch("nHits", &fNumberOfHits, "nHits/i");
+  fTree->Branch("posX", &fPosX);
+  fTree->Branch("posY", &fPosY);
+  fTree->Branch("posZ", &fPosZ);
+  fTree->Branch("time", &fTime);
+  fTree->Branch("theta", &fTheta);
+  fTree->Branch("tot", &fTOT);
+}
+
+EventColumnarWriter::~EventColumnarWriter()
+{
+  close();
+}
+
+bool EventColumnarWriter::isOpen() const
+{
+  return fFile != nullptr;
+}
+
+void EventColumnarWriter::write(unsigned int eventType, const vector<HitFeatures>& hits)
+{
+  if (!isOpen()) { return; }
+  fType = eventType;
+  fNumberOfHits = hits.size();
+  fPosX.clear();
+  fPosY.clear();
+  fPosZ.clear();
+  fTime.clear();
+  fTheta.clear();
+  fTOT.clear();
+  for (const auto& hit : hits) {
+    fPosX.push_back(hit.pos.X());
+    fPosY.push_back(hit.pos.Y());
+    fPosZ.push_back(hit.pos.Z());
+    fTime.push_back(hit.time);
+    fTheta.push_back(hit.theta);
+    fTOT.push_back(hit.tot);
+  }
+  fTree->Fill();
+}
+
+void EventColumnarWriter::close()
+{
+  if (!isOpen()) { return; }
+  TDirectory::TContext context(fFile);
+  fTree->Write();
+  fFile->Close();
+  delete fFile;
+  fFile = nullptr;
+  fTree = nullptr;
+}
+
+EventColumnarReader::EventColumnarReader(const string& fileName)
+{
+  TDirectory::TContext context;
+  fFile = TFile::Open(fileName.c_str(), "READ");
+  if (!fFile || fFile->IsZombie()) {
+    ERROR("Could not open file " + fileName + " with the columnar output of events.");
+    delete fFile;
+    fFile = nullptr;
+    return;
+  }
+  fTree = dynamic_cast<TTree*>(fFile->Get(EventColumnarWriter::kTreeName));
+  if (!fTree) {
+    ERROR("File " + fileName + " does not contain events in the columnar format.");
+    fFile->Close();
+    delete fFile;
+    fFile = nullptr;
+    return;
+  }
+  fTree->SetBranchStatus("*", 0);
+  for (auto name : {"type", "posX", "posY", "posZ", "time", "theta", "tot"}) {
+    fTree->SetBranchStatus(name, 1);
+  }
+  fTree->SetBranchAddress("type", &fType);
+  fTree->SetBranchAddress("posX", &fPosX);
+  fTree->SetBranchAddress("posY", &fPosY);
+  fTree->SetBranchAddress("posZ", &fPosZ);
+  fTree->SetBranchAddress("time", &fTime);
+  fTree->SetBranchAddress("theta", &fTheta);
+  fTree->SetBranchAddress("tot", &fTOT);
+}
+
+EventColumnarReader::~EventColumnarReader()
+{
+  if (fFile) {
+    fTree->ResetBranchAddresses();
+    fFile->Close();
+    delete fFile;
+  }
+  delete fPosX;
+  delete fPosY;
+  delete fPosZ;
+  delete fTime;
+  delete fTheta;
+  delete fTOT;
+}
+
+bool EventColumnarReader::isOpen() const
+{
+  return fFile != nullptr;
+}
+
+long long EventColumnarReader::getNumberOfEvents() const
+{
+  return isOpen() ? fTree->GetEntries() : 0;
+}
+
+/**
+ * Reading event with given index, hits vector of the event is reused
+ */
+bool EventColumnarReader::readEvent(long long index, ColumnarEvent& event)
+{
+  if (!isOpen() || fTree->GetEntry(index) <= 0) { return false; }
+  event.type = fType;
+  event.hits.resize(fPosX->size());
+  for (size_t i = 0; i < fPosX->size(); i++) {
+    event.hits[i].pos.SetXYZ(fPosX->at(i), fPosY->at(i), fPosZ->at(i));
+    event.hits[i].time = fTime->at(i);
+    event.hits[i].theta = fTheta->at(i);
+    event.hits[i].tot = fTOT->at(i);
+  }
+  return true;
+}
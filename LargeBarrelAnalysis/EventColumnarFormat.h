@@ -0,0 +1,100 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file EventColumnarFormat.h
+ */
+
+#ifndef EVENTCOLUMNARFORMAT_H
+#define EVENTCOLUMNARFORMAT_H
+
+#include "EventCategorizerEngine.h"
+#include <string>
+#include <vector>
+
+class TFile;
+class TTree;
+
+/**
+ * @brief Event in the columnar format - event type and features of its hits
+ */
+struct ColumnarEvent
+{
+  unsigned int type = 0;
+  std::vector<HitFeatures> hits;
+};
+
+/**
+ * @brief Writer of categorized events to a flat TTree
+ *
+ * Each quantity is stored in its own branch - event type and number of hits
+ * as scalars, hit positions [cm], times [ps], theta angles [deg] and TOTs [ps]
+ * as vectors of numbers, so no JPet object graph is serialised. Tree is
+ * written to the file when the writer is closed or destroyed.
+ */
+class EventColumnarWriter
+{
+public:
+  explicit EventColumnarWriter(const std::string& fileName);
+  ~EventColumnarWriter();
+  bool isOpen() const;
+  void write(unsigned int eventType, const std::vector<HitFeatures>& hits);
+  void close();
+
+  static const char* const kTreeName;
+
+private:
+  EventColumnarWriter(const EventColumnarWriter&) = delete;
+  EventColumnarWriter& operator=(const EventColumnarWriter&) = delete;
+
+  TFile* fFile = nullptr;
+  TTree* fTree = nullptr;
+  unsigned int fType = 0;
+  unsigned int fNumberOfHits = 0;
+  std::vector<float> fPosX;
+  std::vector<float> fPosY;
+  std::vector<float> fPosZ;
+  std::vector<double> fTime;
+  std::vector<float> fTheta;
+  std::vector<float> fTOT;
+};
+
+/**
+ * @brief Reader of files created by EventColumnarWriter
+ *
+ * Only branches holding hit features are read, events are returned
+ * in the order they were written.
+ */
+class EventColumnarReader
+{
+public:
+  explicit EventColumnarReader(const std::string& fileName);
+  ~EventColumnarReader();
+  bool isOpen() const;
+  long long getNumberOfEvents() const;
+  bool readEvent(long long index, ColumnarEvent& event);
+
+private:
+  EventColumnarReader(const EventColumnarReader&) = delete;
+  EventColumnarReader& operator=(const EventColumnarReader&) = delete;
+
+  TFile* fFile = nullptr;
+  TTree* fTree = nullptr;
+  unsigned int fType = 0;
+  std::vector<float>* fPosX = nullptr;
+  std::vector<float>* fPosY = nullptr;
+  std::vector<float>* fPosZ = nullptr;
+  std::vector<double>* fTime = nullptr;
+  std::vector<float>* fTheta = nullptr;
+  std::vector<float>* fTOT = nullptr;
+};
+
+#endif /* !EVENTCOLUMNARFORMAT_H */
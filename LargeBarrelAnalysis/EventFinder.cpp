@@ -75,6 +75,7 @@ bool EventFinder::init()
 bool EventFinder::exec()
 {
   if (auto timeWindow = dynamic_cast<const JPetTimeWindow* const>(fEvent)) {
+    TimeWindowArena::Scope arenaScope(fArena);
     saveEvents(buildEvents(*timeWindow));
   } else { return false; }
   return true;
@@ -86,7 +87,7 @@ bool EventFinder::terminate()
   return true;
 }
 
-void EventFinder::saveEvents(const vector<JPetEvent>& events)
+void EventFinder::saveEvents(const ArenaVector<JPetEvent>& events)
 {
   for (const auto& event : events){
     fOutputEvents->add<JPetEvent>(event);
@@ -97,13 +98,13 @@ void EventFinder::saveEvents(const vector<JPetEvent>& events)
  * Main method of building Events - Hit in the Time slot are groupped
  * within time parameter, that can be set by the user
  */
-vector<JPetEvent> EventFinder::buildEvents(const JPetTimeWindow& timeWindow)
+ArenaVector<JPetEvent> EventFinder::buildEvents(const JPetTimeWindow& timeWindow)
 {
-  vector<JPetEvent> eventVec;
+  ArenaVector<JPetEvent> eventVec{ArenaAllocator<JPetEvent>(&fArena)};
   const unsigned int nHits = timeWindow.getNumberOfEvents();
   unsigned int count = 0;
   while(count<nHits){
-    auto hit = dynamic_cast<const JPetHit&>(timeWindow.operator[](count));
+    const auto& hit = dynamic_cast<const JPetHit&>(timeWindow.operator[](count));
     if(!fUseCorruptedHits && hit.getRecoFlag()==JPetHit::Corrupted){
       count++;
       continue;
@@ -121,7 +122,7 @@ vector<JPetEvent> EventFinder::buildEvents(const JPetTimeWindow& timeWindow)
     // then moving interator 
     unsigned int nextCount = 1;
     while(count+nextCount < nHits){
-      auto nextHit = dynamic_cast<const JPetHit&>(timeWindow.operator[](count+nextCount));
+      const auto& nextHit = dynamic_cast<const JPetHit&>(timeWindow.operator[](count+nextCount));
       if (fabs(nextHit.getTime() - hit.getTime()) < fEventTimeWindow) {
         if(nextHit.getRecoFlag() == JPetHit::Corrupted) {
           event.setRecoFlag(JPetEvent::Corrupted);
@@ -19,6 +19,7 @@
 #include <JPetUserTask/JPetUserTask.h>
 #include <JPetEvent/JPetEvent.h>
 #include <JPetHit/JPetHit.h>
+#include "TimeWindowArena.h"
 #include <vector>
 #include <map>
 
@@ -36,6 +37,7 @@ class JPetWriter;
  * default, but it can be provided by the user in parameters file.
  * Also user can require to save only Events of minimum multiplicity
  * and if include Corrupted Hits in the created events.
+ * Events are built in the arena, that is reset after each Time Window.
  */
 class EventFinder: public JPetUserTask
 {
@@ -47,8 +49,8 @@ public:
   virtual bool terminate() override;
 
 protected:
-  std::vector<JPetEvent> buildEvents(const JPetTimeWindow & hits);
-  void saveEvents(const std::vector<JPetEvent>& event);
+  ArenaVector<JPetEvent> buildEvents(const JPetTimeWindow & hits);
+  void saveEvents(const ArenaVector<JPetEvent>& event);
   void initialiseHistograms();
   const std::string kUseCorruptedHitsParamKey = "EventFinder_UseCorruptedHits_bool";
   const std::string kEventMinMultiplicity = "EventFinder_MinEventMultiplicity_int";
@@ -58,5 +60,6 @@ protected:
   bool fUseCorruptedHits = false;
   bool fSaveControlHistos = true;
   uint fMinMultiplicity = 1;
+  TimeWindowArena fArena;
 };
 #endif /* !EVENTFINDER_H */
@@ -101,6 +101,14 @@ bool HitFinder::init()
     WARNING("No TOT calculation option given by the user. Using standard sum.");
   }
 
+  // Getting bool for saving hits with slim signals
+  if (isOptionSet(fParams.getOptions(), kSlimHitsParamKey)) {
+    fSlimHits = getOptionAsBool(fParams.getOptions(), kSlimHitsParamKey);
+    if (fSlimHits) {
+      INFO("Hit Finder is saving hits with slim signals, as set by the user.");
+    }
+  }
+
   // Control histograms
   if(fSaveControlHistos) { initialiseHistograms(); }
   return true;
@@ -109,8 +117,9 @@ bool HitFinder::init()
 bool HitFinder::exec()
 {
   if (auto& timeWindow = dynamic_cast<const JPetTimeWindow* const>(fEvent)) {
+    TimeWindowArena::Scope arenaScope(fArena);
     auto signalsBySlot = HitFinderTools::getSignalsBySlot(
-      timeWindow, fUseCorruptedSignals
+      timeWindow, fUseCorruptedSignals, &fArena
     );
     auto totConverter = fToTConverterFactory.getEnergyConverter();
     auto allHits = HitFinderTools::matchAllSignals(
@@ -144,7 +153,11 @@ if (fSaveControlHistos) {
         getStatistics().fillHistogram("TOT_corr_hits", tot);
       }
     }
-    fOutputEvents->add<JPetHit>(hit);
+    if (fSlimHits) {
+      fOutputEvents->add<JPetHit>(HitFinderTools::createSlimHit(hit));
+    } else {
+      fOutputEvents->add<JPetHit>(hit);
+    }
   }
 }
 
@@ -19,6 +19,7 @@
 #include <JPetRawSignal/JPetRawSignal.h>
 #include <JPetUserTask/JPetUserTask.h>
 #include "ToTEnergyConverterFactory.h"
+#include "TimeWindowArena.h"
 #include <JPetHit/JPetHit.h>
 #include <vector>
 #include <map>
@@ -35,6 +36,9 @@ class JPetWriter;
  * Task pairs Physical Signals and creates Hits, based on time comparison
  * of Signals, time window for hit matching can be specified in user options,
  * default one is provided. Matching method is contained in tools class.
+ * Optionally hits are saved with slim signals, without Signal Channels, that
+ * are not used by EventFinder and categorization tasks.
+ * Signals sorted by slots are kept in the arena, that is reset after each Time Window.
  */
 class HitFinder: public JPetUserTask {
 
@@ -56,13 +60,16 @@ protected:
   const std::string kABTimeDiffParamKey = "HitFinder_ABTimeDiff_float";
   const std::string kConvertToTParamKey = "HitFinder_ConvertToT_bool";
   const std::string kTOTCalculationType = "HitFinder_TOTCalculationType_std::string";
+  const std::string kSlimHitsParamKey = "HitFinder_SlimHits_bool";
   ToTEnergyConverterFactory fToTConverterFactory;
   bool fUseCorruptedSignals = false;
   bool fSaveControlHistos = true;
   bool fConvertToT = false;
+  bool fSlimHits = false;
   double fABTimeDiff = 6000.0;
   int fRefDetScinID = -1;
   std::string fTOTCalculationType = "";
+  TimeWindowArena fArena;
 };
 
 #endif /* !HITFINDER_H */
@@ -15,6 +15,7 @@
 
 #include "UniversalFileLoader.h"
 #include "HitFinderTools.h"
+#include "SlimSignalTools.h"
 #include <TMath.h>
 #include <vector>
 #include <cmath>
@@ -26,7 +27,8 @@ using namespace std;
 /**
  * Helper method for sotring signals in vector
  */
-void HitFinderTools::sortByTime(vector<JPetPhysSignal>& sigVec)
+template <typename SignalAlloc>
+void HitFinderTools::sortByTime(vector<JPetPhysSignal, SignalAlloc>& sigVec)
 {
   sort(sigVec.begin(), sigVec.end(),
     [](const JPetPhysSignal & sig1, const JPetPhysSignal & sig2) {
@@ -36,29 +38,27 @@ void HitFinderTools::sortByTime(vector<JPetPhysSignal>& sigVec)
  }
 
 /**
- * Method distributing Signals according to Scintillator they belong to
+ * Method distributing Signals according to Scintillator they belong to,
+ * if the arena is given, the map and the vectors are allocated from it
  */
-map<int, vector<JPetPhysSignal>> HitFinderTools::getSignalsBySlot(
-  const JPetTimeWindow* timeWindow, bool useCorrupts
+HitFinderTools::SignalsBySlot HitFinderTools::getSignalsBySlot(
+  const JPetTimeWindow* timeWindow, bool useCorrupts, TimeWindowArena* arena
 ){
-  map<int, vector<JPetPhysSignal>> signalSlotMap;
+  SignalsBySlot signalSlotMap{SignalsBySlot::allocator_type(arena)};
   if (!timeWindow) {
     WARNING("Pointer of Time Window object is not set, returning empty map");
     return signalSlotMap;
   }
   const unsigned int nSignals = timeWindow->getNumberOfEvents();
   for (unsigned int i = 0; i < nSignals; i++) {
-    auto physSig = dynamic_cast<const JPetPhysSignal&>(timeWindow->operator[](i));
+    const auto& physSig = dynamic_cast<const JPetPhysSignal&>(timeWindow->operator[](i));
     if(!useCorrupts && physSig.getRecoFlag() == JPetBaseSignal::Corrupted) { continue; }
     int slotID = physSig.getBarrelSlot().getID();
     auto search = signalSlotMap.find(slotID);
     if (search == signalSlotMap.end()) {
-      vector<JPetPhysSignal> tmp;
-      tmp.push_back(physSig);
-      signalSlotMap.insert(pair<int, vector<JPetPhysSignal>>(slotID, tmp));
-    } else {
-      search->second.push_back(physSig);
+      search = signalSlotMap.emplace(slotID, SignalVector(SignalVector::allocator_type(arena))).first;
     }
+    search->second.push_back(physSig);
   }
   return signalSlotMap;
 }
@@ -66,8 +66,9 @@ map<int, vector<JPetPhysSignal>> HitFinderTools::getSignalsBySlot(
 /**
  * Loop over all Scins invoking matching procedure
  */
+template <typename SignalMap>
 vector<JPetHit> HitFinderTools::matchAllSignals(
-  map<int, vector<JPetPhysSignal>>& allSignals,
+  SignalMap& allSignals,
   const map<unsigned int, vector<double>>& velocitiesMap,
   double timeDiffAB, int refDetScinId, bool convertToT,
   const ToTEnergyConverter& totConverter, JPetStatistics& stats, bool saveHistos
@@ -76,7 +77,7 @@ vector<JPetHit> HitFinderTools::matchAllSignals(
   for (auto& slotSigals : allSignals) {
     // Loop for Reference Detector ID
     if (slotSigals.first == refDetScinId) {
-      for (auto refSignal : slotSigals.second) {
+      for (const auto& refSignal : slotSigals.second) {
         auto refHit = createDummyRefDetHit(refSignal);
         allHits.push_back(refHit);
       }
@@ -93,16 +94,18 @@ vector<JPetHit> HitFinderTools::matchAllSignals(
 }
 
 /**
- * Method matching signals on the same Scintillator
+ * Method matching signals on the same Scintillator, unmatched signals
+ * are kept with the same allocator as the input ones
  */
+template <typename SignalAlloc>
 vector<JPetHit> HitFinderTools::matchSignals(
-  vector<JPetPhysSignal>& slotSignals,
+  vector<JPetPhysSignal, SignalAlloc>& slotSignals,
   const map<unsigned int, vector<double>>& velocitiesMap, double timeDiffAB,
   bool convertToT, const ToTEnergyConverter& totConverter, JPetStatistics& stats,
   bool saveHistos
 ) {
   vector<JPetHit> slotHits;
-  vector<JPetPhysSignal> remainSignals;
+  vector<JPetPhysSignal, SignalAlloc> remainSignals(slotSignals.get_allocator());
   sortByTime(slotSignals);
   while (slotSignals.size() > 0) {
     auto physSig = slotSignals.at(0);
@@ -147,6 +150,26 @@ vector<JPetHit> HitFinderTools::matchSignals(
   return slotHits;
 }
 
+// Instantiations for containers allocated from the arena and standard ones
+template void HitFinderTools::sortByTime(SignalVector&);
+template void HitFinderTools::sortByTime(vector<JPetPhysSignal>&);
+template vector<JPetHit> HitFinderTools::matchAllSignals(
+  SignalsBySlot&, const map<unsigned int, vector<double>>&, double, int, bool,
+  const ToTEnergyConverter&, JPetStatistics&, bool
+);
+template vector<JPetHit> HitFinderTools::matchAllSignals(
+  map<int, vector<JPetPhysSignal>>&, const map<unsigned int, vector<double>>&, double, int, bool,
+  const ToTEnergyConverter&, JPetStatistics&, bool
+);
+template vector<JPetHit> HitFinderTools::matchSignals(
+  SignalVector&, const map<unsigned int, vector<double>>&, double, bool,
+  const ToTEnergyConverter&, JPetStatistics&, bool
+);
+template vector<JPetHit> HitFinderTools::matchSignals(
+  vector<JPetPhysSignal>&, const map<unsigned int, vector<double>>&, double, bool,
+  const ToTEnergyConverter&, JPetStatistics&, bool
+);
+
 /**
  * Method for Hit creation - setting all fields, that make sense here
  */
@@ -246,6 +269,29 @@ JPetHit HitFinderTools::createDummyRefDetHit(const JPetPhysSignal& signalB)
   return hit;
 }
 
+/**
+ * Method for creation of the hit with slim signals, built from the fields
+ * of the given hit, without copying its signals.
+ * Signals, that were not set (like side A of reference detector hits), stay unset.
+ */
+JPetHit HitFinderTools::createSlimHit(const JPetHit& hit)
+{
+  JPetHit slimHit;
+  if (hit.isSignalASet()) { slimHit.setSignalA(SlimSignalTools::createSlimSignal(hit.getSignalA())); }
+  if (hit.isSignalBSet()) { slimHit.setSignalB(SlimSignalTools::createSlimSignal(hit.getSignalB())); }
+  slimHit.setTime(hit.getTime());
+  slimHit.setQualityOfTime(hit.getQualityOfTime());
+  slimHit.setTimeDiff(hit.getTimeDiff());
+  slimHit.setQualityOfTimeDiff(hit.getQualityOfTimeDiff());
+  slimHit.setEnergy(hit.getEnergy());
+  slimHit.setQualityOfEnergy(hit.getQualityOfEnergy());
+  slimHit.setPos(hit.getPosX(), hit.getPosY(), hit.getPosZ());
+  slimHit.setScintillator(hit.getScintillator());
+  slimHit.setBarrelSlot(hit.getBarrelSlot());
+  slimHit.setRecoFlag(hit.getRecoFlag());
+  return slimHit;
+}
+
 /**
  * Helper method for getting TOMB channel
  */
@@ -289,8 +335,8 @@ double HitFinderTools::calculateTOT(const JPetHit& hit, TOTCalculationType type)
 {
   double tot = 0.0;
 
-  std::map<int, double> thrToTOT_sideA = hit.getSignalA().getRecoSignal().getRawSignal().getTOTsVsThresholdValue();
-  std::map<int, double> thrToTOT_sideB = hit.getSignalB().getRecoSignal().getRawSignal().getTOTsVsThresholdValue();
+  std::map<int, double> thrToTOT_sideA = SlimSignalTools::getTOTsVsThresholdValue(hit.getSignalA());
+  std::map<int, double> thrToTOT_sideB = SlimSignalTools::getTOTsVsThresholdValue(hit.getSignalB());
 
   tot += calculateTOTside(thrToTOT_sideA, type);
   tot += calculateTOTside(thrToTOT_sideB, type);
@@ -19,6 +19,7 @@
 #include <JPetStatistics/JPetStatistics.h>
 #include <JPetTimeWindow/JPetTimeWindow.h>
 #include "ToTEnergyConverter.h"
+#include "TimeWindowArena.h"
 #include <JPetHit/JPetHit.h>
 #include <vector>
 
@@ -26,7 +27,8 @@
  * @brief Tools set fot HitFinder module
  *
  * Tols include methods of signal mapping and matching,
- * helpers of sorting, radian check and methods for reference detecctor
+ * helpers of sorting, radian check and methods for reference detecctor.
+ * Containers of Signals can be allocated from the Time Window arena of the task.
  *
  */
 class HitFinderTools
@@ -38,19 +40,26 @@ public:
     kThresholdRectangular,
     kThresholdTrapeze
   };
-  static void sortByTime(std::vector<JPetPhysSignal>& signals);
-  static std::map<int, std::vector<JPetPhysSignal>> getSignalsBySlot(
-    const JPetTimeWindow* timeWindow, bool useCorrupts
+  using SignalVector = ArenaVector<JPetPhysSignal>;
+  using SignalsBySlot = ArenaMap<int, SignalVector>;
+
+  template <typename SignalAlloc>
+  static void sortByTime(std::vector<JPetPhysSignal, SignalAlloc>& signals);
+  static SignalsBySlot getSignalsBySlot(
+    const JPetTimeWindow* timeWindow, bool useCorrupts,
+    TimeWindowArena* arena = nullptr
   );
+  template <typename SignalMap>
   static std::vector<JPetHit> matchAllSignals(
-    std::map<int, std::vector<JPetPhysSignal>>& allSignals,
+    SignalMap& allSignals,
     const std::map<unsigned int, std::vector<double>>& velocitiesMap,
     double timeDiffAB, int refDetScinId, bool convertToT,
     const tot_energy_converter::ToTEnergyConverter& totConverter,
     JPetStatistics& stats, bool saveHistos
   );
+  template <typename SignalAlloc>
   static std::vector<JPetHit> matchSignals(
-    std::vector<JPetPhysSignal>& slotSignals,
+    std::vector<JPetPhysSignal, SignalAlloc>& slotSignals,
     const std::map<unsigned int, std::vector<double>>& velocitiesMap,
     double timeDiffAB, bool convertToT,
     const tot_energy_converter::ToTEnergyConverter& totConverter,
@@ -63,6 +72,7 @@ public:
     JPetStatistics& stats, bool saveHistos
   );
   static JPetHit createDummyRefDetHit(const JPetPhysSignal& signal);
+  static JPetHit createSlimHit(const JPetHit& hit);
   static int getProperChannel(const JPetPhysSignal& signal);
   static void checkTheta(const double& theta);
   static TOTCalculationType getTOTCalculationType(const std::string& type);
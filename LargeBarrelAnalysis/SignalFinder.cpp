@@ -93,12 +93,15 @@ bool SignalFinder::exec()
 {
   // Getting the data from event in an apropriate format
   if(auto timeWindow = dynamic_cast<const JPetTimeWindow* const>(fEvent)) {
+    TimeWindowArena::Scope arenaScope(fArena);
     // Distribute signal channels by PM IDs and filter out Corrupted SigChs if requested
-    auto& sigChByPM = SignalFinderTools::getSigChByPM(timeWindow, fUseCorruptedSigCh, fRefPMID);
+    auto sigChByPM = SignalFinderTools::getSigChByPM(
+      timeWindow, fUseCorruptedSigCh, fRefPMID, &fArena
+    );
     // Building signals
     auto allSignals = SignalFinderTools::buildAllSignals(
       sigChByPM, fSigChEdgeMaxTime, fSigChLeadTrailMaxTime,
-      getStatistics(), fSaveControlHistos, fThresholdOrderings
+      getStatistics(), fSaveControlHistos, fThresholdOrderings, &fArena
     );
     // Saving method invocation
     saveRawSignals(allSignals);
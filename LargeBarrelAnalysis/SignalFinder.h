@@ -32,7 +32,8 @@ class JPetWriter;
  *
  * Task organizes Signal Channels from every JPetTimeWindow to Raw Signals
  * Parameters for time window values used in tools can be specified in user options,
- * default are provided.
+ * default are provided. Temporary containers are allocated from the arena,
+ * that is reset after each Time Window.
  */
 class SignalFinder: public JPetUserTask
 {
@@ -59,6 +60,7 @@ protected:
   bool fSaveControlHistos = true;
   bool fOrderThresholdsByValue = false;
   int fRefPMID = 385;
+  TimeWindowArena fArena;
   void initialiseHistograms();
 };
 
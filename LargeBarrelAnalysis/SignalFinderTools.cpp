@@ -14,17 +14,20 @@
  */
 
 #include "SignalFinderTools.h"
+#include <cassert>
 using namespace std;
 
 const SignalFinderTools::Permutation SignalFinderTools::kIdentity = {0,1,2,3};
 
 /**
- * Method returns a map of vectors of JPetSigCh ordered by photomultiplier ID
+ * Method returns a map of vectors of JPetSigCh ordered by photomultiplier ID,
+ * if the arena is given, the map and the vectors are allocated from it
  */
-const map<int, vector<JPetSigCh>> SignalFinderTools::getSigChByPM(
-     const JPetTimeWindow* timeWindow, bool useCorrupts, int refPMID
+SignalFinderTools::SigChByPM SignalFinderTools::getSigChByPM(
+  const JPetTimeWindow* timeWindow, bool useCorrupts, int refPMID,
+  TimeWindowArena* arena
 ){
-  map<int, vector<JPetSigCh>> sigChsPMMap;
+  SigChByPM sigChsPMMap{SigChByPM::allocator_type(arena)};
   if (!timeWindow) {
     WARNING("Pointer of Time Window object is not set, returning empty map");
     return sigChsPMMap;
@@ -32,24 +35,20 @@ const map<int, vector<JPetSigCh>> SignalFinderTools::getSigChByPM(
   // Map Signal Channels according to PM they belong to
   const unsigned int nSigChs = timeWindow->getNumberOfEvents();
   for (unsigned int i = 0; i < nSigChs; i++) {
-    auto sigCh = dynamic_cast<const JPetSigCh&>(timeWindow->operator[](i));
+    const auto& sigCh = dynamic_cast<const JPetSigCh&>(timeWindow->operator[](i));
     // If it is set not to use Corrupted SigChs, such flagged objects will be skipped
     // Here we ignore the corrupted flag of signals from Refference detector
     // since removing them results in double peak structures in the calibration spectra
     int pmtID = sigCh.getPM().getID();
-    if(pmtID == refPMID) {
-      sigCh.setRecoFlag(JPetSigCh::Good);
-    }
-
-    if(!useCorrupts && sigCh.getRecoFlag() == JPetSigCh::Corrupted) { continue; }
+    if(pmtID != refPMID && !useCorrupts && sigCh.getRecoFlag() == JPetSigCh::Corrupted) { continue; }
 
     auto search = sigChsPMMap.find(pmtID);
     if (search == sigChsPMMap.end()) {
-      vector<JPetSigCh> tmp;
-      tmp.push_back(sigCh);
-      sigChsPMMap.insert(pair<int, vector<JPetSigCh>>(pmtID, tmp));
-    } else {
-      search->second.push_back(sigCh);
+      search = sigChsPMMap.emplace(pmtID, SigChVector(SigChVector::allocator_type(arena))).first;
+    }
+    search->second.push_back(sigCh);
+    if(pmtID == refPMID) {
+      search->second.back().setRecoFlag(JPetSigCh::Good);
     }
   }
   return sigChsPMMap;
@@ -59,10 +58,10 @@ const map<int, vector<JPetSigCh>> SignalFinderTools::getSigChByPM(
  * Method invoking Raw Signal building method for each PM separately
  */
 vector<JPetRawSignal> SignalFinderTools::buildAllSignals(
-   const map<int, vector<JPetSigCh>>& sigChByPM,
+   const SigChByPM& sigChByPM,
    double sigChEdgeMaxTime, double sigChLeadTrailMaxTime,
    JPetStatistics& stats, bool saveHistos,
-   ThresholdOrderings thresholdOrderings
+   ThresholdOrderings thresholdOrderings, TimeWindowArena* arena
 ) {
   vector<JPetRawSignal> allSignals;
   
@@ -75,7 +74,7 @@ vector<JPetRawSignal> SignalFinderTools::buildAllSignals(
     }
 
     auto signals = buildRawSignals(
-      sigChPair.second, sigChEdgeMaxTime, sigChLeadTrailMaxTime, stats, saveHistos, P
+      sigChPair.second, sigChEdgeMaxTime, sigChLeadTrailMaxTime, stats, saveHistos, P, arena
     );
     allSignals.insert(allSignals.end(), signals.begin(), signals.end());
   }
@@ -88,18 +87,24 @@ vector<JPetRawSignal> SignalFinderTools::buildAllSignals(
  * RawSignal is created with all Leading SigChs that are found within first
  * time window (sigChEdgeMaxTime parameter) and all Trailing SigChs that conform
  * to second time window (sigChLeadTrailMaxTime parameter).
+ * Signal Channels sorted by thresholds are kept in the arena, if it is given.
  */
- vector<JPetRawSignal> SignalFinderTools::buildRawSignals(
-   const vector<JPetSigCh>& sigChByPM,
+template <typename SigChAlloc>
+vector<JPetRawSignal> SignalFinderTools::buildRawSignals(
+   const vector<JPetSigCh, SigChAlloc>& sigChByPM,
    double sigChEdgeMaxTime, double sigChLeadTrailMaxTime,
    JPetStatistics& stats, bool saveHistos,
-   Permutation ordering
+   Permutation ordering, TimeWindowArena* arena
  ) {
   vector<JPetRawSignal> rawSigVec;
 
-  vector<JPetSigCh> tmpVec;
-  vector<vector<JPetSigCh>> thrLeadingSigCh(kNumberOfThresholds, tmpVec);
-  vector<vector<JPetSigCh>> thrTrailingSigCh(kNumberOfThresholds, tmpVec);
+  SigChVector tmpVec{SigChVector::allocator_type(arena)};
+  ArenaVector<SigChVector> thrLeadingSigCh(
+    kNumberOfThresholds, tmpVec, ArenaVector<SigChVector>::allocator_type(arena)
+  );
+  ArenaVector<SigChVector> thrTrailingSigCh(
+    kNumberOfThresholds, tmpVec, ArenaVector<SigChVector>::allocator_type(arena)
+  );
   for (const JPetSigCh& sigCh : sigChByPM) {
     if(sigCh.getType() == JPetSigCh::Leading) {
       thrLeadingSigCh.at(ordering[sigCh.getThresholdNumber()-1]).push_back(sigCh);
@@ -211,9 +216,10 @@ vector<JPetRawSignal> SignalFinderTools::buildAllSignals(
 /**
  * Method finds Signal Channels that belong to the same leading edge
  */
+template <typename SigChAlloc>
 int SignalFinderTools::findSigChOnNextThr(
   double sigChValue,double sigChEdgeMaxTime,
-  const vector<JPetSigCh>& sigChVec
+  const vector<JPetSigCh, SigChAlloc>& sigChVec
 ) {
   for (size_t i = 0; i < sigChVec.size(); i++) {
     if (fabs(sigChValue-sigChVec.at(i).getValue()) < sigChEdgeMaxTime){ return i; }
@@ -227,22 +233,30 @@ int SignalFinderTools::findSigChOnNextThr(
  * returning the one with the smallest index, that is equivalent of SigCh
  * earliest in time
  */
+template <typename SigChAlloc>
 int SignalFinderTools::findTrailingSigCh(
   const JPetSigCh& leadingSigCh, double sigChLeadTrailMaxTime,
-  const vector<JPetSigCh>& trailingSigChVec
+  const vector<JPetSigCh, SigChAlloc>& trailingSigChVec
 ) {
-  vector<int> trailingFoundIdices;
   for (size_t i = 0; i < trailingSigChVec.size(); i++) {
     double timeDiff = trailingSigChVec.at(i).getValue() - leadingSigCh.getValue();
-    if (timeDiff > 0.0 && timeDiff < sigChLeadTrailMaxTime){
-      trailingFoundIdices.push_back(i);
-    }
+    if (timeDiff > 0.0 && timeDiff < sigChLeadTrailMaxTime){ return i; }
   }
-  if (trailingFoundIdices.size() == 0) { return -1; }
-  sort(trailingFoundIdices.begin(), trailingFoundIdices.end());
-  return trailingFoundIdices.at(0);
+  return -1;
 }
 
+// Instantiations for containers allocated from the arena and standard ones
+template vector<JPetRawSignal> SignalFinderTools::buildRawSignals(
+  const SigChVector&, double, double, JPetStatistics&, bool, Permutation, TimeWindowArena*
+);
+template vector<JPetRawSignal> SignalFinderTools::buildRawSignals(
+  const vector<JPetSigCh>&, double, double, JPetStatistics&, bool, Permutation, TimeWindowArena*
+);
+template int SignalFinderTools::findSigChOnNextThr(double, double, const SigChVector&);
+template int SignalFinderTools::findSigChOnNextThr(double, double, const vector<JPetSigCh>&);
+template int SignalFinderTools::findTrailingSigCh(const JPetSigCh&, double, const SigChVector&);
+template int SignalFinderTools::findTrailingSigCh(const JPetSigCh&, double, const vector<JPetSigCh>&);
+
 /**
  * Method finds a 4-element permutation which has to be applied to threshold numbers
  * to have them sorted by increasing threshold values.
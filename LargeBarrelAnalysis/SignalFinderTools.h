@@ -19,7 +19,8 @@
 /**
  * @brief Set of tools for Signal Finder task
  *
- * Contains methods building Raw Signals from Signal Channels
+ * Contains methods building Raw Signals from Signal Channels. Containers
+ * of Signal Channels can be allocated from the Time Window arena of the task.
  */
 
 #include <JPetStatistics/JPetStatistics.h>
@@ -27,6 +28,7 @@
 #include <JPetRawSignal/JPetRawSignal.h>
 #include <JPetParamBank/JPetParamBank.h>
 #include <JPetSigCh/JPetSigCh.h>
+#include "TimeWindowArena.h"
 #include <utility>
 #include <vector>
 #include <map>
@@ -42,28 +44,36 @@ public:
   using ThresholdOrderings = std::map<PMid, Permutation>;
   static const Permutation kIdentity;
 
-  static const std::map<int, std::vector<JPetSigCh>> getSigChByPM(
-     const JPetTimeWindow* timeWindow, bool useCorrupts, int refPMID
+  using SigChVector = ArenaVector<JPetSigCh>;
+  using SigChByPM = ArenaMap<int, SigChVector>;
+
+  static SigChByPM getSigChByPM(
+    const JPetTimeWindow* timeWindow, bool useCorrupts, int refPMID,
+    TimeWindowArena* arena = nullptr
   );
   static std::vector<JPetRawSignal> buildAllSignals(
-    const std::map<int, std::vector<JPetSigCh>>& sigChByPM,
+    const SigChByPM& sigChByPM,
     double sigChEdgeMaxTime, double sigChLeadTrailMaxTime,
     JPetStatistics& stats, bool saveHistos,
-    ThresholdOrderings thresholdOrderings
+    ThresholdOrderings thresholdOrderings, TimeWindowArena* arena = nullptr
   );
+  template <typename SigChAlloc>
   static std::vector<JPetRawSignal> buildRawSignals(
-    const std::vector<JPetSigCh>& sigChByPM,
+    const std::vector<JPetSigCh, SigChAlloc>& sigChByPM,
     double sigChEdgeMaxTime, double sigChLeadTrailMaxTime,
     JPetStatistics& stats, bool saveHistos,
-    Permutation ordering = SignalFinderTools::kIdentity
+    Permutation ordering = SignalFinderTools::kIdentity,
+    TimeWindowArena* arena = nullptr
   );
+  template <typename SigChAlloc>
   static int findSigChOnNextThr(
     double sigChValue, double sigChEdgeMaxTime,
-    const std::vector<JPetSigCh>& sigChVec
+    const std::vector<JPetSigCh, SigChAlloc>& sigChVec
   );
+  template <typename SigChAlloc>
   static int findTrailingSigCh(
     const JPetSigCh& leadingSigCh,double sigChLeadTrailMaxTime,
-    const std::vector<JPetSigCh>& trailingSigChVec
+    const std::vector<JPetSigCh, SigChAlloc>& trailingSigChVec
   );
   static ThresholdOrderings findThresholdOrders(const JPetParamBank& bank);
   static void permuteThresholdsByValue(const ThresholdValues& threshold_values, Permutation& new_ordering);
@@ -0,0 +1,125 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file SlimSignalTools.cpp
+ */
+
+#include "SlimSignalTools.h"
+#include <limits>
+
+using namespace std;
+
+const float SlimSignalTools::kSlimSignalDelay = -numeric_limits<float>::max();
+
+/**
+ * Method for creation of a slim copy of the signal, without Signal Channels.
+ * Threshold crossings are stored in the shape of the Reco Signal, as described
+ * in the class documentation, fields of the Physical Signal are copied.
+ */
+JPetPhysSignal SlimSignalTools::createSlimSignal(const JPetPhysSignal& signal)
+{
+  const auto& rawSignal = signal.getRecoSignal().getRawSignal();
+  auto leadingSigChs = rawSignal.getPoints(JPetSigCh::Leading, JPetRawSignal::ByThrNum);
+  auto trailingSigChs = rawSignal.getPoints(JPetSigCh::Trailing, JPetRawSignal::ByThrNum);
+
+  JPetRecoSignal slimRecoSignal;
+  slimRecoSignal.setDelay(kSlimSignalDelay);
+  slimRecoSignal.setShapePoint(leadingSigChs.size(), trailingSigChs.size());
+  for (const auto& sigCh : leadingSigChs) {
+    slimRecoSignal.setShapePoint(sigCh.getValue() - signal.getTime(), sigCh.getThreshold());
+  }
+  for (const auto& sigCh : trailingSigChs) {
+    slimRecoSignal.setShapePoint(sigCh.getValue() - signal.getTime(), sigCh.getThreshold());
+  }
+  slimRecoSignal.setPM(signal.getPM());
+  slimRecoSignal.setBarrelSlot(signal.getBarrelSlot());
+  slimRecoSignal.setRecoFlag(signal.getRecoSignal().getRecoFlag());
+
+  JPetPhysSignal slimSignal;
+  slimSignal.setRecoSignal(slimRecoSignal);
+  slimSignal.setTime(signal.getTime());
+  slimSignal.setQualityOfTime(signal.getQualityOfTime());
+  slimSignal.setPhe(signal.getPhe());
+  slimSignal.setQualityOfPhe(signal.getQualityOfPhe());
+  slimSignal.setPM(signal.getPM());
+  slimSignal.setBarrelSlot(signal.getBarrelSlot());
+  slimSignal.setRecoFlag(signal.getRecoFlag());
+  return slimSignal;
+}
+
+bool SlimSignalTools::isSlimSignal(const JPetPhysSignal& signal)
+{
+  return signal.getRecoSignal().getDelay() == kSlimSignalDelay;
+}
+
+bool SlimSignalTools::isSlimHit(const JPetHit& hit)
+{
+  return isSlimSignal(hit.getSignalA()) || isSlimSignal(hit.getSignalB());
+}
+
+/**
+ * Method returning threshold crossings of the signal with absolute times,
+ * decoded from the slim signal or read from Signal Channels of the full one.
+ * Slim signal with inconsistent shape gives no crossings.
+ */
+vector<ThresholdCrossing> SlimSignalTools::getThresholdCrossings(const JPetPhysSignal& signal)
+{
+  vector<ThresholdCrossing> crossings;
+  if (!isSlimSignal(signal)) {
+    const auto& rawSignal = signal.getRecoSignal().getRawSignal();
+    for (auto edge : {JPetSigCh::Leading, JPetSigCh::Trailing}) {
+      for (const auto& sigCh : rawSignal.getPoints(edge, JPetRawSignal::ByThrNum)) {
+        ThresholdCrossing crossing;
+        crossing.edge = edge;
+        crossing.threshold = sigCh.getThreshold();
+        crossing.time = sigCh.getValue();
+        crossings.push_back(crossing);
+      }
+    }
+    return crossings;
+  }
+  const auto& shape = signal.getRecoSignal().getShape();
+  if (shape.empty() || shape[0].time < 0 || shape[0].amplitude < 0) { return crossings; }
+  const size_t numberOfLeading = shape[0].time;
+  const size_t numberOfTrailing = shape[0].amplitude;
+  if (shape.size() != 1 + numberOfLeading + numberOfTrailing) { return crossings; }
+  crossings.reserve(numberOfLeading + numberOfTrailing);
+  for (size_t i = 1; i < shape.size(); i++) {
+    ThresholdCrossing crossing;
+    crossing.edge = i <= numberOfLeading ? JPetSigCh::Leading : JPetSigCh::Trailing;
+    crossing.threshold = shape[i].amplitude;
+    crossing.time = signal.getTime() + shape[i].time;
+    crossings.push_back(crossing);
+  }
+  return crossings;
+}
+
+/**
+ * Method returning TOTs of the signal vs. threshold values, the same as
+ * JPetRawSignal::getTOTsVsThresholdValue for full signals. Only thresholds
+ * with both leading and trailing edge have TOT.
+ */
+map<int, double> SlimSignalTools::getTOTsVsThresholdValue(const JPetPhysSignal& signal)
+{
+  if (!isSlimSignal(signal)) { return signal.getRecoSignal().getRawSignal().getTOTsVsThresholdValue(); }
+  map<int, double> leadingTimes, trailingTimes;
+  for (const auto& crossing : getThresholdCrossings(signal)) {
+    auto& times = crossing.edge == JPetSigCh::Leading ? leadingTimes : trailingTimes;
+    times[static_cast<int>(crossing.threshold)] = crossing.time;
+  }
+  map<int, double> thrToTOT;
+  for (const auto& leading : leadingTimes) {
+    auto trailing = trailingTimes.find(leading.first);
+    if (trailing != trailingTimes.end()) { thrToTOT[leading.first] = trailing->second - leading.second; }
+  }
+  return thrToTOT;
+}
@@ -0,0 +1,62 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file SlimSignalTools.h
+ */
+
+#ifndef SLIMSIGNALTOOLS_H
+#define SLIMSIGNALTOOLS_H
+
+#include <JPetPhysSignal/JPetPhysSignal.h>
+#include <JPetSigCh/JPetSigCh.h>
+#include <JPetHit/JPetHit.h>
+#include <vector>
+#include <map>
+
+/**
+ * @brief Crossing of the threshold by the signal, decoded from the slim signal
+ */
+struct ThresholdCrossing
+{
+  JPetSigCh::EdgeType edge = JPetSigCh::Leading;
+  float threshold = 0.0;
+  double time = 0.0;
+};
+
+/**
+ * @brief Tools creating and decoding slim Physical Signals
+ *
+ * Slim signal keeps no Signal Channels, its Raw Signal is empty. Signal is
+ * marked as slim with the delay of its Reco Signal set to kSlimSignalDelay,
+ * a value that is never calculated for real signals, and only then
+ * the shape of the Reco Signal holds the threshold crossings:
+ * - first point: number of leading crossings as time, number of trailing
+ *   crossings as amplitude,
+ * - leading crossings followed by trailing crossings, each as time
+ *   relative to the time of the signal and threshold value.
+ * Shape of signals without the mark is never interpreted as crossings.
+ * Tasks working on Signal Channels (e.g. calibrations) should reject hits,
+ * for which isSlimHit() is true.
+ */
+class SlimSignalTools
+{
+public:
+  static const float kSlimSignalDelay;
+
+  static JPetPhysSignal createSlimSignal(const JPetPhysSignal& signal);
+  static bool isSlimSignal(const JPetPhysSignal& signal);
+  static bool isSlimHit(const JPetHit& hit);
+  static std::vector<ThresholdCrossing> getThresholdCrossings(const JPetPhysSignal& signal);
+  static std::map<int, double> getTOTsVsThresholdValue(const JPetPhysSignal& signal);
+};
+
+#endif /* !SLIMSIGNALTOOLS_H */
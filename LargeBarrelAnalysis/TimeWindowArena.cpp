@@ -0,0 +1,95 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file TimeWindowArena.cpp
+ */
+
+#include "TimeWindowArena.h"
+#include <algorithm>
+
+using namespace std;
+
+TimeWindowArena::TimeWindowArena(size_t blockSize): fBlockSize(max(blockSize, size_t(64))) {}
+
+TimeWindowArena::~TimeWindowArena()
+{
+  for (auto& block : fBlocks) {
+    ::operator delete(block.data);
+  }
+}
+
+/**
+ * Returns memory aligned to the given alignment, which has to be a power of 2
+ * not greater than alignment of the global new. When the current block is full,
+ * next kept block is used or a new one is created.
+ */
+void* TimeWindowArena::allocate(size_t bytes, size_t alignment)
+{
+  while (true) {
+    if (fCurrentBlock < fBlocks.size()) {
+      auto& block = fBlocks[fCurrentBlock];
+      size_t alignedOffset = (fOffset + alignment - 1) & ~(alignment - 1);
+      if (alignedOffset + bytes <= block.size) {
+        fOffset = alignedOffset + bytes;
+        fUsedBytes += bytes;
+        return block.data + alignedOffset;
+      }
+      if (fCurrentBlock + 1 < fBlocks.size()) {
+        fCurrentBlock++;
+        fOffset = 0;
+        continue;
+      }
+    }
+    addBlock(bytes + alignment);
+    fCurrentBlock = fBlocks.size() - 1;
+    fOffset = 0;
+  }
+}
+
+void TimeWindowArena::addBlock(size_t minSize)
+{
+  size_t size = max(fBlockSize, minSize);
+  fBlocks.push_back({static_cast<char*>(::operator new(size)), size});
+}
+
+/**
+ * Releasing all the memory at once. If more than one block was needed,
+ * blocks are merged into one, that fits the whole Time Window next time.
+ */
+void TimeWindowArena::reset()
+{
+  if (fBlocks.size() > 1) {
+    size_t capacity = getCapacity();
+    for (auto& block : fBlocks) {
+      ::operator delete(block.data);
+    }
+    fBlocks.clear();
+    addBlock(capacity);
+  }
+  fCurrentBlock = 0;
+  fOffset = 0;
+  fUsedBytes = 0;
+}
+
+size_t TimeWindowArena::getUsedBytes() const
+{
+  return fUsedBytes;
+}
+
+size_t TimeWindowArena::getCapacity() const
+{
+  size_t capacity = 0;
+  for (const auto& block : fBlocks) {
+    capacity += block.size;
+  }
+  return capacity;
+}
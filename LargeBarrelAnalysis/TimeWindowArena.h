@@ -0,0 +1,130 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file TimeWindowArena.h
+ */
+
+#ifndef TIMEWINDOWARENA_H
+#define TIMEWINDOWARENA_H
+
+#include <functional>
+#include <cstddef>
+#include <vector>
+#include <map>
+#include <new>
+
+/**
+ * @brief Monotonic memory arena for objects living during one Time Window
+ *
+ * Memory is handed out from large blocks and never freed separately,
+ * all of it is released at once with reset(). Blocks are kept between
+ * resets, so after the first few Time Windows containers of a task
+ * do not call the global allocator at all. Memory used by containers,
+ * that are still alive, must not be reset - tasks use Scope object,
+ * created at the beginning of exec(), to reset the arena at its end.
+ */
+class TimeWindowArena
+{
+public:
+  static const std::size_t kDefaultBlockSize = 1 << 20;
+
+  class Scope
+  {
+  public:
+    explicit Scope(TimeWindowArena& arena): fArena(arena) {}
+    ~Scope() { fArena.reset(); }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+  private:
+    TimeWindowArena& fArena;
+  };
+
+  explicit TimeWindowArena(std::size_t blockSize = kDefaultBlockSize);
+  ~TimeWindowArena();
+  TimeWindowArena(const TimeWindowArena&) = delete;
+  TimeWindowArena& operator=(const TimeWindowArena&) = delete;
+
+  void* allocate(std::size_t bytes, std::size_t alignment);
+  void reset();
+  std::size_t getUsedBytes() const;
+  std::size_t getCapacity() const;
+
+private:
+  struct Block
+  {
+    char* data;
+    std::size_t size;
+  };
+  void addBlock(std::size_t minSize);
+
+  std::size_t fBlockSize;
+  std::vector<Block> fBlocks;
+  std::size_t fCurrentBlock = 0;
+  std::size_t fOffset = 0;
+  std::size_t fUsedBytes = 0;
+};
+
+/**
+ * @brief Allocator for standard containers, taking memory from TimeWindowArena
+ *
+ * Default constructed allocator has no arena and uses global new and delete,
+ * so containers of this type can be used also outside of the tasks.
+ */
+template <typename T>
+class ArenaAllocator
+{
+public:
+  using value_type = T;
+
+  ArenaAllocator() noexcept {}
+  explicit ArenaAllocator(TimeWindowArena* arena) noexcept: fArena(arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept: fArena(other.getArena()) {}
+
+  T* allocate(std::size_t n)
+  {
+    if (fArena) {
+      return static_cast<T*>(fArena->allocate(n * sizeof(T), alignof(T)));
+    }
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T* pointer, std::size_t) noexcept
+  {
+    if (!fArena) { ::operator delete(pointer); }
+  }
+
+  TimeWindowArena* getArena() const noexcept { return fArena; }
+
+private:
+  TimeWindowArena* fArena = nullptr;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& first, const ArenaAllocator<U>& second) noexcept
+{
+  return first.getArena() == second.getArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& first, const ArenaAllocator<U>& second) noexcept
+{
+  return !(first == second);
+}
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+template <typename Key, typename T>
+using ArenaMap = std::map<Key, T, std::less<Key>, ArenaAllocator<std::pair<const Key, T>>>;
+
+#endif /* !TIMEWINDOWARENA_H */
@@ -15,11 +15,32 @@
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/filesystem.hpp>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
 #include <sstream>
+#include <fstream>
+#include <cstring>
+#include <limits>
+#include <cmath>
 #include "UniversalFileLoader.h"
 #include "JPetLoggerInclude.h"
 
+namespace
+{
+const char kBinaryConfMagic[8] = {'J', 'P', 'E', 'T', 'C', 'O', 'N', 'F'};
+const uint32_t kBinaryConfByteOrder = 0x01020304;
+const uint32_t kNumberOfLayers = 3;
+const uint32_t kNumberOfSlots = 96;
+const uint32_t kNumberOfSides = 2;
+const uint32_t kNumberOfThresholds = 4;
+const uint32_t kNumberOfParameters = 8;
+}
+
+static_assert(sizeof(BinaryConfHeader) == 64, "Binary configuration header has to be 64 bytes long");
+
 /**
  * Method returns a patameter for given TOMB channel
  */
@@ -50,6 +71,9 @@ UniversalFileLoader::TOMBChToParameter UniversalFileLoader::loadConfigurationPar
     TOMBChToParameter cofigurationParamteres;
     return cofigurationParamteres;
   }
+  if (isBinaryConfFile(confFile)) {
+    return generateConfigurationParameters(mapBinaryConfFile(confFile), tombMap);
+  }
   auto confRecords = readConfigurationParametersFromFile(confFile);
   return generateConfigurationParameters(confRecords, tombMap);
 }
@@ -179,3 +203,204 @@ bool UniversalFileLoader::fillConfRecord(
     return true;
   }
 }
+
+/**
+ * Method checks if the file starts with the header of binary configuration file
+ */
+bool UniversalFileLoader::isBinaryConfFile(const std::string& confFile)
+{
+  char magic[sizeof(kBinaryConfMagic)];
+  std::ifstream inputFile(confFile, std::ios::binary);
+  if (!inputFile.read(magic, sizeof(magic))) return false;
+  return std::memcmp(magic, kBinaryConfMagic, sizeof(magic)) == 0;
+}
+
+/**
+ * Method converts ASCII file with configuration parameters to the binary format.
+ * Returns false if the ASCII file contains invalid records or the binary
+ * file could not be written.
+ */
+bool UniversalFileLoader::convertToBinaryConfFile(
+  const std::string& confFile, const std::string& binaryFile)
+{
+  auto confRecords = readConfigurationParametersFromFile(confFile);
+  if (confRecords.empty() || !areConfRecordsValid(confRecords)) {
+    ERROR("No valid configuration records in file " + confFile + ", binary file is not created.");
+    return false;
+  }
+  BinaryConfHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kBinaryConfMagic, sizeof(header.magic));
+  header.byteOrder = kBinaryConfByteOrder;
+  header.version = kBinaryConfVersion;
+  header.numberOfLayers = kNumberOfLayers;
+  header.numberOfSlots = kNumberOfSlots;
+  header.numberOfSides = kNumberOfSides;
+  header.numberOfThresholds = kNumberOfThresholds;
+  header.numberOfParameters = kNumberOfParameters;
+  header.tableOffset = sizeof(header);
+  header.tableSize = static_cast<uint64_t>(kNumberOfLayers) * kNumberOfSlots
+    * kNumberOfSides * kNumberOfThresholds * kNumberOfParameters;
+
+  std::vector<double> table(header.tableSize, std::numeric_limits<double>::quiet_NaN());
+  for (const auto& confRecord : confRecords) {
+    auto index = ((((confRecord.layer - 1) * kNumberOfSlots + (confRecord.slot - 1))
+      * kNumberOfSides + (confRecord.side == JPetPM::SideA ? 0 : 1))
+      * kNumberOfThresholds + (confRecord.thresholdNumber - 1)) * kNumberOfParameters;
+    std::copy(confRecord.parameters.begin(), confRecord.parameters.end(), table.begin() + index);
+  }
+
+  std::ofstream outputFile(binaryFile, std::ios::binary | std::ios::trunc);
+  outputFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  outputFile.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(double));
+  if (!outputFile) {
+    ERROR("Could not write binary configuration file " + binaryFile);
+    return false;
+  }
+  INFO("Configuration parameters from " + confFile + " saved in binary file " + binaryFile);
+  return true;
+}
+
+/**
+ * Method maps the binary configuration file to memory. Returned view is
+ * invalid if the file could not be mapped or its header is not correct.
+ */
+BinaryConfView UniversalFileLoader::mapBinaryConfFile(const std::string& binaryFile)
+{
+  BinaryConfView view;
+  int fileDescriptor = open(binaryFile.c_str(), O_RDONLY);
+  if (fileDescriptor < 0) {
+    ERROR("Could not open binary configuration file " + binaryFile);
+    return view;
+  }
+  struct stat fileStatus;
+  if (fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size < static_cast<off_t>(sizeof(BinaryConfHeader))) {
+    ERROR("Binary configuration file " + binaryFile + " is too short.");
+    close(fileDescriptor);
+    return view;
+  }
+  void* data = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+  close(fileDescriptor);
+  if (data == MAP_FAILED) {
+    ERROR("Could not map binary configuration file " + binaryFile);
+    return view;
+  }
+  view.fMappedData = data;
+  view.fMappedSize = fileStatus.st_size;
+
+  auto header = static_cast<const BinaryConfHeader*>(data);
+  uint64_t expectedSize = static_cast<uint64_t>(header->numberOfLayers) * header->numberOfSlots
+    * header->numberOfSides * header->numberOfThresholds * header->numberOfParameters;
+  if (std::memcmp(header->magic, kBinaryConfMagic, sizeof(header->magic)) != 0
+    || header->byteOrder != kBinaryConfByteOrder) {
+    ERROR("File " + binaryFile + " is not a binary configuration file of this architecture.");
+    view.unmap();
+  } else if (header->version != kBinaryConfVersion) {
+    ERROR("Unsupported version " + std::to_string(header->version) + " of binary configuration file " + binaryFile);
+    view.unmap();
+  } else if (header->numberOfSides != kNumberOfSides || header->tableSize != expectedSize
+    || header->tableOffset % sizeof(double) != 0
+    || header->tableOffset + header->tableSize * sizeof(double) > view.fMappedSize) {
+    ERROR("Binary configuration file " + binaryFile + " is corrupted.");
+    view.unmap();
+  } else {
+    view.fHeader = header;
+    view.fTable = reinterpret_cast<const double*>(static_cast<const char*>(data) + header->tableOffset);
+  }
+  return view;
+}
+
+/**
+ * Method generates a dependedce map between TOMB channel numbers and
+ * configuration paramters read from the binary file view. Only channels
+ * present in the TOMB map with parameters set in the file are included.
+ */
+UniversalFileLoader::TOMBChToParameter UniversalFileLoader::generateConfigurationParameters(
+  const BinaryConfView& view,
+  const UniversalFileLoader::TOMBChMap& tombMap)
+{
+  TOMBChToParameter configurationParamteres;
+  if (!view.isValid()) {
+    ERROR("Empty configuration shall be returned!");
+    return configurationParamteres;
+  }
+  const unsigned int nParameters = view.getNumberOfParameters();
+  for (const auto& channel : tombMap) {
+    auto parameters = view.getParameters(
+      std::get<0>(channel.first), std::get<1>(channel.first),
+      std::get<2>(channel.first), std::get<3>(channel.first)
+    );
+    if (parameters) {
+      configurationParamteres.emplace(
+        channel.second, std::vector<double>(parameters, parameters + nParameters)
+      );
+    }
+  }
+  return configurationParamteres;
+}
+
+BinaryConfView::BinaryConfView(BinaryConfView&& other):
+  fMappedData(other.fMappedData), fMappedSize(other.fMappedSize),
+  fHeader(other.fHeader), fTable(other.fTable)
+{
+  other.fMappedData = nullptr;
+  other.fMappedSize = 0;
+  other.fHeader = nullptr;
+  other.fTable = nullptr;
+}
+
+BinaryConfView& BinaryConfView::operator=(BinaryConfView&& other)
+{
+  if (this != &other) {
+    unmap();
+    std::swap(fMappedData, other.fMappedData);
+    std::swap(fMappedSize, other.fMappedSize);
+    std::swap(fHeader, other.fHeader);
+    std::swap(fTable, other.fTable);
+  }
+  return *this;
+}
+
+BinaryConfView::~BinaryConfView()
+{
+  unmap();
+}
+
+void BinaryConfView::unmap()
+{
+  if (fMappedData) munmap(fMappedData, fMappedSize);
+  fMappedData = nullptr;
+  fMappedSize = 0;
+  fHeader = nullptr;
+  fTable = nullptr;
+}
+
+bool BinaryConfView::isValid() const
+{
+  return fTable != nullptr;
+}
+
+unsigned int BinaryConfView::getNumberOfParameters() const
+{
+  return fHeader ? fHeader->numberOfParameters : 0;
+}
+
+/**
+ * Returns pointer to parameters of given channel, or nullptr if the channel
+ * is out of the table range or its parameters were not set
+ */
+const double* BinaryConfView::getParameters(
+  int layer, int slot, JPetPM::Side side, int thresholdNumber) const
+{
+  if (!isValid()
+    || layer < 1 || layer > static_cast<int>(fHeader->numberOfLayers)
+    || slot < 1 || slot > static_cast<int>(fHeader->numberOfSlots)
+    || thresholdNumber < 1 || thresholdNumber > static_cast<int>(fHeader->numberOfThresholds)) {
+    return nullptr;
+  }
+  auto index = ((((layer - 1) * fHeader->numberOfSlots + (slot - 1))
+    * fHeader->numberOfSides + (side == JPetPM::SideA ? 0 : 1))
+    * fHeader->numberOfThresholds + (thresholdNumber - 1)) * fHeader->numberOfParameters;
+  const double* parameters = fTable + index;
+  return std::isnan(parameters[0]) ? nullptr : parameters;
+}
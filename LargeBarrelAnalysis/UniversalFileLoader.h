@@ -22,8 +22,14 @@
  * that is in standard format of Layer-Slot-Side-Threshold
  * Contains of structure of records that has to be initialized by user,
  * and methods of reading and validating constatns.
+ * Parameters can be also converted to a binary file with a dense table,
+ * that is mapped to memory instead of being parsed.
  */
 
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <tuple>
 #include <map>
 #include <string>
 #include "JPetPM/JPetPM.h"
@@ -43,9 +49,59 @@ struct ConfRecord {
   std::vector<double> parameters;
 };
 
+/**
+ * Header of the binary configuration file. It is followed by a dense table of
+ * doubles, with numberOfParameters values for every combination of layer,
+ * slot, side and threshold number (in this order, first index changing
+ * the slowest). Entries not present in the ASCII file are filled with NaN.
+ */
+struct BinaryConfHeader {
+  char magic[8];
+  uint32_t byteOrder;
+  uint32_t version;
+  uint32_t numberOfLayers;
+  uint32_t numberOfSlots;
+  uint32_t numberOfSides;
+  uint32_t numberOfThresholds;
+  uint32_t numberOfParameters;
+  uint32_t reserved;
+  uint64_t tableOffset;
+  uint64_t tableSize;
+  uint64_t reserved2;
+};
+
+/**
+ * Read-only view of the binary configuration file mapped to memory.
+ * Returned pointers are valid as long as the view exists.
+ */
+class BinaryConfView
+{
+public:
+  BinaryConfView() {}
+  BinaryConfView(BinaryConfView&& other);
+  BinaryConfView& operator=(BinaryConfView&& other);
+  ~BinaryConfView();
+  bool isValid() const;
+  unsigned int getNumberOfParameters() const;
+  const double* getParameters(int layer, int slot, JPetPM::Side side, int thresholdNumber) const;
+
+private:
+  friend class UniversalFileLoader;
+  BinaryConfView(const BinaryConfView&) = delete;
+  BinaryConfView& operator=(const BinaryConfView&) = delete;
+  void unmap();
+
+  void* fMappedData = nullptr;
+  std::size_t fMappedSize = 0;
+  const BinaryConfHeader* fHeader = nullptr;
+  const double* fTable = nullptr;
+};
+
 class UniversalFileLoader
 {
 public:
+  static const uint32_t kBinaryConfVersion = 1;
+
   typedef std::map<unsigned int, std::vector<double>> TOMBChToParameter;
   typedef std::map<std::tuple<int, int, JPetPM::Side, int>, int> TOMBChMap;
   static double getConfigurationParameter(const TOMBChToParameter& confParameters, const unsigned int channel);
@@ -54,6 +110,10 @@ public:
   static std::vector<ConfRecord> readConfigurationParametersFromFile(const std::string& confFile);
   static bool fillConfRecord(const std::string& input, ConfRecord& outRecord);
   static bool areConfRecordsValid(const std::vector<ConfRecord>& records);
+  static bool isBinaryConfFile(const std::string& confFile);
+  static bool convertToBinaryConfFile(const std::string& confFile, const std::string& binaryFile);
+  static BinaryConfView mapBinaryConfFile(const std::string& binaryFile);
+  static TOMBChToParameter generateConfigurationParameters(const BinaryConfView& view, const TOMBChMap& tombMap);
 
 private:
   UniversalFileLoader(const UniversalFileLoader&);
@@ -0,0 +1,169 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file EventCategorizerEngineTest.cpp
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE EventCategorizerEngineTests
+#include "../EventCategorizerEngine.h"
+#include "../EventCategorizerTools.h"
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+
+bool hasType(const std::vector<JPetEventType>& types, JPetEventType type)
+{
+  return std::find(types.begin(), types.end(), type) != types.end();
+}
+
+BOOST_AUTO_TEST_SUITE(EventCategorizerEngineSuite)
+
+BOOST_AUTO_TEST_CASE(emptyEngineTest) {
+  JPetHit hit;
+  JPetEvent event;
+  event.addHit(hit);
+  event.addHit(hit);
+
+  EventCategorizerEngine engine;
+  BOOST_REQUIRE(engine.categorize(event).empty());
+}
+
+BOOST_AUTO_TEST_CASE(featuresTest) {
+  JPetBarrelSlot slot(1, true, "first", 15.0, 1);
+  JPetHit hit;
+  hit.setBarrelSlot(slot);
+  hit.setTime(500.0);
+  hit.setPos(1.0, 2.0, 3.0);
+
+  JPetEvent event;
+  event.addHit(hit);
+
+  EventCategorizerEngine engine;
+  const auto& features = engine.computeFeatures(event);
+  BOOST_REQUIRE_EQUAL(features.size(), 1u);
+  BOOST_REQUIRE_EQUAL(features.at(0).time, 500.0);
+  BOOST_REQUIRE_EQUAL(features.at(0).theta, 15.0);
+  BOOST_REQUIRE_EQUAL(features.at(0).pos.Z(), 3.0);
+  BOOST_REQUIRE_EQUAL(features.at(0).tot, HitFinderTools::calculateTOT(hit));
+}
+
+BOOST_AUTO_TEST_CASE(check2GammaTest) {
+  JPetBarrelSlot firstSlot(1, true, "first", 1.0, 1);
+  JPetBarrelSlot secondSlot(2, true, "second", 182.0, 2);
+  JPetHit firstHit;
+  JPetHit secondHit;
+  firstHit.setBarrelSlot(firstSlot);
+  secondHit.setBarrelSlot(secondSlot);
+  firstHit.setTime(500.0);
+  secondHit.setTime(700.0);
+
+  JPetEvent event;
+  event.addHit(firstHit);
+  event.addHit(secondHit);
+
+  JPetStatistics stats;
+  std::vector<std::pair<double, double>> params = {{5.0, 1000.0}, {1.0, 1000.0}, {5.0, 10.0}};
+  for (const auto& param : params) {
+    EventCategorizerEngine engine;
+    engine.addPairPredicate(JPetEventType::k2Gamma,
+      EventCategorizerEngine::make2GammaPredicate(stats, false, param.first, param.second)
+    );
+    BOOST_REQUIRE_EQUAL(
+      hasType(engine.categorize(event), JPetEventType::k2Gamma),
+      EventCategorizerTools::checkFor2Gamma(event, stats, false, param.first, param.second)
+    );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(check3GammaTest) {
+  JPetBarrelSlot firstSlot(1, true, "first", 10.0, 1);
+  JPetBarrelSlot secondSlot(2, true, "second", 190.0, 2);
+  JPetBarrelSlot thirdSlot(3, true, "third", 45.5, 3);
+  JPetHit firstHit;
+  JPetHit secondHit;
+  JPetHit thirdHit;
+  firstHit.setBarrelSlot(firstSlot);
+  secondHit.setBarrelSlot(secondSlot);
+  thirdHit.setBarrelSlot(thirdSlot);
+
+  JPetEvent event1;
+  event1.addHit(firstHit);
+  event1.addHit(secondHit);
+
+  JPetEvent event2;
+  event2.addHit(firstHit);
+  event2.addHit(secondHit);
+  event2.addHit(thirdHit);
+
+  JPetStatistics stats;
+  EventCategorizerEngine engine;
+  engine.addTriplePredicate(JPetEventType::k3Gamma,
+    EventCategorizerEngine::make3GammaPredicate(stats, false), false
+  );
+  BOOST_REQUIRE(!hasType(engine.categorize(event1), JPetEventType::k3Gamma));
+  BOOST_REQUIRE(hasType(engine.categorize(event2), JPetEventType::k3Gamma));
+}
+
+BOOST_AUTO_TEST_CASE(checkScatterTest) {
+  JPetHit firstHit;
+  JPetHit secondHit;
+  firstHit.setTime(25.7);
+  secondHit.setTime(25.2);
+  firstHit.setPos(10.0, 10.0, 10.0);
+  secondHit.setPos(-10.0, -10.0, -10.0);
+
+  JPetEvent event;
+  event.addHit(firstHit);
+  event.addHit(secondHit);
+
+  JPetEvent event1;
+  event1.addHit(firstHit);
+
+  JPetStatistics stats;
+  EventCategorizerEngine engine;
+  engine.addPairPredicate(JPetEventType::kScattered,
+    EventCategorizerEngine::makeScatterPredicate(stats, false, 2000.0)
+  );
+  BOOST_REQUIRE(hasType(engine.categorize(event), JPetEventType::kScattered));
+  BOOST_REQUIRE(!hasType(engine.categorize(event1), JPetEventType::kScattered));
+
+  EventCategorizerEngine strictEngine;
+  strictEngine.addPairPredicate(JPetEventType::kScattered,
+    EventCategorizerEngine::makeScatterPredicate(stats, false, 0.000001)
+  );
+  BOOST_REQUIRE(!hasType(strictEngine.categorize(event), JPetEventType::kScattered));
+}
+
+BOOST_AUTO_TEST_CASE(stopOnMatchTest) {
+  JPetHit hit;
+  JPetEvent event;
+  event.addHit(hit);
+  event.addHit(hit);
+  event.addHit(hit);
+  event.addHit(hit);
+
+  int nStopping = 0;
+  int nExhaustive = 0;
+  EventCategorizerEngine engine;
+  engine.addPairPredicate(JPetEventType::k2Gamma,
+    [&nStopping](const HitFeatures&, const HitFeatures&) { nStopping++; return true; }
+  );
+  engine.addPairPredicate(JPetEventType::kScattered,
+    [&nExhaustive](const HitFeatures&, const HitFeatures&) { nExhaustive++; return true; }, false
+  );
+  auto types = engine.categorize(event);
+  BOOST_REQUIRE_EQUAL(types.size(), 2u);
+  BOOST_REQUIRE_EQUAL(nStopping, 1);
+  BOOST_REQUIRE_EQUAL(nExhaustive, 6);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
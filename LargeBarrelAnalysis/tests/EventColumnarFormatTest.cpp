@@ -0,0 +1,92 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file EventColumnarFormatTest.cpp
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE EventColumnarFormatTests
+#include "../EventColumnarFormat.h"
+#include <boost/test/unit_test.hpp>
+#include <cstdio>
+
+const double kEpsilon = 0.0001;
+
+HitFeatures getHitFeatures(double x, double y, double z, double time, double theta, double tot)
+{
+  HitFeatures hit;
+  hit.pos.SetXYZ(x, y, z);
+  hit.time = time;
+  hit.theta = theta;
+  hit.tot = tot;
+  return hit;
+}
+
+BOOST_AUTO_TEST_SUITE(EventColumnarFormatSuite)
+
+BOOST_AUTO_TEST_CASE(notExistingFileTest) {
+  EventColumnarReader reader("notExistingColumnarFile.root");
+  BOOST_REQUIRE(!reader.isOpen());
+  BOOST_REQUIRE_EQUAL(reader.getNumberOfEvents(), 0);
+  ColumnarEvent event;
+  BOOST_REQUIRE(!reader.readEvent(0, event));
+}
+
+BOOST_AUTO_TEST_CASE(writeAndReadTest) {
+  const std::string fileName = "EventColumnarFormatTest.root";
+  // empty event after the bigger one checks, that hits of the reused event are cleared
+  std::vector<std::vector<HitFeatures>> events = {
+    {getHitFeatures(1.5, -2.5, 10.25, 1500.5, 30.0, 12000.0)},
+    {
+      getHitFeatures(-45.0, 12.5, -3.75, 2000.0, 90.0, 25000.0),
+      getHitFeatures(40.25, -10.0, 3.5, 2350.25, 270.0, 18500.0),
+      getHitFeatures(0.5, 57.5, 0.0, 4100.0, 180.0, 9000.0)
+    },
+    {}
+  };
+  std::vector<unsigned int> types = {4, 6, 0};
+
+  {
+    EventColumnarWriter writer(fileName);
+    BOOST_REQUIRE(writer.isOpen());
+    for (size_t i = 0; i < events.size(); i++) {
+      writer.write(types[i], events[i]);
+    }
+    writer.close();
+    BOOST_REQUIRE(!writer.isOpen());
+  }
+
+  EventColumnarReader reader(fileName);
+  BOOST_REQUIRE(reader.isOpen());
+  BOOST_REQUIRE_EQUAL(reader.getNumberOfEvents(), 3);
+
+  ColumnarEvent event;
+  for (size_t i = 0; i < events.size(); i++) {
+    BOOST_REQUIRE(reader.readEvent(i, event));
+    BOOST_REQUIRE_EQUAL(event.type, types[i]);
+    BOOST_REQUIRE_EQUAL(event.hits.size(), events[i].size());
+    for (size_t j = 0; j < events[i].size(); j++) {
+      const auto& expected = events[i][j];
+      const auto& hit = event.hits[j];
+      BOOST_REQUIRE_CLOSE(hit.pos.X(), expected.pos.X(), kEpsilon);
+      BOOST_REQUIRE_CLOSE(hit.pos.Y(), expected.pos.Y(), kEpsilon);
+      BOOST_REQUIRE_CLOSE(hit.pos.Z(), expected.pos.Z(), kEpsilon);
+      BOOST_REQUIRE_CLOSE(hit.time, expected.time, kEpsilon);
+      BOOST_REQUIRE_CLOSE(hit.theta, expected.theta, kEpsilon);
+      BOOST_REQUIRE_CLOSE(hit.tot, expected.tot, kEpsilon);
+    }
+  }
+  BOOST_REQUIRE(!reader.readEvent(3, event));
+  std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
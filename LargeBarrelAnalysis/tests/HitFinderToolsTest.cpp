@@ -22,9 +22,11 @@
 #include <JPetRawSignal/JPetRawSignal.h>
 #include <JPetSigCh/JPetSigCh.h>
 #include <JPetLoggerInclude.h>
+#include <TBufferFile.h>
 
 #include "../ToTEnergyConverter.h"
 #include "../HitFinderTools.h"
+#include "../SlimSignalTools.h"
 
 #include <boost/test/unit_test.hpp>
 
@@ -637,4 +639,93 @@ BOOST_AUTO_TEST_CASE(checkForPromptTest_checkTOTCalc) {
                       kEpsilon);
 }
 
+BOOST_AUTO_TEST_CASE(createSlimHit_test)
+{
+  JPetBarrelSlot slot(2, true, "barel1", 30.0, 23);
+  JPetPM pmA(11, "first"), pmB(22, "second");
+  pmA.setSide(JPetPM::SideA);
+  pmB.setSide(JPetPM::SideB);
+
+  JPetTOMBChannel channel(66);
+  JPetSigCh sigChA1L(JPetSigCh::Leading, 10.0), sigChA1T(JPetSigCh::Trailing, 22.0);
+  JPetSigCh sigChA2L(JPetSigCh::Leading, 11.0), sigChA2T(JPetSigCh::Trailing, 18.0);
+  JPetSigCh sigChB1L(JPetSigCh::Leading, 12.0), sigChB1T(JPetSigCh::Trailing, 30.0);
+  for (auto sigCh : {&sigChA1L, &sigChA1T, &sigChB1L, &sigChB1T}) {
+    sigCh->setThresholdNumber(1);
+    sigCh->setThreshold(80);
+    sigCh->setTOMBChannel(channel);
+  }
+  for (auto sigCh : {&sigChA2L, &sigChA2T}) {
+    sigCh->setThresholdNumber(2);
+    sigCh->setThreshold(160);
+    sigCh->setTOMBChannel(channel);
+  }
+
+  JPetRawSignal rawA, rawB;
+  rawA.addPoint(sigChA1L);
+  rawA.addPoint(sigChA1T);
+  rawA.addPoint(sigChA2L);
+  rawA.addPoint(sigChA2T);
+  rawB.addPoint(sigChB1L);
+  rawB.addPoint(sigChB1T);
+  rawA.setPM(pmA);
+  rawB.setPM(pmB);
+
+  JPetRecoSignal recoA, recoB;
+  recoA.setRawSignal(rawA);
+  recoB.setRawSignal(rawB);
+
+  JPetPhysSignal physSigA, physSigB;
+  physSigA.setTime(10.0);
+  physSigB.setTime(12.0);
+  physSigA.setPM(pmA);
+  physSigB.setPM(pmB);
+  physSigA.setBarrelSlot(slot);
+  physSigB.setBarrelSlot(slot);
+  physSigA.setRecoFlag(JPetBaseSignal::Good);
+  physSigB.setRecoFlag(JPetBaseSignal::Corrupted);
+  physSigA.setRecoSignal(recoA);
+  physSigB.setRecoSignal(recoB);
+
+  JPetHit hit;
+  hit.setSignals(physSigA, physSigB);
+  hit.setTime(11.0);
+  hit.setPos(1.0, 2.0, 3.0);
+  hit.setBarrelSlot(slot);
+
+  auto slimHit = HitFinderTools::createSlimHit(hit);
+  BOOST_REQUIRE_CLOSE(slimHit.getTime(), 11.0, kEpsilon);
+  BOOST_REQUIRE_CLOSE(slimHit.getPosZ(), 3.0, kEpsilon);
+  BOOST_REQUIRE_EQUAL(slimHit.getBarrelSlot().getID(), 2);
+  BOOST_REQUIRE_CLOSE(slimHit.getSignalA().getTime(), 10.0, kEpsilon);
+  BOOST_REQUIRE_CLOSE(slimHit.getSignalB().getTime(), 12.0, kEpsilon);
+  BOOST_REQUIRE_EQUAL(slimHit.getSignalA().getPM().getID(), 11);
+  BOOST_REQUIRE_EQUAL(slimHit.getSignalB().getRecoFlag(), JPetBaseSignal::Corrupted);
+  BOOST_REQUIRE(
+    slimHit.getSignalA().getRecoSignal().getRawSignal().getPoints(JPetSigCh::Leading, JPetRawSignal::ByThrNum).empty()
+  );
+  BOOST_REQUIRE(
+    slimHit.getSignalB().getRecoSignal().getRawSignal().getPoints(JPetSigCh::Trailing, JPetRawSignal::ByThrNum).empty()
+  );
+  BOOST_REQUIRE(SlimSignalTools::isSlimHit(slimHit));
+  BOOST_REQUIRE(!SlimSignalTools::isSlimHit(hit));
+
+  auto totsA = SlimSignalTools::getTOTsVsThresholdValue(slimHit.getSignalA());
+  BOOST_REQUIRE_EQUAL(totsA.size(), 2u);
+  BOOST_REQUIRE_CLOSE(totsA[80], 12.0, kEpsilon);
+  BOOST_REQUIRE_CLOSE(totsA[160], 7.0, kEpsilon);
+  for (auto type : {"standard", "rectangular", "trapeze"}) {
+    auto totType = HitFinderTools::getTOTCalculationType(type);
+    BOOST_REQUIRE_CLOSE(
+      HitFinderTools::calculateTOT(slimHit, totType), HitFinderTools::calculateTOT(hit, totType), kEpsilon
+    );
+  }
+
+  TBufferFile fullBuffer(TBuffer::kWrite);
+  fullBuffer.WriteObject(&hit);
+  TBufferFile slimBuffer(TBuffer::kWrite);
+  slimBuffer.WriteObject(&slimHit);
+  BOOST_REQUIRE_LT(slimBuffer.Length(), fullBuffer.Length());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,132 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file SlimSignalToolsTest.cpp
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE SlimSignalToolsTest
+
+#include <JPetRecoSignal/JPetRecoSignal.h>
+#include <JPetRawSignal/JPetRawSignal.h>
+#include <JPetSigCh/JPetSigCh.h>
+
+#include "../SlimSignalTools.h"
+
+#include <boost/test/unit_test.hpp>
+
+const double kEpsilon = 0.01;
+
+JPetSigCh createSigCh(JPetSigCh::EdgeType edge, double time, int thresholdNumber, float threshold)
+{
+  JPetSigCh sigCh(edge, time);
+  sigCh.setThresholdNumber(thresholdNumber);
+  sigCh.setThreshold(threshold);
+  return sigCh;
+}
+
+JPetPhysSignal createPhysSignal(const JPetRecoSignal& recoSignal, double time)
+{
+  JPetPhysSignal physSignal;
+  physSignal.setTime(time);
+  physSignal.setRecoSignal(recoSignal);
+  return physSignal;
+}
+
+BOOST_AUTO_TEST_SUITE(SlimSignalToolsTestSuite)
+
+BOOST_AUTO_TEST_CASE(createSlimSignal_test)
+{
+  JPetRawSignal rawSignal;
+  rawSignal.addPoint(createSigCh(JPetSigCh::Leading, 1000.0, 1, 80.0));
+  rawSignal.addPoint(createSigCh(JPetSigCh::Trailing, 4000.0, 1, 80.0));
+  rawSignal.addPoint(createSigCh(JPetSigCh::Leading, 1500.0, 2, 160.0));
+  rawSignal.addPoint(createSigCh(JPetSigCh::Trailing, 3000.0, 2, 160.0));
+  rawSignal.addPoint(createSigCh(JPetSigCh::Leading, 1800.0, 3, 240.0));
+  JPetRecoSignal recoSignal;
+  recoSignal.setRawSignal(rawSignal);
+  auto signal = createPhysSignal(recoSignal, 1000.0);
+
+  auto slimSignal = SlimSignalTools::createSlimSignal(signal);
+  BOOST_REQUIRE(SlimSignalTools::isSlimSignal(slimSignal));
+  BOOST_REQUIRE(!SlimSignalTools::isSlimSignal(signal));
+  BOOST_REQUIRE(slimSignal.getRecoSignal().getRawSignal().getPoints(JPetSigCh::Leading, JPetRawSignal::ByThrNum).empty());
+  BOOST_REQUIRE_CLOSE(slimSignal.getTime(), 1000.0, kEpsilon);
+
+  auto crossings = SlimSignalTools::getThresholdCrossings(slimSignal);
+  BOOST_REQUIRE_EQUAL(crossings.size(), 5u);
+  BOOST_REQUIRE_EQUAL(crossings[2].edge, JPetSigCh::Leading);
+  BOOST_REQUIRE_CLOSE(crossings[2].threshold, 240.0, kEpsilon);
+  BOOST_REQUIRE_CLOSE(crossings[2].time, 1800.0, kEpsilon);
+  BOOST_REQUIRE_EQUAL(crossings[4].edge, JPetSigCh::Trailing);
+  BOOST_REQUIRE_CLOSE(crossings[4].time, 3000.0, kEpsilon);
+
+  auto tots = SlimSignalTools::getTOTsVsThresholdValue(slimSignal);
+  auto fullTots = SlimSignalTools::getTOTsVsThresholdValue(signal);
+  BOOST_REQUIRE_EQUAL(tots.size(), 2u);
+  BOOST_REQUIRE_EQUAL(fullTots.size(), 2u);
+  BOOST_REQUIRE_CLOSE(tots[80], 3000.0, kEpsilon);
+  BOOST_REQUIRE_CLOSE(tots[160], 1500.0, kEpsilon);
+  BOOST_REQUIRE_CLOSE(tots[80], fullTots[80], kEpsilon);
+}
+
+BOOST_AUTO_TEST_CASE(nonPositiveThresholds_test)
+{
+  JPetRawSignal rawSignal;
+  rawSignal.addPoint(createSigCh(JPetSigCh::Leading, 10.0, 1, 0.0));
+  rawSignal.addPoint(createSigCh(JPetSigCh::Trailing, 25.0, 1, 0.0));
+  rawSignal.addPoint(createSigCh(JPetSigCh::Leading, 12.0, 2, -50.0));
+  rawSignal.addPoint(createSigCh(JPetSigCh::Trailing, 20.0, 2, -50.0));
+  JPetRecoSignal recoSignal;
+  recoSignal.setRawSignal(rawSignal);
+  auto slimSignal = SlimSignalTools::createSlimSignal(createPhysSignal(recoSignal, 10.0));
+
+  auto tots = SlimSignalTools::getTOTsVsThresholdValue(slimSignal);
+  BOOST_REQUIRE_EQUAL(tots.size(), 2u);
+  BOOST_REQUIRE_CLOSE(tots[0], 15.0, kEpsilon);
+  BOOST_REQUIRE_CLOSE(tots[-50], 8.0, kEpsilon);
+}
+
+BOOST_AUTO_TEST_CASE(sampledShapeIsNotSlim_test)
+{
+  JPetRawSignal rawSignal;
+  rawSignal.addPoint(createSigCh(JPetSigCh::Leading, 10.0, 1, 80.0));
+  rawSignal.addPoint(createSigCh(JPetSigCh::Trailing, 30.0, 1, 80.0));
+  JPetRecoSignal recoSignal;
+  recoSignal.setRawSignal(rawSignal);
+  recoSignal.setShapePoint(10.0, 100.0);
+  recoSignal.setShapePoint(20.0, -300.0);
+  recoSignal.setShapePoint(30.0, 100.0);
+  auto signal = createPhysSignal(recoSignal, 10.0);
+
+  BOOST_REQUIRE(!SlimSignalTools::isSlimSignal(signal));
+  auto crossings = SlimSignalTools::getThresholdCrossings(signal);
+  BOOST_REQUIRE_EQUAL(crossings.size(), 2u);
+  BOOST_REQUIRE_EQUAL(crossings[1].edge, JPetSigCh::Trailing);
+  BOOST_REQUIRE_CLOSE(crossings[1].time, 30.0, kEpsilon);
+  auto tots = SlimSignalTools::getTOTsVsThresholdValue(signal);
+  BOOST_REQUIRE_EQUAL(tots.size(), 1u);
+  BOOST_REQUIRE_CLOSE(tots[80], 20.0, kEpsilon);
+}
+
+BOOST_AUTO_TEST_CASE(isSlimHit_test)
+{
+  JPetPhysSignal signal;
+  JPetHit hit;
+  hit.setSignalB(signal);
+  BOOST_REQUIRE(!SlimSignalTools::isSlimHit(hit));
+  hit.setSignalB(SlimSignalTools::createSlimSignal(signal));
+  BOOST_REQUIRE(SlimSignalTools::isSlimHit(hit));
+  BOOST_REQUIRE(SlimSignalTools::getThresholdCrossings(hit.getSignalB()).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,94 @@
+/**
+ *  @copyright Copyright 2020 The J-PET Framework Authors. All rights reserved.
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may find a copy of the License in the LICENCE file.
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file TimeWindowArenaTest.cpp
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE TimeWindowArenaTest
+#include "../TimeWindowArena.h"
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+
+BOOST_AUTO_TEST_SUITE(TimeWindowArenaSuite)
+
+BOOST_AUTO_TEST_CASE(allocateTest)
+{
+  TimeWindowArena arena(128);
+  BOOST_REQUIRE_EQUAL(arena.getCapacity(), 0u);
+  auto first = arena.allocate(3, 1);
+  auto second = arena.allocate(8, 8);
+  BOOST_REQUIRE(first != second);
+  BOOST_REQUIRE_EQUAL(reinterpret_cast<std::uintptr_t>(second) % 8, 0u);
+  BOOST_REQUIRE_EQUAL(arena.getUsedBytes(), 11u);
+  BOOST_REQUIRE_EQUAL(arena.getCapacity(), 128u);
+  // Allocation larger than block size gets its own block
+  arena.allocate(1000, 8);
+  BOOST_REQUIRE(arena.getCapacity() >= 1128u);
+}
+
+BOOST_AUTO_TEST_CASE(resetTest)
+{
+  TimeWindowArena arena(128);
+  auto first = arena.allocate(100, 8);
+  arena.allocate(100, 8);
+  auto capacity = arena.getCapacity();
+  arena.reset();
+  BOOST_REQUIRE_EQUAL(arena.getUsedBytes(), 0u);
+  BOOST_REQUIRE_EQUAL(arena.getCapacity(), capacity);
+  // After reset blocks are merged, so both allocations fit without growing
+  arena.allocate(100, 8);
+  arena.allocate(100, 8);
+  BOOST_REQUIRE_EQUAL(arena.getCapacity(), capacity);
+
+  TimeWindowArena singleBlockArena(128);
+  first = singleBlockArena.allocate(100, 8);
+  singleBlockArena.reset();
+  BOOST_REQUIRE_EQUAL(singleBlockArena.allocate(100, 8), first);
+}
+
+BOOST_AUTO_TEST_CASE(scopeTest)
+{
+  TimeWindowArena arena;
+  {
+    TimeWindowArena::Scope scope(arena);
+    arena.allocate(64, 8);
+    BOOST_REQUIRE_EQUAL(arena.getUsedBytes(), 64u);
+  }
+  BOOST_REQUIRE_EQUAL(arena.getUsedBytes(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(containersTest)
+{
+  TimeWindowArena arena;
+  ArenaMap<int, ArenaVector<double>> map{ArenaAllocator<int>(&arena)};
+  for (int i = 0; i < 10; i++) {
+    auto search = map.find(i % 3);
+    if (search == map.end()) {
+      search = map.emplace(i % 3, ArenaVector<double>(ArenaAllocator<double>(&arena))).first;
+    }
+    search->second.push_back(i);
+  }
+  BOOST_REQUIRE_EQUAL(map.size(), 3u);
+  BOOST_REQUIRE_EQUAL(map.at(0).size(), 4u);
+  BOOST_REQUIRE_EQUAL(map.at(2).back(), 8.0);
+  BOOST_REQUIRE(map.at(1).get_allocator().getArena() == &arena);
+  BOOST_REQUIRE(arena.getUsedBytes() > 0u);
+
+  // Without arena global allocator is used
+  ArenaVector<int> vector;
+  vector.push_back(1);
+  BOOST_REQUIRE(vector.get_allocator().getArena() == nullptr);
+  BOOST_REQUIRE_EQUAL(vector.at(0), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
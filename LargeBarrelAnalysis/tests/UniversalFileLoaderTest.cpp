@@ -3,6 +3,7 @@
 
 #include "../UniversalFileLoader.h"
 #include <boost/test/unit_test.hpp>
+#include <fstream>
 
 struct myFixtures {
   std::vector<ConfRecord> fCorrectRecords = {
@@ -285,4 +286,58 @@ BOOST_FIXTURE_TEST_CASE(generateConfigurationParameters, myFixtures) {
   BOOST_REQUIRE_CLOSE(configuration.at(73).at(0), -3, epsilon);
 }
 
+BOOST_AUTO_TEST_CASE(convertToBinaryConfFile) {
+  BOOST_REQUIRE(!UniversalFileLoader::isBinaryConfFile("../dummyCalibration.txt"));
+  BOOST_REQUIRE(UniversalFileLoader::convertToBinaryConfFile(
+      "../dummyCalibration.txt", "dummyCalibration.bin"));
+  BOOST_REQUIRE(UniversalFileLoader::isBinaryConfFile("dummyCalibration.bin"));
+  BOOST_REQUIRE(!UniversalFileLoader::convertToBinaryConfFile(
+      "blabalbaahl.txt", "blabalbaahl.bin"));
+
+  auto records = UniversalFileLoader::readConfigurationParametersFromFile(
+      "../dummyCalibration.txt");
+  auto view = UniversalFileLoader::mapBinaryConfFile("dummyCalibration.bin");
+  BOOST_REQUIRE(view.isValid());
+  BOOST_REQUIRE_EQUAL(view.getNumberOfParameters(), 8u);
+  for (const auto& record : records) {
+    auto parameters = view.getParameters(
+        record.layer, record.slot, record.side, record.thresholdNumber);
+    BOOST_REQUIRE(parameters);
+    for (unsigned int i = 0; i < view.getNumberOfParameters(); i++) {
+      BOOST_REQUIRE_EQUAL(parameters[i], record.parameters[i]);
+    }
+  }
+  BOOST_REQUIRE(!view.getParameters(4, 1, JPetPM::SideA, 1));
+  BOOST_REQUIRE(!view.getParameters(1, 1, JPetPM::SideA, 5));
+}
+
+BOOST_AUTO_TEST_CASE(mapBinaryConfFile_wrong_file) {
+  BOOST_REQUIRE(!UniversalFileLoader::mapBinaryConfFile("blabalbaahl.bin").isValid());
+  BOOST_REQUIRE(!UniversalFileLoader::mapBinaryConfFile("../dummyCalibration.txt").isValid());
+}
+
+BOOST_FIXTURE_TEST_CASE(generateConfigurationParameters_binary, myFixtures) {
+  std::ofstream textFile("binaryConfTest.txt");
+  textFile << "# layer slot side thr parameters\n";
+  for (const auto& record : fCorrectRecords) {
+    textFile << record.layer << " " << record.slot << " "
+             << (record.side == JPetPM::SideA ? "A" : "B") << " " << record.thresholdNumber;
+    for (auto parameter : record.parameters) {
+      textFile << " " << parameter;
+    }
+    textFile << "\n";
+  }
+  textFile.close();
+  BOOST_REQUIRE(UniversalFileLoader::convertToBinaryConfFile(
+      "binaryConfTest.txt", "binaryConfTest.bin"));
+
+  auto fromText = UniversalFileLoader::loadConfigurationParameters(
+      "binaryConfTest.txt", fCorrectTombMap);
+  auto fromBinary = UniversalFileLoader::loadConfigurationParameters(
+      "binaryConfTest.bin", fCorrectTombMap);
+  BOOST_REQUIRE_EQUAL(fromBinary.size(), 3u);
+  BOOST_REQUIRE(fromText == fromBinary);
+  BOOST_REQUIRE_EQUAL(UniversalFileLoader::getConfigurationParameter(fromBinary, 13), 5.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -83,6 +83,18 @@ bool EventCategorizerPhysics::init()
     WARNING("No TOT calculation option given by the user. Using standard sum.");
   }
 
+  fTOTType = HitFinderTools::getTOTCalculationType(fTOTCalculationType);
+  fCategorizerEngine = EventCategorizerEngine(fTOTType);
+  fCategorizerEngine.addPairPredicate(JPetEventType::k2Gamma,
+    EventCategorizerEngine::make2GammaPredicate(
+      getStatistics(), fSaveControlHistos, fBackToBackAngleWindow, fMaxTimeDiff
+    )
+  );
+  fCategorizerEngine.addTriplePredicate(JPetEventType::k3Gamma,
+    EventCategorizerEngine::make3GammaPredicate(getStatistics(), fSaveControlHistos),
+    !fSaveControlHistos
+  );
+
   if(fSaveControlHistos) initialiseHistograms();
   return true;
 }
@@ -94,8 +106,7 @@ bool EventCategorizerPhysics::exec()
     uint n = timeWindow->getNumberOfEvents();
     for (uint i = 0; i < n; ++i) {
       const auto& event = dynamic_cast<const JPetEvent&>(timeWindow->operator[](i));
-      vector<JPetHit> hits = event.getHits();
-      JPetEvent physicEvent = physicsAnalysis(hits);
+      JPetEvent physicEvent = physicsAnalysis(event.getHits());
       if (physicEvent.getHits().size()) { events.push_back(physicEvent); }
     }
   } else {
@@ -119,63 +130,44 @@ void EventCategorizerPhysics::saveEvents(const vector<JPetEvent>& events)
   }
 }
 
-JPetEvent EventCategorizerPhysics::physicsAnalysis(vector<JPetHit> hits)
+JPetEvent EventCategorizerPhysics::physicsAnalysis(const vector<JPetHit>& hits)
 {
   JPetEvent physicEvent;
-  JPetEvent annihilationHits;
-  JPetEvent deexcitationHits;
+  fAnnihilationHits.clear();
+  fDeexcitationHits.clear();
 
   for (unsigned i = 0; i < hits.size(); i++) {
     if (fabs(hits[i].getPosZ()) < fMaxZPos) {
-      double TOTofHit = HitFinderTools::calculateTOT(hits[i], HitFinderTools::getTOTCalculationType(fTOTCalculationType));
+      HitFeatures hitFeatures = EventCategorizerEngine::computeFeatures(hits[i], fTOTType);
+      double TOTofHit = hitFeatures.tot;
       if (fSaveControlHistos) {
         getStatistics().getHisto1D("AllHitTOT")->Fill(TOTofHit / 1000.);
       }
       if (TOTofHit >= fMinAnnihilationTOT && TOTofHit <= fMaxAnnihilationTOT) {
         physicEvent.addHit(hits[i]);
-        annihilationHits.addHit(hits[i]);
+        fAnnihilationHits.push_back(hitFeatures);
       }
       if (TOTofHit >= fMinDeexcitationTOT && TOTofHit <= fMaxDeexcitationTOT) {
         physicEvent.addHit(hits[i]);
-        deexcitationHits.addHit(hits[i]);
+        fDeexcitationHits.push_back(hitFeatures);
       }
     }
   }
   if (fSaveControlHistos) {
-    getStatistics().getHisto1D("AnnihHitsNumber")->Fill(annihilationHits.getHits().size());
-    getStatistics().getHisto1D("DeexHitsNumber")->Fill(deexcitationHits.getHits().size());
+    getStatistics().getHisto1D("AnnihHitsNumber")->Fill(fAnnihilationHits.size());
+    getStatistics().getHisto1D("DeexHitsNumber")->Fill(fDeexcitationHits.size());
   }
-  if (deexcitationHits.getHits().size() > 0) {
-    if (physicEvent.isOnlyTypeOf(JPetEventType::kUnknown)){
-      physicEvent.setEventType(JPetEventType::kPrompt);
-    } else {
-      physicEvent.addEventType(JPetEventType::kPrompt);
-    }
-    if (annihilationHits.getHits().size() > 0) {
+  if (fDeexcitationHits.size() > 0) {
+    EventCategorizerEngine::addEventTypes(physicEvent, {JPetEventType::kPrompt});
+    if (fAnnihilationHits.size() > 0) {
       getStatistics().getHisto1D("DeexAnnihTimeDiff")->Fill(
-        annihilationHits.getHits().at(0).getTime() - deexcitationHits.getHits().at(0).getTime()
+        fAnnihilationHits.at(0).time - fDeexcitationHits.at(0).time
       );
     }
   }
-  if (EventCategorizerTools::checkFor2Gamma(
-    annihilationHits, getStatistics(), fSaveControlHistos,
-    fBackToBackAngleWindow, fMaxTimeDiff)
-  ) {
-    if (physicEvent.isOnlyTypeOf(JPetEventType::kUnknown)) {
-      physicEvent.setEventType(JPetEventType::k2Gamma);
-    } else {
-      physicEvent.addEventType(JPetEventType::k2Gamma);
-    }
-  }
-  if (EventCategorizerTools::checkFor3Gamma(
-    annihilationHits, getStatistics(), fSaveControlHistos)
-  ) {
-    if (physicEvent.isOnlyTypeOf(JPetEventType::kUnknown)){
-      physicEvent.setEventType(JPetEventType::k3Gamma);
-    } else {
-      physicEvent.addEventType(JPetEventType::k3Gamma);
-    }
-  }
+  EventCategorizerEngine::addEventTypes(
+    physicEvent, fCategorizerEngine.categorize(fAnnihilationHits)
+  );
   return physicEvent;
 }
 
@@ -16,6 +16,8 @@
 #ifndef EVENTCATEGORIZERPHYSICS_H
 #define EVENTCATEGORIZERPHYSICS_H
 
+#include "../LargeBarrelAnalysis/EventCategorizerEngine.h"
+#include "../LargeBarrelAnalysis/HitFinderTools.h"
 #include <JPetStatistics/JPetStatistics.h>
 #include <JPetUserTask/JPetUserTask.h>
 #include <JPetEventType/JPetEventType.h>
@@ -37,7 +39,7 @@ public:
 	virtual bool init() override;
 	virtual bool exec() override;
 	virtual bool terminate() override;
-	JPetEvent physicsAnalysis(std::vector<JPetHit> hits);
+	JPetEvent physicsAnalysis(const std::vector<JPetHit>& hits);
 
 protected:
 	const std::string kMaxDistOfDecayPlaneFromCenterParamKey = "EventCategorizer_MaxDistOfDecayPlaneFromCenter_float";
@@ -61,6 +63,10 @@ protected:
 	double fMaxZPos = 23.;
 	bool fSaveControlHistos = true;
     std::string fTOTCalculationType = "";
+	HitFinderTools::TOTCalculationType fTOTType = HitFinderTools::kSimplified;
+	EventCategorizerEngine fCategorizerEngine;
+	std::vector<HitFeatures> fAnnihilationHits;
+	std::vector<HitFeatures> fDeexcitationHits;
 	void saveEvents(const std::vector<JPetEvent>& event);
     void initialiseHistograms();
 };
@@ -20,6 +20,7 @@
 #include <sstream>
 #include <cctype>
 #include "TimeCalibration.h"
+#include "../LargeBarrelAnalysis/SlimSignalTools.h"
 #include "TF1.h"
 #include "TString.h"
 #include <TDirectory.h>
@@ -138,6 +139,10 @@ bool TimeCalibration::exec()
     //
     for (uint i = 0; i < n; ++i) {
       const JPetHit& hit = dynamic_cast<const JPetHit&>(timeWindow->operator[](i));
+      if (SlimSignalTools::isSlimHit(hit)) {
+        ERROR("Hits saved with HitFinder_SlimHits_bool option have no Signal Channels, they can not be used for calibration.");
+        return false;
+      }
       int PMid = hit.getSignalB().getRecoSignal().getRawSignal().getPM().getID();
       //
       //taking refference detector hits times (scin=193, Pmt=385)
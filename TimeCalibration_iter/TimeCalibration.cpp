@@ -14,6 +14,7 @@
  */
 
 #include "TimeCalibration.h"
+#include "../LargeBarrelAnalysis/SlimSignalTools.h"
 #include <JPetOptionsTools/JPetOptionsTools.h>
 #include <JPetCommonTools/JPetCommonTools.h>
 
@@ -186,6 +187,10 @@ bool TimeCalibration::exec()
     auto n = timeWindow->getNumberOfEvents();
     for (auto i = 0u; i < n; ++i) {
       const JPetHit& hit = dynamic_cast<const JPetHit&>(timeWindow->operator[](i));
+      if (SlimSignalTools::isSlimHit(hit)) {
+        ERROR("Hits saved with HitFinder_SlimHits_bool option have no Signal Channels, they can not be used for calibration.");
+        return false;
+      }
       int PMid = hit.getSignalB().getRecoSignal().getRawSignal().getPM().getID();
       if (PMid == kPMIdRef) {
         auto lead_times_B = hit.getSignalB().getRecoSignal().getRawSignal().getTimesVsThresholdNumber(JPetSigCh::Leading);
@@ -19,6 +19,7 @@
 #include <iostream>
 #include <JPetOptionsTools/JPetOptionsTools.h>
 #include "DeltaTFinder.h"
+#include "../LargeBarrelAnalysis/SlimSignalTools.h"
 
 
 using namespace std;
@@ -111,7 +112,12 @@ bool DeltaTFinder::exec()
   if (auto timeWindow = dynamic_cast<const JPetTimeWindow* const>(fEvent)) {
     uint nhits = timeWindow->getNumberOfEvents();
     for (uint i = 0; i < nhits; ++i) {
-      fillHistosForHit( dynamic_cast<const JPetHit&>(timeWindow->operator[](i)) );
+      const JPetHit& hit = dynamic_cast<const JPetHit&>(timeWindow->operator[](i));
+      if (SlimSignalTools::isSlimHit(hit)) {
+        ERROR("Hits saved with HitFinder_SlimHits_bool option have no Signal Channels, they can not be used for calibration.");
+        return false;
+      }
+      fillHistosForHit(hit);
     }
   } else {
     return false;